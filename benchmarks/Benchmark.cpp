@@ -0,0 +1,268 @@
+/// Benchmark.cpp
+/// Shaun Harker
+/// 2018-11-19
+/// MIT LICENSE
+
+/// Stage-level benchmarks of the DSGRN pipeline over network
+/// specification files, with results written as JSON
+
+#include "DSGRN.hpp"
+
+#include <chrono>
+#include <iomanip>
+
+#ifndef DSGRN_SOURCE_DIR
+#define DSGRN_SOURCE_DIR "."
+#endif
+
+namespace {
+
+  /// sink
+  ///   Results are folded in here so the compiler cannot drop the work
+  volatile uint64_t sink = 0;
+
+  struct Options {
+    double min_time = 0.25;
+    uint64_t samples = 32;
+    std::set<std::string> stages;
+    std::string resources = DSGRN_SOURCE_DIR "/src/DSGRN/Resources";
+    std::string output;
+    std::string label;
+    std::vector<std::string> networks;
+  };
+
+  char const* usage =
+    "Benchmark [options] [network specification files]\n"
+    "  --min-time SECONDS  time each stage for at least this long (default 0.25)\n"
+    "  --samples K         number of parameters sampled per network (default 32)\n"
+    "  --stages A,B,...    only run the listed stages (default: all)\n"
+    "  --resources PATH    DSGRN resources directory (holding logic/)\n"
+    "  --output FILE       write the JSON report to FILE (default: stdout)\n"
+    "  --label TEXT        label stored in the report, e.g. a commit hash\n"
+    "Without network files a default selection from networks/ and tests/networks/ is used.\n";
+
+  std::vector<std::string> const stage_names = {
+    "parameter", "parameterview", "labelling", "cachedlabelling", "viewlabelling", "domaingraph",
+    "strongcomponents", "morsedecomposition", "morsegraph", "wallgraph",
+    "searchgraph", "matchinggraph", "cyclematch", "compileregex", "nfaintersect", "pipeline" };
+
+  std::vector<std::string> const default_networks = {
+    "tests/networks/network2.txt",
+    "tests/networks/network3.txt",
+    "tests/networks/network8.txt",
+    "tests/networks/network9.txt",
+    "networks/2D_Example.txt",
+    "networks/3D_Cycle.txt",
+    "networks/4D_Cycle.txt",
+    "networks/5D_Cycle.txt",
+    "networks/10D_A.txt" };
+
+  // Regular expressions over Morse graph labels, as used by queries
+  std::vector<std::string> const regexes = {
+    "(Q|q|B|p|P|O)*P(Q|q|B|p|P|O)*",
+    "(q|Q)*B+(p|P)*",
+    "Q*q*B*p*P*",
+    "(Q|P)(q|B|p)*(Q|P)",
+    "((Q|q)(B|p)*(P|O))+" };
+
+  /// measure
+  ///   Call "op" on inputs 0, 1, ..., K-1 in rounds until "min_time"
+  ///   seconds have passed, and return one JSON record
+  json
+  measure ( std::string const& stage, uint64_t K, double min_time,
+            std::function<uint64_t(uint64_t)> const& op ) {
+    typedef std::chrono::steady_clock clock;
+    uint64_t operations = 0;
+    double seconds = 0.0;
+    clock::time_point start = clock::now ();
+    do {
+      uint64_t fold = 0;
+      for ( uint64_t i = 0; i < K; ++ i ) fold += op ( i );
+      sink = sink + fold;
+      operations += K;
+      seconds = std::chrono::duration<double> ( clock::now () - start ) . count ();
+    } while ( seconds < min_time );
+    json record;
+    record["stage"] = stage;
+    record["operations"] = operations;
+    record["seconds"] = seconds;
+    record["ns_per_op"] = 1e9 * seconds / operations;
+    record["ops_per_second"] = operations / seconds;
+    return record;
+  }
+
+  /// benchmark
+  ///   Run the selected stages on one network
+  json
+  benchmark ( std::string const& filename, Options const& options ) {
+    auto selected = [&] ( std::string const& stage ) {
+      return options . stages . empty () || options . stages . count ( stage );
+    };
+    Network network ( filename );
+    ParameterGraph pg ( network );
+    uint64_t D = network . size ();
+    uint64_t N = pg . size ();
+    uint64_t K = std::max<uint64_t> ( 1, std::min ( options . samples, N ) );
+    // Spread the sampled parameter indices over the whole graph
+    std::vector<uint64_t> indices ( K );
+    for ( uint64_t i = 0; i < K; ++ i ) indices[i] = (uint64_t) ( ( (double) i + 0.5 ) * N / K );
+    // Inputs of the stages, computed outside the timed regions
+    std::vector<Parameter> parameters;
+    std::vector<DomainGraph> domaingraphs;
+    std::vector<MorseDecomposition> morsedecompositions;
+    std::vector<SearchGraph> searchgraphs;
+    std::vector<MatchingGraph> matchinggraphs;
+    for ( uint64_t i = 0; i < K; ++ i ) {
+      parameters . push_back ( pg . parameter ( indices[i] ) );
+      domaingraphs . push_back ( DomainGraph ( parameters . back () ) );
+      morsedecompositions . push_back ( MorseDecomposition ( domaingraphs . back () . digraph () ) );
+    }
+    // Pattern: every variable has a maximum followed by a minimum
+    bool patterns = D <= 32;
+    PatternGraph patterngraph;
+    if ( patterns ) {
+      Digraph digraph;
+      digraph . resize ( 2 * D );
+      std::vector<uint64_t> events ( 2 * D );
+      for ( uint64_t d = 0; d < D; ++ d ) {
+        digraph . add_edge ( d, D + d );
+        events[d] = events[D + d] = d;
+      }
+      Poset poset ( digraph );
+      patterngraph . assign ( Pattern ( poset, events, ( 1LL << D ) - 1, D ) );
+      for ( uint64_t i = 0; i < K; ++ i ) {
+        searchgraphs . push_back ( SearchGraph ( domaingraphs[i] ) );
+        matchinggraphs . push_back ( MatchingGraph ( searchgraphs . back (), patterngraph ) );
+      }
+    }
+    // NFAs of a single gene query on the first node
+    std::vector<NFA> queries;
+    NFA regex_nfa = CompileRegexToNFA ( regexes[0] );
+    if ( selected ( "nfaintersect" ) ) {
+      ComputeSingleGeneQuery query ( network, network . name ( 0 ),
+        [] ( uint64_t pi ) { return "QqBpPO" [ pi % 6 ]; } );
+      uint64_t R = query . number_of_reduced_parameters ();
+      for ( uint64_t i = 0; i < std::min ( K, R ); ++ i ) {
+        queries . push_back ( query ( (uint64_t) ( ( (double) i + 0.5 ) * R / std::min ( K, R ) ) ) );
+      }
+    }
+
+    json results = json::array ();
+    auto run = [&] ( std::string const& stage, uint64_t count, std::function<uint64_t(uint64_t)> const& op ) {
+      if ( not selected ( stage ) || count == 0 ) return;
+      std::cerr << "  " << std::setw(20) << std::left << stage << std::flush;
+      json record = measure ( stage, count, options . min_time, op );
+      std::cerr << record["ns_per_op"] . get<double> () << " ns/op\n";
+      results . push_back ( record );
+    };
+    run ( "parameter", K, [&] ( uint64_t i ) {
+      return pg . parameter ( indices[i] ) . order () . size (); } );
+    run ( "parameterview", K, [&] ( uint64_t i ) {
+      return ParameterView ( pg, indices[i] ) . index (); } );
+    run ( "labelling", K, [&] ( uint64_t i ) {
+      return parameters[i] . labelling () . size (); } );
+    run ( "cachedlabelling", K, [&] ( uint64_t i ) {
+      return parameters[i] . cached_labelling () . size (); } );
+    run ( "viewlabelling", K, [&] ( uint64_t i ) {
+      return ParameterView ( pg, indices[i] ) . labelling () . size (); } );
+    run ( "domaingraph", K, [&] ( uint64_t i ) {
+      DomainGraph dg; dg . assign ( parameters[i] ); return dg . digraph () . size (); } );
+    run ( "strongcomponents", K, [&] ( uint64_t i ) {
+      return StrongComponents ( domaingraphs[i] . digraph () ) . size (); } );
+    run ( "morsedecomposition", K, [&] ( uint64_t i ) {
+      return MorseDecomposition ( domaingraphs[i] . digraph () ) . recurrent () . size (); } );
+    run ( "morsegraph", K, [&] ( uint64_t i ) {
+      return MorseGraph ( domaingraphs[i], morsedecompositions[i] ) . poset () . size (); } );
+    run ( "wallgraph", K, [&] ( uint64_t i ) {
+      return WallGraph ( parameters[i] ) . digraph () . size (); } );
+    run ( "searchgraph", patterns ? K : 0, [&] ( uint64_t i ) {
+      return SearchGraph ( domaingraphs[i] ) . size (); } );
+    run ( "matchinggraph", patterns ? K : 0, [&] ( uint64_t i ) {
+      return MatchingGraph ( searchgraphs[i], patterngraph ) . roots () . size (); } );
+    run ( "cyclematch", patterns ? K : 0, [&] ( uint64_t i ) {
+      return CycleMatch ( matchinggraphs[i] ) . size (); } );
+    run ( "compileregex", regexes . size (), [&] ( uint64_t i ) {
+      return CompileRegexToNFA ( regexes[i] ) . num_vertices (); } );
+    run ( "nfaintersect", queries . size (), [&] ( uint64_t i ) {
+      return NFA::intersect ( queries[i], regex_nfa ) . first . num_vertices (); } );
+    // End to end: parameter index to Morse graph, in parameters per second
+    run ( "pipeline", K, [&] ( uint64_t i ) {
+      DomainGraph dg ( pg . parameter ( indices[i] ) );
+      MorseDecomposition md ( dg . digraph () );
+      return MorseGraph ( dg, md ) . poset () . size (); } );
+
+    json report;
+    report["network"] = filename;
+    report["dimension"] = D;
+    report["parameters"] = N;
+    report["samples"] = K;
+    report["results"] = results;
+    return report;
+  }
+}
+
+int main ( int argc, char * argv [] ) {
+  Options options;
+  try {
+    for ( int i = 1; i < argc; ++ i ) {
+      std::string arg = argv[i];
+      auto value = [&] () -> std::string {
+        if ( i + 1 >= argc ) throw std::invalid_argument ( "missing value for " + arg );
+        return argv [ ++ i ];
+      };
+      if ( arg == "--help" || arg == "-h" ) { std::cout << usage; return 0; }
+      else if ( arg == "--min-time" ) options . min_time = std::stod ( value () );
+      else if ( arg == "--samples" ) options . samples = std::stoull ( value () );
+      else if ( arg == "--resources" ) options . resources = value ();
+      else if ( arg == "--output" ) options . output = value ();
+      else if ( arg == "--label" ) options . label = value ();
+      else if ( arg == "--stages" ) {
+        std::stringstream ss ( value () );
+        std::string stage;
+        while ( std::getline ( ss, stage, ',' ) ) {
+          if ( std::find ( stage_names . begin (), stage_names . end (), stage ) == stage_names . end () ) {
+            throw std::invalid_argument ( "unknown stage " + stage );
+          }
+          options . stages . insert ( stage );
+        }
+      }
+      else if ( arg . size () > 1 && arg[0] == '-' ) throw std::invalid_argument ( "unknown option " + arg );
+      else options . networks . push_back ( arg );
+    }
+  } catch ( std::exception & e ) {
+    std::cerr << "Benchmark: " << e . what () << "\n" << usage;
+    return 1;
+  }
+  if ( options . networks . empty () ) {
+    for ( auto const& name : default_networks ) options . networks . push_back ( DSGRN_SOURCE_DIR "/" + name );
+  }
+  configuration () -> set_path ( options . resources );
+
+  json report;
+  report["benchmark"] = "DSGRN";
+  report["format"] = 1;
+  report["label"] = options . label;
+  report["min_time"] = options . min_time;
+  report["networks"] = json::array ();
+  int status = 0;
+  for ( auto const& filename : options . networks ) {
+    std::cerr << filename << "\n";
+    try {
+      report["networks"] . push_back ( benchmark ( filename, options ) );
+    } catch ( std::exception & e ) {
+      std::cerr << "  skipped: " << e . what () << "\n";
+      status = 1;
+    }
+  }
+  if ( options . output . empty () ) {
+    std::cout << report . dump ( 2 ) << "\n";
+  } else {
+    std::ofstream outfile ( options . output );
+    outfile << report . dump ( 2 ) << "\n";
+    if ( not outfile . good () ) {
+      std::cerr << "Benchmark: could not write " << options . output << "\n";
+      return 1;
+    }
+  }
+  return status;
+}
@@ -9,13 +9,59 @@
 #include "Tools/sqlambda.h"
 #include "DSGRN.h"
 
+#include <chrono>
+
+/// Instrumentation
+///   Cumulative time per stage and counters of a database computation,
+///   with a periodic progress line and a final JSON report
+class Instrumentation {
+public:
+  typedef std::chrono::steady_clock clock;
+  /// Stages of the main loop, in order
+  enum Stage { DECODE, LABELLING, DOMAINGRAPH, SCC, MORSEDECOMPOSITION,
+               CANONICALIZE, FIXEDPOINTS, ATTRACTORS, DEDUPE, INSERT,
+               COUNTERS, NUMBER_OF_STAGES };
+  void start ( uint64_t total, double progress_interval );
+  /// Begin timing "stage"; the previous stage (if any) ends
+  void stage ( Stage stage );
+  /// End the current stage; count a parameter and print progress if due
+  void parameter_done ( void );
+  void finish ( void );
+  json report ( void ) const;
+  uint64_t parameters = 0;
+  uint64_t morse_graphs = 0;
+  uint64_t fixed_point_signatures = 0;
+  uint64_t attractor_signatures = 0;
+  uint64_t dedupe_hits = 0;
+  uint64_t domaingraph_edges = 0;
+  uint64_t recurrent_sets = 0;
+private:
+  void progress ( void );
+  uint64_t total_ = 0;
+  double interval_ = 0;
+  double seconds_ [ NUMBER_OF_STAGES ] = { };
+  int current_ = NUMBER_OF_STAGES;
+  clock::time_point begin_;
+  clock::time_point mark_;
+  clock::time_point last_progress_;
+  double elapsed_ = 0;
+};
+
 class Signatures {
 public:
   int command_line ( int argc, char * argv [] );
   void initialize ( void );
   void mainloop ( void );
-  void finalize ( void ); 
+  int finalize ( void );
 private:
+  /// fixedpointloop
+  ///   Main loop of the --fixed-points mode: record only the fixed
+  ///   points of each parameter (see FixedPointSignature)
+  void fixedpointloop ( void );
+  /// attractorloop
+  ///   Main loop of the --attractors mode: record only the minimal
+  ///   Morse sets of each parameter (see Attractors)
+  void attractorloop ( void );
   std::string network_spec_filename_;
   std::string database_filename_;
   ParameterGraph pg_;
@@ -24,5 +70,10 @@ private:
   uint64_t end_job_;
   sqlite::database db_;
   std::unordered_map<std::string, uint64_t> mg_lookup_;
+  std::string report_filename_;
+  bool fixed_points_ = false;
+  bool attractors_ = false;
+  double progress_interval_ = 10.0;
+  Instrumentation stats_;
 };
 #endif
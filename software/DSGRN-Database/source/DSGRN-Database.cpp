@@ -2,6 +2,9 @@
 
 #include "DSGRN-Database.h"
 
+#include <sys/resource.h>
+#include <unistd.h>
+
 using namespace sqlite;
 
 int main ( int argc, char * argv [] ) {
@@ -10,19 +13,71 @@ int main ( int argc, char * argv [] ) {
                   " --> network specification file \n"
                   " --> output file \n"
                   " --> [start parameter index] (optional)\n"
-                  " --> [one-past-end parameter index] (optional)\n";
+                  " --> [one-past-end parameter index] (optional)\n"
+                  "Options:\n"
+                  " --report FILE : write a JSON timing report to FILE (- for stdout)\n"
+                  " --progress SECONDS : interval between progress lines (default 10, 0 disables)\n"
+                  " --fixed-points : only record the fixed points of each parameter, skipping Morse graphs\n"
+                  " --attractors : only record the minimal Morse sets of each parameter, skipping Morse graphs\n";
     return 1;
   }
   Signatures process;
   if ( process . command_line ( argc, argv ) ) return 1;
   process . initialize ();
   process . mainloop ();
-  process . finalize ();
-  return 0;
+  return process . finalize ();
 }
 
 int Signatures::
 command_line ( int argc, char * argv [] ) {
+  // Remove options, leaving the positional arguments
+  std::vector<char*> args;
+  for ( int i = 0; i < argc; ++ i ) {
+    std::string arg = argv[i];
+    if ( arg == "--fixed-points" ) {
+      fixed_points_ = true;
+    } else if ( arg == "--attractors" ) {
+      attractors_ = true;
+    } else if ( arg == "--report" || arg == "--progress" ) {
+      if ( i + 1 == argc ) return 1;
+      if ( arg == "--report" ) {
+        report_filename_ = argv[++i];
+        // Fail now rather than after the run if the report cannot be
+        // written, without creating the file: an existing file must be
+        // writable, and otherwise its directory
+        if ( report_filename_ != "-" ) {
+          bool writable;
+          if ( access ( report_filename_ . c_str (), F_OK ) == 0 ) {
+            writable = access ( report_filename_ . c_str (), W_OK ) == 0;
+          } else {
+            std::size_t slash = report_filename_ . rfind ( '/' );
+            std::string directory = ( slash == std::string::npos ) ? "." :
+              report_filename_ . substr ( 0, std::max<std::size_t> ( slash, 1 ) );
+            writable = access ( directory . c_str (), W_OK | X_OK ) == 0;
+          }
+          if ( not writable ) {
+            std::cerr << "Could not open report file " << report_filename_ << "\n";
+            return 1;
+          }
+        }
+        continue;
+      }
+      std::string value = argv[++i];
+      try {
+        std::size_t end;
+        progress_interval_ = std::stod ( value, &end );
+        if ( end != value . size () || progress_interval_ < 0 ) throw std::invalid_argument ( value );
+      } catch ( std::exception & ) {
+        std::cerr << "Invalid --progress interval " << value << "\n";
+        return 1;
+      }
+    } else {
+      args . push_back ( argv[i] );
+    }
+  }
+  argc = args . size ();
+  argv = args . data ();
+  if ( argc < 3 || ( fixed_points_ && attractors_ ) ) return 1;
   network_spec_filename_ = argv[1];
   database_filename_ = argv[2];
 
@@ -50,12 +105,22 @@ initialize ( void ) {
   db_ = database ( database_filename_ );
 
   // Create an SQLite database
-  db_ . exec ( "create table if not exists Signatures (ParameterIndex INTEGER PRIMARY KEY, MorseGraphIndex INTEGER);" );
-  //db_ . exec ( "create table if not exists MorseGraphSHA (MorseGraphIndex INTEGER PRIMARY KEY, SHA TEXT);" );
-  db_ . exec ( "create table if not exists MorseGraphViz (MorseGraphIndex INTEGER PRIMARY KEY, Graphviz TEXT);" );
-  db_ . exec ( "create table if not exists MorseGraphVertices (MorseGraphIndex INTEGER, Vertex INTEGER);" );
-  db_ . exec ( "create table if not exists MorseGraphEdges (MorseGraphIndex INTEGER, Source INTEGER, Target INTEGER);" );
-  db_ . exec ( "create table if not exists MorseGraphAnnotations (MorseGraphIndex INTEGER, Vertex INTEGER, Label TEXT);" );
+  if ( fixed_points_ ) {
+    db_ . exec ( "create table if not exists FixedPointSignatures (ParameterIndex INTEGER PRIMARY KEY, SignatureIndex INTEGER);" );
+    db_ . exec ( "create table if not exists FixedPointSets (SignatureIndex INTEGER PRIMARY KEY, Signature TEXT, Complete INTEGER);" );
+    db_ . exec ( "create table if not exists FixedPoints (SignatureIndex INTEGER, Label TEXT);" );
+  } else if ( attractors_ ) {
+    db_ . exec ( "create table if not exists AttractorSignatures (ParameterIndex INTEGER PRIMARY KEY, SignatureIndex INTEGER);" );
+    db_ . exec ( "create table if not exists AttractorSets (SignatureIndex INTEGER PRIMARY KEY, Signature TEXT);" );
+    db_ . exec ( "create table if not exists AttractorAnnotations (SignatureIndex INTEGER, Vertex INTEGER, Label TEXT);" );
+  } else {
+    db_ . exec ( "create table if not exists Signatures (ParameterIndex INTEGER PRIMARY KEY, MorseGraphIndex INTEGER);" );
+    //db_ . exec ( "create table if not exists MorseGraphSHA (MorseGraphIndex INTEGER PRIMARY KEY, SHA TEXT);" );
+    db_ . exec ( "create table if not exists MorseGraphViz (MorseGraphIndex INTEGER PRIMARY KEY, Graphviz TEXT);" );
+    db_ . exec ( "create table if not exists MorseGraphVertices (MorseGraphIndex INTEGER, Vertex INTEGER);" );
+    db_ . exec ( "create table if not exists MorseGraphEdges (MorseGraphIndex INTEGER, Source INTEGER, Target INTEGER);" );
+    db_ . exec ( "create table if not exists MorseGraphAnnotations (MorseGraphIndex INTEGER, Vertex INTEGER, Label TEXT);" );
+  }
 
   // Create Network metadata
 
@@ -72,6 +137,8 @@ initialize ( void ) {
 }
 
 void Signatures::mainloop ( void ) {
+  if ( fixed_points_ ) return fixedpointloop ();
+  if ( attractors_ ) return attractorloop ();
 
   // Prepare statements
   statement InsertIntoMorseGraphViz = db_ . prepare ( "insert into MorseGraphViz (MorseGraphIndex, Graphviz) values (?, ?);" );
@@ -82,31 +149,58 @@ void Signatures::mainloop ( void ) {
 
   // Begin a transaction
   db_ . exec ( "begin;" );
+  stats_ . start ( end_job_ - start_job_, progress_interval_ );
   
   ///////////////
   // main loop //
   ///////////////
+  // Consecutive indices share most of their labelling, so it is carried
+  // across iterations and only the dimensions that change are relabelled
+  ParameterView previous;
+  std::vector<uint64_t> labelling;
   for ( uint64_t pi = start_job_; pi < end_job_; ++ pi ) {
     //////////
     // work //
     //////////
-    Parameter param = pg_ . parameter ( pi );
-    DomainGraph dg ( param );
-    MorseDecomposition md ( dg . digraph () );
+    stats_ . stage ( Instrumentation::DECODE );
+    ParameterView param ( pg_, pi );
+    stats_ . stage ( Instrumentation::LABELLING );
+    if ( pi == start_job_ ) {
+      labelling = param . labelling ();
+    } else {
+      param . relabel ( labelling, previous );
+    }
+    previous = param;
+    stats_ . stage ( Instrumentation::DOMAINGRAPH );
+    DomainGraph dg;
+    dg . assign ( param, labelling );
+    stats_ . stage ( Instrumentation::SCC );
+    Digraph digraph = dg . digraph ();
+    Components components = StrongComponents ( digraph );
+    stats_ . stage ( Instrumentation::MORSEDECOMPOSITION );
+    MorseDecomposition md ( digraph, components );
+    stats_ . stage ( Instrumentation::CANONICALIZE );
     MorseGraph mg ( dg, md );
     
     ////////////////////////
     // Insert Morse Graph //
     ////////////////////////
+    stats_ . stage ( Instrumentation::DEDUPE );
     uint64_t mgi;
     std::stringstream ss;
     ss << mg;
     std::string gv = ss . str ();
-    if ( mg_lookup_ . count ( gv ) ) { 
-      mgi = mg_lookup_ [ gv ];
-    } else {
+    auto it = mg_lookup_ . find ( gv );
+    bool found = it != mg_lookup_ . end ();
+    if ( found ) { 
+      mgi = it -> second;
+      ++ stats_ . dedupe_hits;
+    }
+    stats_ . stage ( Instrumentation::INSERT );
+    if ( not found ) {
       mgi = mg_lookup_ . size ();
       mg_lookup_ [ gv ] = mgi;
+      ++ stats_ . morse_graphs;
       InsertIntoMorseGraphViz . bind ( mgi, gv ) . exec ();
       uint64_t N = mg . poset () . size ();
       for ( uint64_t v = 0; v < N; ++ v ) { 
@@ -128,19 +222,274 @@ void Signatures::mainloop ( void ) {
     // Insert signature //
     //////////////////////
     InsertIntoSignatures . bind ( pi, mgi ) . exec ();
+
+    //////////////
+    // counters //
+    //////////////
+    stats_ . stage ( Instrumentation::COUNTERS );
+    for ( uint64_t v = 0; v < digraph . size (); ++ v ) {
+      stats_ . domaingraph_edges += digraph . adjacencies ( v ) . size ();
+    }
+    stats_ . recurrent_sets += components . recurrentComponents () . size ();
+    stats_ . parameter_done ();
   }
+  // Committing and indexing (see finalize) count as insertion time
+  stats_ . stage ( Instrumentation::INSERT );
   // End the transaction
   db_ . exec ( "end;" );
 }
 
 void Signatures::
+fixedpointloop ( void ) {
+  statement InsertIntoFixedPointSets = db_ . prepare ( "insert into FixedPointSets (SignatureIndex, Signature, Complete) values (?, ?, ?);" );
+  statement InsertIntoFixedPoints = db_ . prepare ( "insert into FixedPoints (SignatureIndex, Label) values (?, ?);" );
+  statement InsertIntoFixedPointSignatures = db_ . prepare ( "insert into FixedPointSignatures (ParameterIndex, SignatureIndex) values (?, ?);" );
+
+  db_ . exec ( "begin;" );
+  stats_ . start ( end_job_ - start_job_, progress_interval_ );
+  ParameterView previous;
+  std::vector<uint64_t> labelling;
+  for ( uint64_t pi = start_job_; pi < end_job_; ++ pi ) {
+    stats_ . stage ( Instrumentation::DECODE );
+    ParameterView param ( pg_, pi );
+    stats_ . stage ( Instrumentation::LABELLING );
+    if ( pi == start_job_ ) {
+      labelling = param . labelling ();
+    } else {
+      param . relabel ( labelling, previous );
+    }
+    previous = param;
+    stats_ . stage ( Instrumentation::FIXEDPOINTS );
+    FixedPointSignature fp;
+    fp . assign ( param, labelling );
+    bool complete = fp . complete ();
+    stats_ . stage ( Instrumentation::DEDUPE );
+    std::string key = fp . stringify () + ( complete ? "" : "+" );
+    uint64_t si;
+    auto it = mg_lookup_ . find ( key );
+    bool found = it != mg_lookup_ . end ();
+    if ( found ) {
+      si = it -> second;
+      ++ stats_ . dedupe_hits;
+    }
+    stats_ . stage ( Instrumentation::INSERT );
+    if ( not found ) {
+      si = mg_lookup_ . size ();
+      mg_lookup_ [ key ] = si;
+      ++ stats_ . fixed_point_signatures;
+      InsertIntoFixedPointSets . bind ( si, fp . stringify (), (uint64_t) complete ) . exec ();
+      for ( uint64_t i = 0; i < fp . size (); ++ i ) {
+        InsertIntoFixedPoints . bind ( si, fp . annotation ( i ) [ 0 ] ) . exec ();
+      }
+    }
+    InsertIntoFixedPointSignatures . bind ( pi, si ) . exec ();
+    stats_ . parameter_done ();
+  }
+  stats_ . stage ( Instrumentation::INSERT );
+  db_ . exec ( "end;" );
+}
+
+void Signatures::
+attractorloop ( void ) {
+  statement InsertIntoAttractorSets = db_ . prepare ( "insert into AttractorSets (SignatureIndex, Signature) values (?, ?);" );
+  statement InsertIntoAttractorAnnotations = db_ . prepare ( "insert into AttractorAnnotations (SignatureIndex, Vertex, Label) values (?, ?, ?);" );
+  statement InsertIntoAttractorSignatures = db_ . prepare ( "insert into AttractorSignatures (ParameterIndex, SignatureIndex) values (?, ?);" );
+
+  db_ . exec ( "begin;" );
+  stats_ . start ( end_job_ - start_job_, progress_interval_ );
+  ParameterView previous;
+  std::vector<uint64_t> labelling;
+  for ( uint64_t pi = start_job_; pi < end_job_; ++ pi ) {
+    stats_ . stage ( Instrumentation::DECODE );
+    ParameterView param ( pg_, pi );
+    stats_ . stage ( Instrumentation::LABELLING );
+    if ( pi == start_job_ ) {
+      labelling = param . labelling ();
+    } else {
+      param . relabel ( labelling, previous );
+    }
+    previous = param;
+    stats_ . stage ( Instrumentation::DOMAINGRAPH );
+    DomainGraph dg;
+    dg . assign ( param, labelling );
+    stats_ . stage ( Instrumentation::SCC );
+    Digraph digraph = dg . digraph ();
+    Components components = StrongComponents ( digraph );
+    stats_ . stage ( Instrumentation::ATTRACTORS );
+    Attractors attractors ( dg, components );
+    stats_ . stage ( Instrumentation::DEDUPE );
+    std::string key = attractors . stringify ();
+    uint64_t si;
+    auto it = mg_lookup_ . find ( key );
+    bool found = it != mg_lookup_ . end ();
+    if ( found ) {
+      si = it -> second;
+      ++ stats_ . dedupe_hits;
+    }
+    stats_ . stage ( Instrumentation::INSERT );
+    if ( not found ) {
+      si = mg_lookup_ . size ();
+      mg_lookup_ [ key ] = si;
+      ++ stats_ . attractor_signatures;
+      InsertIntoAttractorSets . bind ( si, key ) . exec ();
+      for ( uint64_t v = 0; v < attractors . size (); ++ v ) {
+        for ( std::string const& label : attractors . annotation ( v ) ) {
+          InsertIntoAttractorAnnotations . bind ( si, v, label ) . exec ();
+        }
+      }
+    }
+    InsertIntoAttractorSignatures . bind ( pi, si ) . exec ();
+
+    //////////////
+    // counters //
+    //////////////
+    stats_ . stage ( Instrumentation::COUNTERS );
+    for ( uint64_t v = 0; v < digraph . size (); ++ v ) {
+      stats_ . domaingraph_edges += digraph . adjacencies ( v ) . size ();
+    }
+    stats_ . recurrent_sets += components . recurrentComponents () . size ();
+    stats_ . parameter_done ();
+  }
+  stats_ . stage ( Instrumentation::INSERT );
+  db_ . exec ( "end;" );
+}
+
+int Signatures::
 finalize ( void ) {
   // Create the indices
-  db_ . exec ( "create index if not exists Signatures2 on Signatures (MorseGraphIndex, ParameterIndex);");
-  db_ . exec ( "create index if not exists MorseGraphAnnotations3 on MorseGraphAnnotations (Label, MorseGraphIndex);");
-  db_ . exec ( "create index if not exists MorseGraphViz2 on MorseGraphViz (Graphviz, MorseGraphIndex);");
-  db_ . exec ( "create index if not exists MorseGraphVertices1 on MorseGraphVertices (MorseGraphIndex, Vertex);");
-  db_ . exec ( "create index if not exists MorseGraphVertices2 on MorseGraphVertices (Vertex, MorseGraphIndex);");
-  db_ . exec ( "create index if not exists MorseGraphEdges1 on MorseGraphEdges (MorseGraphIndex);");
-  db_ . exec ( "create index if not exists MorseGraphAnnotations1 on MorseGraphAnnotations (MorseGraphIndex);");
+  if ( fixed_points_ ) {
+    db_ . exec ( "create index if not exists FixedPointSignatures2 on FixedPointSignatures (SignatureIndex, ParameterIndex);");
+    db_ . exec ( "create index if not exists FixedPoints1 on FixedPoints (SignatureIndex);");
+    db_ . exec ( "create index if not exists FixedPoints2 on FixedPoints (Label, SignatureIndex);");
+  } else if ( attractors_ ) {
+    db_ . exec ( "create index if not exists AttractorSignatures2 on AttractorSignatures (SignatureIndex, ParameterIndex);");
+    db_ . exec ( "create index if not exists AttractorAnnotations1 on AttractorAnnotations (SignatureIndex);");
+    db_ . exec ( "create index if not exists AttractorAnnotations2 on AttractorAnnotations (Label, SignatureIndex);");
+  } else {
+    db_ . exec ( "create index if not exists Signatures2 on Signatures (MorseGraphIndex, ParameterIndex);");
+    db_ . exec ( "create index if not exists MorseGraphAnnotations3 on MorseGraphAnnotations (Label, MorseGraphIndex);");
+    db_ . exec ( "create index if not exists MorseGraphViz2 on MorseGraphViz (Graphviz, MorseGraphIndex);");
+    db_ . exec ( "create index if not exists MorseGraphVertices1 on MorseGraphVertices (MorseGraphIndex, Vertex);");
+    db_ . exec ( "create index if not exists MorseGraphVertices2 on MorseGraphVertices (Vertex, MorseGraphIndex);");
+    db_ . exec ( "create index if not exists MorseGraphEdges1 on MorseGraphEdges (MorseGraphIndex);");
+    db_ . exec ( "create index if not exists MorseGraphAnnotations1 on MorseGraphAnnotations (MorseGraphIndex);");
+  }
+  stats_ . finish ();
+
+  // Write the report, if requested
+  if ( report_filename_ . empty () ) return 0;
+  json report = stats_ . report ();
+  report["network"] = network_spec_filename_;
+  report["database"] = database_filename_;
+  report["start"] = start_job_;
+  report["end"] = end_job_;
+  if ( report_filename_ == "-" ) {
+    std::cout << report . dump ( 2 ) << "\n" << std::flush;
+    if ( not std::cout ) {
+      std::cerr << "Could not write report to stdout\n";
+      return 1;
+    }
+    return 0;
+  }
+  std::ofstream outfile ( report_filename_ );
+  if ( not outfile . is_open () ) {
+    std::cerr << "Could not open report file " << report_filename_ << "\n";
+    return 1;
+  }
+  outfile << report . dump ( 2 ) << "\n";
+  outfile . close ();
+  if ( not outfile ) {
+    std::cerr << "Could not write report file " << report_filename_ << "\n";
+    return 1;
+  }
+  return 0;
+}
+
+/// Instrumentation
+
+namespace {
+  char const* stage_names [ Instrumentation::NUMBER_OF_STAGES ] = {
+    "decode", "labelling", "domaingraph", "scc", "morsedecomposition",
+    "canonicalize", "fixedpoints", "attractors", "dedupe", "insert",
+    "counters" };
+
+  double seconds_between ( Instrumentation::clock::time_point a,
+                           Instrumentation::clock::time_point b ) {
+    return std::chrono::duration<double> ( b - a ) . count ();
+  }
+
+  /// peak_rss
+  ///   Return the peak resident set size of the process in bytes
+  uint64_t peak_rss ( void ) {
+    struct rusage usage;
+    if ( getrusage ( RUSAGE_SELF, &usage ) != 0 ) return 0;
+#ifdef __APPLE__
+    return usage . ru_maxrss;
+#else
+    return (uint64_t) usage . ru_maxrss * 1024;
+#endif
+  }
 }
+
+void Instrumentation::
+start ( uint64_t total, double progress_interval ) {
+  total_ = total;
+  interval_ = progress_interval;
+  begin_ = mark_ = last_progress_ = clock::now ();
+}
+
+void Instrumentation::
+stage ( Stage stage ) {
+  clock::time_point now = clock::now ();
+  if ( current_ != NUMBER_OF_STAGES ) seconds_ [ current_ ] += seconds_between ( mark_, now );
+  current_ = stage;
+  mark_ = now;
+}
+
+void Instrumentation::
+parameter_done ( void ) {
+  stage ( NUMBER_OF_STAGES );
+  ++ parameters;
+  if ( interval_ > 0 && seconds_between ( last_progress_, mark_ ) >= interval_ ) {
+    last_progress_ = mark_;
+    progress ();
+  }
+}
+
+void Instrumentation::
+finish ( void ) {
+  stage ( NUMBER_OF_STAGES );
+  elapsed_ = seconds_between ( begin_, mark_ );
+}
+
+void Instrumentation::
+progress ( void ) {
+  double elapsed = seconds_between ( begin_, mark_ );
+  double rate = parameters / elapsed;
+  double eta = ( total_ - parameters ) / rate;
+  std::cerr << parameters << "/" << total_ << " parameters, "
+            << morse_graphs + fixed_point_signatures + attractor_signatures << " signatures, "
+            << (uint64_t) rate << " parameters/sec, ETA "
+            << (uint64_t) eta << "s\n";
+}
+
+json Instrumentation::
+report ( void ) const {
+  json result;
+  result["parameters"] = parameters;
+  result["seconds"] = elapsed_;
+  result["parameters_per_second"] = elapsed_ > 0 ? parameters / elapsed_ : 0.0;
+  json stages;
+  for ( int s = 0; s < NUMBER_OF_STAGES; ++ s ) stages[stage_names[s]] = seconds_[s];
+  result["stage_seconds"] = stages;
+  result["morse_graphs"] = morse_graphs;
+  result["fixed_point_signatures"] = fixed_point_signatures;
+  result["attractor_signatures"] = attractor_signatures;
+  result["dedupe_hits"] = dedupe_hits;
+  result["dedupe_hit_rate"] = parameters ? (double) dedupe_hits / parameters : 0.0;
+  result["domaingraph_edges"] = domaingraph_edges;
+  result["recurrent_sets"] = recurrent_sets;
+  result["peak_rss_bytes"] = peak_rss ();
+  return result;
+}
+
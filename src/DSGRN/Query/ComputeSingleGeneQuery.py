@@ -12,7 +12,7 @@ class ComputeSingleGeneQuery:
   def __init__(self, network, gene, labeller):
     self.network = network
     self.gene = gene
-    self.parametergraph = ParameterGraph(self.network)
+    self.parametergraph = registry().parametergraph(self.network)
     # D is the number of network nodes
     self.D = self.parametergraph.dimension()
     self.names = [ self.network.name(i) for i in range(0, self.D)]
@@ -32,12 +32,9 @@ class ComputeSingleGeneQuery:
     self.num_reduced_param = self.parametergraph.size() / self.num_gene_param
 
     # Create factor graph
-    # TODO: The following algorithm for creating a factor graph takes O(NM^2) time, where N is length of hexcodes and M is size of factorgraph.
-    #       An O(NM) algorithm is possible (based on looping through codewords and trying out each promotion, using a hash table)
-    #       Implement this.
     self.hexcodes = self.parametergraph.factorgraph(self.gene_index)
     self.vertices = set(range(0,len(self.hexcodes)))
-    self.edges = [ (gpi1, gpi2) for gpi1 in self.vertices for gpi2 in self.vertices if isAdjacentHexcode(self.hexcodes[gpi1], self.hexcodes[gpi2]) ]
+    self.edges = [ tuple(edge) for edge in self.parametergraph.factorgraph_edges(self.gene_index) ]
     self.graph = Graph(self.vertices,self.edges)
     self.full_parameter_index = lambda rpi, gpi, gene_index : rpi % self.indexing_place_values[gene_index] + gpi * self.indexing_place_values[gene_index] + (rpi // self.indexing_place_values[gene_index]) * self.indexing_place_values[gene_index+1]
     self.reduced_parameter_index = lambda pi, gene_index : (pi % self.indexing_place_values[gene_index] + (pi // self.indexing_place_values[gene_index+1]) * self.indexing_place_values[gene_index], (pi // self.indexing_place_values[gene_index]) % self.indexing_place_bases[gene_index] )
@@ -1,5 +1,6 @@
 import sqlite3
 import graphviz
+import numpy
 from DSGRN._dsgrn import *
 from functools import reduce
 
@@ -17,9 +18,9 @@ class Database:
     sqlexpression = "select Specification from Network"
     self.cursor.execute(sqlexpression)
     network_spec = self.cursor.fetchone()[0]
-    # construct network
-    self.network = Network(network_spec)
-    self.parametergraph = ParameterGraph(self.network)
+    # construct network (shared with other databases of the same network)
+    self.network = registry().network(network_spec)
+    self.parametergraph = registry().parametergraph(self.network)
     # D is the number of network nodes
     self.D = self.parametergraph.dimension()
     self.names = [ self.network.name(i) for i in range(0, self.D)]
@@ -45,6 +46,33 @@ class Database:
     mgi = c.fetchone()[0]
     return mgi
 
+  def signatures(self):
+    """
+    Return a numpy array whose entry pi is the Morse graph index of parameter index pi,
+    or -1 if the database has no signature for pi (e.g. a partially computed database).
+    NewComputeSingleGeneQuery.matches rejects -1 entries: HysteresisQuery and InducibilityQuery
+    point them to an extra label and skip the reduced parameter indices which contain them
+    (see "unsigned_reduced_parameters")
+    """
+    result = numpy.full(self.parametergraph.size(), -1, dtype=numpy.int64)
+    c = self.conn.cursor()
+    c.execute("select ParameterIndex, MorseGraphIndex from Signatures")
+    while True:
+      rows = c.fetchmany(10000)
+      if not rows:
+        break
+      indices, morsegraphindices = zip(*rows)
+      result[list(indices)] = morsegraphindices
+    c.close()
+    return result
+
+  def unsigned_reduced_parameters(self, signatures, genequery):
+    """
+    Return the set of reduced parameter indices of "genequery" (a NewComputeSingleGeneQuery)
+    for which some parameter index has no signature, i.e. an entry -1 in "signatures"
+    """
+    return set( genequery.reduced_parameter_index(int(pi))[0] for pi in numpy.flatnonzero(signatures < 0) )
+
   def __del__(self):
     """
     Commit and close upon destruction
@@ -2,12 +2,11 @@
 # MIT LICENSE 2016
 # Shaun Harker
 
-from DSGRN.Query.Graph import *
-from DSGRN.Query.AlignmentGraph import *
+import numpy
+from DSGRN._dsgrn import *
 from DSGRN.Query.MonostableFixedPointQuery import *
 from DSGRN.Query.SingleFixedPointQuery import *
 from DSGRN.Query.DoubleFixedPointQuery import *
-from DSGRN.Query.SingleGeneQuery import *
 from DSGRN.Query.Logging import LogToSTDOUT
 
 class HysteresisQuery:
@@ -27,11 +26,12 @@ class HysteresisQuery:
         B if it matches DoubleFixedPointQuery(database, quiescent_bounds, proliferative_bounds)
         O otherwise
   """
-  def __init__(self, database, gene, quiescent_bounds, proliferative_bounds):
+  def __init__(self, database, gene, quiescent_bounds, proliferative_bounds, num_threads = 0):
     """
     In order to perform hysteresis queries we must first categorize each Morse graph as either 
     'Q' monostable quiescent, 'P' monostable proliferative, 'q' quiescent, 'p' proliferative, 'B' bistable, or 'O' other
     We assume the quiescent and proliferative FP states are given by disjoint bounding rectangles
+    The path search runs natively over all reduced parameters using "num_threads" threads (0 means all cores)
     """
     LogToSTDOUT("HysteresisQuery(" + str(database.dbname) + ", " + str(gene) + ")")
     self.database = database
@@ -51,36 +51,42 @@ class HysteresisQuery:
     # Check query object to check if morse graph index has both quiescent FP and proliferative FP
     LogToSTDOUT("HysteresisQuery :: DoubleFixedPointQuery(" + str(database.dbname) + ", " + str(quiescent_bounds) + ", " + str(proliferative_bounds) + ")")
     B = DoubleFixedPointQuery(database, quiescent_bounds, proliferative_bounds)
-    # Create a labelling function which accepts a morse graph index and returns Q, P, B, p, q, or O
-    # Note: case fallthrough order matters here
-    self.matching_label = lambda mgi : 'Q' if Q(mgi) else ( 'P' if P(mgi) else ( 'B' if B(mgi) else ( 'q' if q(mgi) else ( 'p' if p(mgi) else 'O') ) ) )
-    # Create the pattern graph to represent Q -> B -> P (with self-loop on Q, B, and P)
-    self.patterngraph = Graph(set([0,1,2,3,4]), [(0,0),(1,1),(0,1),(1,0),(0,2),(1,2),(2,2),(2,3),(2,4),(3,3),(3,4),(4,4),(4,3)])
-    self.patterngraph.matching_label = lambda v : { 0:'Q', 1:'q', 2:'B', 3:'p', 4:'P' }[v]
-    # Create matching relation (in this case we just check for equality of the matching labels)
-    self.matching_relation = lambda label1, label2 : label1 == label2
-    # Create SingleGeneQuery object
-    LogToSTDOUT("HysteresisQuery :: SingleGeneQuery(" + str(database.dbname) + ", " + str(gene) + ")")
-    self.GeneQuery = SingleGeneQuery(database, gene)
-    self.memoization_cache = {}
+    # Label each morse graph index Q, P, B, q, p, or O (stored as character codes)
+    # Note: case fallthrough order matters here, so the labels are written from lowest to highest precedence
+    # Create native single gene query object
+    LogToSTDOUT("HysteresisQuery :: NewComputeSingleGeneQuery(" + str(database.dbname) + ", " + str(gene) + ")")
+    self.GeneQuery = NewComputeSingleGeneQuery(database.network, gene)
+    # Parameter indices without a signature (in a partial database) point to an extra 'O' label,
+    # and the reduced parameter indices containing them are skipped
+    signatures = database.signatures()
+    self.skipped = database.unsigned_reduced_parameters(signatures, self.GeneQuery)
+    labelling = [('p', p), ('q', q), ('B', B), ('P', P), ('Q', Q)]
+    num_morsegraphs = max([int(signatures.max()) + 1 if len(signatures) else 0] + [ max(query.matches()) + 1 for (label, query) in labelling if query.matches() ])
+    self.signatures = numpy.where(signatures < 0, num_morsegraphs, signatures).astype(numpy.uint64)
+    self.labels = numpy.full(num_morsegraphs + 1, ord('O'), dtype=numpy.uint8)
+    for (label, query) in labelling:
+      self.labels[list(query.matches())] = ord(label)
+    self.matching_label = lambda mgi : chr(self.labels[mgi])
+    # The pattern graph Q -> B -> P (with self-loops on Q, B, and P) as a regular expression
+    # over the labels of the vertices of a path from the root to the leaf of the search graph
+    self.regex = "Q(Q|q)*B+(p|P)*P"
+    self.num_threads = num_threads
+    self.set_of_matches = None
+
+  def matches(self):
+    """
+    Return the set of reduced parameter indices which match the query.
+    All reduced parameter indices are searched at once on the first call.
+    Reduced parameter indices with a parameter index missing from the database never match.
+    """
+    if self.set_of_matches is None:
+      LogToSTDOUT("HysteresisQuery: searching " + str(self.GeneQuery.number_of_reduced_parameters()) + " reduced parameters")
+      self.set_of_matches = set(self.GeneQuery.matches(self.regex, self.labels, self.signatures, num_threads=self.num_threads)) - self.skipped
+      LogToSTDOUT("HysteresisQuery: found " + str(len(self.set_of_matches)) + " matches")
+    return self.set_of_matches
 
   def __call__(self, reduced_parameter_index):
-    LogToSTDOUT("HysteresisQuery(" + str(reduced_parameter_index)  + ")") # DEBUG
-    searchgraph = self.GeneQuery(reduced_parameter_index)
-    LogToSTDOUT("HysteresisQuery: Search Graph Constructed." ) # DEBUG
-    searchgraph.matching_label = lambda v : self.matching_label(searchgraph.mgi(v))
-    searchgraphstring = ''.join([ searchgraph.matching_label(v) for v in searchgraph.vertices ])
-    if searchgraphstring not in self.memoization_cache:
-      alignment_graph = AlignmentGraph(searchgraph, self.patterngraph, self.matching_relation)
-      LogToSTDOUT("HysteresisQuery: Alignment Graph Constructed." ) # DEBUG
-      LogToSTDOUT("HysteresisQuery: Alignment Graph has " + str(len(alignment_graph.vertices)) + " vertices"  ) # DEBUG
-      LogToSTDOUT("HysteresisQuery: Alignment Graph has " + str(len(alignment_graph.edges)) + " edges"  ) # DEBUG
-      root_vertex = (0,0)
-      leaf_vertex = (len(searchgraph.vertices)-1, 4)
-      is_reachable = alignment_graph.reachable(root_vertex, leaf_vertex) 
-      #number_of_paths = alignment_graph.numberOfPaths(root_vertex, leaf_vertex) 
-      LogToSTDOUT("HysteresisQuery: Reachability computed." ) # DEBUG
-      self.memoization_cache[searchgraphstring] = is_reachable
-    LogToSTDOUT("HysteresisQuery: Returning." ) # DEBUG
-    return self.memoization_cache[searchgraphstring]
-    
+    """
+    Test if a single reduced parameter index matches the query
+    """
+    return reduced_parameter_index in self.matches()
@@ -2,10 +2,11 @@
 # MIT LICENSE 2016
 # Shaun Harker and Bree Cummins
 
+import numpy
+from DSGRN._dsgrn import *
 from DSGRN.Query.SingleFixedPointQuery import *
 from DSGRN.Query.DoubleFixedPointQuery import *
 from DSGRN.Query.MonostableFixedPointQuery import *
-from DSGRN.Query.SingleGeneQuery import *
 
 class InducibilityQuery:
   """
@@ -18,19 +19,38 @@ class InducibilityQuery:
       c is true if and only if (gpi,reduced_parameter_index) has an FP in bounds1 and an FP in bounds2
                                for some 0 < gpi < max_gpi
   """
-  def __init__(self, database, gene, bounds1, bounds2):
+  def __init__(self, database, gene, bounds1, bounds2, num_threads = 0):
+    """
+    Each morse graph index is given bit flags (1: FP1 monostable, 2: FP2 monostable, 4: double FP),
+    and the triples for all reduced parameters are computed natively on first use
+    using "num_threads" threads (0 means all cores)
+    """
     self.QueryFP1 = MonostableFixedPointQuery(database, bounds1)
     self.QueryFP2 = MonostableFixedPointQuery(database, bounds2)
     self.QueryDoubleFP = DoubleFixedPointQuery(database,bounds1,bounds2)
-    self.GeneQuery = SingleGeneQuery(database, gene)
+    self.GeneQuery = NewComputeSingleGeneQuery(database.network, gene)
     self.max_gpi = self.GeneQuery.number_of_gene_parameters() - 1
+    # Parameter indices without a signature (in a partial database) point to an extra
+    # unflagged entry, and the reduced parameter indices containing them are skipped
+    signatures = database.signatures()
+    self.skipped = database.unsigned_reduced_parameters(signatures, self.GeneQuery)
+    flagging = [(1, self.QueryFP1), (2, self.QueryFP2), (4, self.QueryDoubleFP)]
+    num_morsegraphs = max([int(signatures.max()) + 1 if len(signatures) else 0] + [ max(query.matches()) + 1 for (bit, query) in flagging if query.matches() ])
+    self.signatures = numpy.where(signatures < 0, num_morsegraphs, signatures).astype(numpy.uint64)
+    self.flags = numpy.zeros(num_morsegraphs + 1, dtype=numpy.uint8)
+    for (bit, query) in flagging:
+      self.flags[list(query.matches())] |= bit
+    self.num_threads = num_threads
+    self.results = None
 
   def __call__(self, reduced_parameter_index):
     """
-    Given a reduced parameter index, return a triple of boolean values (a,b,c)
+    Given a reduced parameter index, return a triple of boolean values (a,b,c),
+    or None if some of its parameter indices are missing from the database
     """
-    query_graph = self.GeneQuery(reduced_parameter_index)
-    a = self.QueryFP1(query_graph.mgi(0))
-    b = self.QueryFP2(query_graph.mgi(self.max_gpi))
-    c = any ( self.QueryDoubleFP(query_graph.mgi(i)) for i in range(1,self.max_gpi) )
-    return (a, b, c)
\ No newline at end of file
+    if reduced_parameter_index in self.skipped:
+      return None
+    if self.results is None:
+      self.results = self.GeneQuery.inducibility(self.flags, self.signatures, num_threads=self.num_threads)
+    bits = int(self.results[reduced_parameter_index])
+    return (bool(bits & 1), bool(bits & 2), bool(bits & 4))
@@ -20,12 +20,9 @@ class SingleGeneQuery:
     self.num_reduced_param = database.parametergraph.size() / self.num_gene_param
 
     # Create factor graph
-    # TODO: The following algorithm for creating a factor graph takes O(NM^2) time, where N is length of hexcodes and M is size of factorgraph.
-    #       An O(NM) algorithm is possible (based on looping through codewords and trying out each promotion, using a hash table)
-    #       Implement this.
     self.hexcodes = self.database.parametergraph.factorgraph(self.gene_index)
     vertices = set(range(0,len(self.hexcodes)))
-    edges = [ (gpi1, gpi2) for gpi1 in vertices for gpi2 in vertices if isAdjacentHexcode(self.hexcodes[gpi1], self.hexcodes[gpi2]) ]
+    edges = [ tuple(edge) for edge in self.database.parametergraph.factorgraph_edges(self.gene_index) ]
     self.graph = Graph(vertices,edges)
     
     LogToSTDOUT("SingleGeneQuery: FactorGraph generated")
@@ -0,0 +1,61 @@
+# MakeCAD.py
+# MIT LICENSE 2018
+# Shaun Harker
+
+"""
+Generate the binary CAD databases (X.cad) read by CADDatabase from the
+JSON databases (X.json) in this directory.
+
+Usage: python MakeCAD.py [directory]
+
+The binary format is written in the byte order of the machine running
+this script (see CADDatabase.h):
+  8 bytes  magic "DSGRNCAD"
+  6 uint64 byte order mark 0x0102030405060708, version, n, m, N, digits
+  N uint64 hex codes, in the order of the JSON file
+  N uint64 indices of the records sorted by hex code
+  N*(2n+m) doubles  L[1..n], U[1..n], T[1..m] of each record
+CADDatabase falls back to the JSON file when the header of a binary file
+does not match (e.g. it was generated on a machine of the other byte
+order), so running this script is only needed to regenerate the files.
+"""
+
+import glob
+import json
+import os
+import struct
+import sys
+
+MAGIC = b"DSGRNCAD"
+BYTE_ORDER = 0x0102030405060708
+VERSION = 1
+
+def MakeCAD(jsonfile, cadfile):
+  with open(jsonfile) as infile:
+    records = json.load(infile)
+  n = m = digits = 0
+  if records:
+    n = sum(1 for key in records[0]["Instance"] if key[0] == 'L')
+    m = sum(1 for key in records[0]["Instance"] if key[0] == 'T')
+    digits = len(records[0]["Hex"])
+  names = ["L[" + str(i+1) + "]" for i in range(n)] + ["U[" + str(i+1) + "]" for i in range(n)] + ["T[" + str(i+1) + "]" for i in range(m)]
+  hexcodes = [int(record["Hex"], 16) for record in records]
+  order = sorted(range(len(hexcodes)), key=lambda i : hexcodes[i])
+  N = len(records)
+  with open(cadfile, "wb") as outfile:
+    outfile.write(MAGIC)
+    outfile.write(struct.pack("=6Q", BYTE_ORDER, VERSION, n, m, N, digits))
+    outfile.write(struct.pack("=" + str(N) + "Q", *hexcodes))
+    outfile.write(struct.pack("=" + str(N) + "Q", *order))
+    for record in records:
+      outfile.write(struct.pack("=" + str(len(names)) + "d", *[float(record["Instance"][name]) for name in names]))
+
+def main():
+  directory = sys.argv[1] if len(sys.argv) > 1 else os.path.dirname(os.path.abspath(__file__))
+  for jsonfile in sorted(glob.glob(os.path.join(directory, "*.json"))):
+    cadfile = jsonfile[:-len(".json")] + ".cad"
+    MakeCAD(jsonfile, cadfile)
+    print(cadfile)
+
+if __name__ == "__main__":
+  main()
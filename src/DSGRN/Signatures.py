@@ -36,7 +36,7 @@ def SaveDatabase(filename, data, pg):
         bar.finish()
 
     def MG(mgi):
-        return MorseGraph().parse(morsegraphs[mgi])
+        return MorseGraph().deserialize(morsegraphs[mgi])
 
     name = filename
     if filename[-3:] == '.db':
@@ -95,7 +95,7 @@ outfile = sys.argv[2]
 gpg = ParameterGraph(Network(specfile))
 
 def work(pi): 
-  return (pi, MorseGraph(DomainGraph(gpg.parameter(pi))).stringify())
+  return (pi, MorseGraph(DomainGraph(gpg.parameter(pi))).serialize())
 
 def main():
     global gpg
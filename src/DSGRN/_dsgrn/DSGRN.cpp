@@ -15,6 +15,8 @@ PYBIND11_MODULE( _dsgrn, m) {
   AnnotationBinding(m);
   MorseDecompositionBinding(m);
   MorseGraphBinding(m);
+  FixedPointSignatureBinding(m);
+  AttractorsBinding(m);
   // Graph
   DigraphBinding(m);
   PosetBinding(m);
@@ -27,7 +29,10 @@ PYBIND11_MODULE( _dsgrn, m) {
   OrderParameterBinding(m);
   ParameterBinding(m);
   ParameterGraphBinding(m);
+  ParameterViewBinding(m);
   ConfigurationBinding(m);
+  RegistryBinding(m);
+  CADDatabaseBinding(m);
   ParameterSamplerBinding(m);
   // Phase
   DomainBinding(m);
@@ -36,11 +41,13 @@ PYBIND11_MODULE( _dsgrn, m) {
   MatchingGraphBinding(m);
   MatchingRelationBinding(m);
   PatternBinding(m);
+  PatternBuilderBinding(m);
   PatternGraphBinding(m);
   PatternMatchBinding(m);
   SearchGraphBinding(m);
   // Query
   NFABinding(m);
   ComputeSingleGeneQueryBinding(m);
+  DFABinding(m);
   ThompsonsConstructionBinding(m);
 }
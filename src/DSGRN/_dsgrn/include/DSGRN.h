@@ -2,13 +2,37 @@
 /// Shaun Harker
 /// 2015-05-29
 
+/// Thread safety
+///   Const methods only read, so objects may be shared between threads
+///   once built. State shared behind const methods is locked internally:
+///   the labelling planes of Parameter, the factor graph edges and
+///   ParameterView tables of ParameterGraph, the random generator of
+///   ParameterSampler and the edge array which the first read of an
+///   edited LabelledMultidigraph (or NFA) builds.
+///   Configuration and Registry lock all of their methods.
+///   Other non-const methods (assign, load, add_vertex, add_edge,
+///   finalize, resize, ...) need the caller to lock: no other thread may
+///   use the object meanwhile. Copies share their data, so edits through
+///   a copy (e.g. Digraph::add_edge) count as edits of the object. In
+///   particular Digraph, LabelledMultidigraph, NFA and Network must not
+///   be edited while another thread reads them.
+///   In Python, the bindings of the expensive calls release the GIL while
+///   they compute: building parameter graphs, labellings, domain graphs,
+///   Morse graphs, sampling, the automaton algorithms (NFA.intersect,
+///   intersects, witness, count_paths, DFA and DFA.accepts) and pattern
+///   matching (SearchGraph, PatternGraph, MatchingGraph, CycleMatch,
+///   PathMatch, ...). Edits of graphs and automata keep it.
+
 #pragma once
 
 #include "Parameter/Network.h"
 #include "Parameter/Parameter.h"
 #include "Parameter/ParameterGraph.h"
+#include "Parameter/ParameterView.h"
+#include "Parameter/Registry.h"
 #include "Parameter/OrderParameter.h"
 #include "Parameter/LogicParameter.h"
+#include "Parameter/CADDatabase.h"
 #include "Parameter/ParameterSampler.h"
 #include "Phase/Domain.h"
 #include "Phase/DomainGraph.h"
@@ -17,6 +41,8 @@
 #include "Dynamics/Annotation.h"
 #include "Dynamics/MorseDecomposition.h"
 #include "Dynamics/MorseGraph.h"
+#include "Dynamics/FixedPointSignature.h"
+#include "Dynamics/Attractors.h"
 #include "Graph/Digraph.h"
 #include "Graph/Poset.h"
 #include "Graph/Components.h"
@@ -25,9 +51,11 @@
 #include "Pattern/MatchingGraph.h"
 #include "Pattern/MatchingRelation.h"
 #include "Pattern/Pattern.h"
+#include "Pattern/PatternBuilder.h"
 #include "Pattern/PatternGraph.h"
 #include "Pattern/PatternMatch.h"
 #include "Pattern/SearchGraph.h"
 #include "Query/ComputeSingleGeneQuery.h"
+#include "Query/DFA.h"
 #include "Query/NFA.h"
 #include "Query/ThompsonsConstruction.h"
@@ -16,12 +16,17 @@
 #include "Dynamics/Annotation.hpp"
 #include "Dynamics/MorseDecomposition.hpp"
 #include "Dynamics/MorseGraph.hpp"
+#include "Dynamics/FixedPointSignature.hpp"
+#include "Dynamics/Attractors.hpp"
 #include "Parameter/Network.hpp"
 #include "Parameter/LogicParameter.hpp"
 #include "Parameter/OrderParameter.hpp"
 #include "Parameter/Parameter.hpp"
 #include "Parameter/ParameterGraph.hpp"
+#include "Parameter/ParameterView.hpp"
 #include "Parameter/Configuration.h"
+#include "Parameter/Registry.hpp"
+#include "Parameter/CADDatabase.hpp"
 #include "Parameter/ParameterSampler.hpp"
 #include "Phase/Domain.hpp"
 #include "Phase/DomainGraph.hpp"
@@ -30,9 +35,11 @@
 #include "Pattern/MatchingGraph.hpp"
 #include "Pattern/MatchingRelation.hpp"
 #include "Pattern/Pattern.hpp"
+#include "Pattern/PatternBuilder.hpp"
 #include "Pattern/PatternGraph.hpp"
 #include "Pattern/PatternMatch.hpp"
 #include "Pattern/SearchGraph.hpp"
 #include "Query/ComputeSingleGeneQuery.hpp"
+#include "Query/DFA.hpp"
 #include "Query/NFA.hpp"
 #include "Query/ThompsonsConstruction.hpp"
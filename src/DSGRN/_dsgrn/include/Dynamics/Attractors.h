@@ -0,0 +1,113 @@
+/// Attractors.h
+/// Shaun Harker
+/// 2018-11-20
+/// MIT LICENSE
+
+#pragma once
+
+#ifndef INLINE_IF_HEADER_ONLY
+#define INLINE_IF_HEADER_ONLY
+#endif
+
+#include "common.h"
+
+#include "Graph/Digraph.h"
+#include "Graph/Components.h"
+#include "Graph/StrongComponents.h"
+#include "Dynamics/Annotation.h"
+#include "Phase/DomainGraph.h"
+
+struct Attractors_;
+
+/// Attractors
+///   The minimal Morse sets of a domain graph, i.e. the minimal vertices
+///   of its Morse graph, with their annotations. These are the recurrent
+///   strong components which reach no other recurrent component. (Not
+///   every one is a terminal strong component: it may reach domains
+///   without a self-edge which are sinks.) They are found in one pass
+///   over the strong components in reverse topological order, skipping
+///   the reachability between all recurrent components and the partial
+///   order which MorseDecomposition computes, so stability questions
+///   can be screened before building full Morse graphs.
+///   Attractors are ordered by annotation, so equal lists of annotations
+///   give equal stringify() results.
+class Attractors {
+public:
+  /// Attractors
+  Attractors ( void );
+
+  /// Attractors
+  ///   Find the minimal Morse sets of a domain graph
+  Attractors ( DomainGraph const& dg );
+
+  /// Attractors
+  ///   Find the minimal Morse sets of a domain graph, given the strong
+  ///   components of its digraph
+  Attractors ( DomainGraph const& dg, Components const& components );
+
+  /// assign
+  ///   Find the minimal Morse sets of a domain graph
+  void
+  assign ( DomainGraph const& dg );
+
+  /// assign
+  ///   Find the minimal Morse sets of a domain graph, given the strong
+  ///   components of its digraph
+  ///   (This method is provided in case
+  ///    strong components are already computed.)
+  void
+  assign ( DomainGraph const& dg, Components const& components );
+
+  /// size
+  ///   Return the number of minimal Morse sets
+  uint64_t
+  size ( void ) const;
+
+  /// morseset
+  ///   Return the domains of the ith minimal Morse set
+  std::vector<uint64_t> const&
+  morseset ( uint64_t i ) const;
+
+  /// annotation
+  ///   Return the annotation of the ith minimal Morse set
+  Annotation const
+  annotation ( uint64_t i ) const;
+
+  /// stringify
+  ///   Return the list of annotations as a JSON string
+  std::string
+  stringify ( void ) const;
+
+  /// operator <<
+  ///   Stream out the list of annotations
+  friend std::ostream& operator << ( std::ostream& stream, Attractors const& attractors );
+
+private:
+  std::shared_ptr<Attractors_> data_;
+};
+
+struct Attractors_ {
+  std::vector<std::vector<uint64_t>> morsesets_;
+  std::vector<Annotation> annotations_;
+};
+
+/// Python Bindings
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+namespace py = pybind11;
+
+inline void
+AttractorsBinding (py::module &m) {
+  py::class_<Attractors, std::shared_ptr<Attractors>>(m, "Attractors")
+    .def(py::init<>())
+    .def(py::init<DomainGraph const&>(), py::call_guard<py::gil_scoped_release>())
+    .def(py::init<DomainGraph const&, Components const&>(), py::call_guard<py::gil_scoped_release>())
+    .def("assign", (void(Attractors::*)(DomainGraph const&))&Attractors::assign, py::call_guard<py::gil_scoped_release>())
+    .def("assign", (void(Attractors::*)(DomainGraph const&, Components const&))&Attractors::assign, py::call_guard<py::gil_scoped_release>())
+    .def("size", &Attractors::size)
+    .def("morseset", &Attractors::morseset)
+    .def("annotation", &Attractors::annotation)
+    .def("stringify", &Attractors::stringify)
+    .def("__str__", [](Attractors const& a){ std::stringstream ss; ss << a; return ss.str(); });
+}
@@ -0,0 +1,110 @@
+/// Attractors.hpp
+/// Shaun Harker
+/// 2018-11-20
+/// MIT LICENSE
+
+#pragma once
+
+#ifndef INLINE_IF_HEADER_ONLY
+#define INLINE_IF_HEADER_ONLY
+#endif
+
+#include "Attractors.h"
+
+INLINE_IF_HEADER_ONLY Attractors::
+Attractors ( void ) {
+  data_ . reset ( new Attractors_ );
+}
+
+INLINE_IF_HEADER_ONLY Attractors::
+Attractors ( DomainGraph const& dg ) {
+  assign ( dg );
+}
+
+INLINE_IF_HEADER_ONLY Attractors::
+Attractors ( DomainGraph const& dg, Components const& components ) {
+  assign ( dg, components );
+}
+
+INLINE_IF_HEADER_ONLY void Attractors::
+assign ( DomainGraph const& dg ) {
+  assign ( dg, StrongComponents ( dg . digraph () ) );
+}
+
+INLINE_IF_HEADER_ONLY void Attractors::
+assign ( DomainGraph const& dg, Components const& components ) {
+  data_ . reset ( new Attractors_ );
+  Digraph digraph = dg . digraph ();
+  std::vector<uint64_t> const& vertices = components . vertices ();
+  std::vector<uint64_t> const& offsets = components . offsets ();
+  std::vector<uint64_t> const& which = components . whichComponents ();
+  uint64_t C = components . size ();
+  // below[c] is true when component c reaches a recurrent component
+  // other than itself. Edges go from a component to itself or to a
+  // later one, so later components are settled first.
+  std::vector<bool> below ( C, false );
+  std::vector<uint64_t> minimal;
+  for ( uint64_t c = C; c -- > 0; ) {
+    for ( uint64_t k = offsets[c]; k < offsets[c+1] && not below[c]; ++ k ) {
+      for ( uint64_t v : digraph . adjacencies ( vertices[k] ) ) {
+        uint64_t child = which [ v ];
+        if ( child != c && ( below [ child ] || components . isRecurrent ( child ) ) ) {
+          below [ c ] = true;
+          break;
+        }
+      }
+    }
+    if ( components . isRecurrent ( c ) && not below [ c ] ) minimal . push_back ( c );
+  }
+  // Order by annotation, then by domains
+  std::vector<std::pair<std::string, std::vector<uint64_t>>> sets;
+  std::vector<Annotation> annotations;
+  for ( uint64_t c : minimal ) {
+    Component component = components [ c ];
+    std::vector<uint64_t> domains ( component . begin (), component . end () );
+    std::sort ( domains . begin (), domains . end () );
+    annotations . push_back ( dg . annotate ( component ) );
+    sets . push_back ( { annotations . back () . stringify (), domains } );
+  }
+  std::vector<uint64_t> order ( sets . size () );
+  for ( uint64_t i = 0; i < order . size (); ++ i ) order[i] = i;
+  std::sort ( order . begin (), order . end (), [&] ( uint64_t a, uint64_t b ) {
+    return sets[a] < sets[b];
+  });
+  for ( uint64_t i : order ) {
+    data_ -> morsesets_ . push_back ( sets[i] . second );
+    data_ -> annotations_ . push_back ( annotations[i] );
+  }
+}
+
+INLINE_IF_HEADER_ONLY uint64_t Attractors::
+size ( void ) const {
+  return data_ -> morsesets_ . size ();
+}
+
+INLINE_IF_HEADER_ONLY std::vector<uint64_t> const& Attractors::
+morseset ( uint64_t i ) const {
+  return data_ -> morsesets_ . at ( i );
+}
+
+INLINE_IF_HEADER_ONLY Annotation const Attractors::
+annotation ( uint64_t i ) const {
+  return data_ -> annotations_ . at ( i );
+}
+
+INLINE_IF_HEADER_ONLY std::string Attractors::
+stringify ( void ) const {
+  std::stringstream ss;
+  ss << "[";
+  for ( uint64_t i = 0; i < size (); ++ i ) {
+    if ( i > 0 ) ss << ",";
+    ss << data_ -> annotations_[i] . stringify ();
+  }
+  ss << "]";
+  return ss . str ();
+}
+
+INLINE_IF_HEADER_ONLY std::ostream& operator << ( std::ostream& stream, Attractors const& attractors ) {
+  stream << attractors . stringify ();
+  return stream;
+}
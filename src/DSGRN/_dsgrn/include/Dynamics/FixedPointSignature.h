@@ -0,0 +1,149 @@
+/// FixedPointSignature.h
+/// Shaun Harker
+/// 2018-11-20
+/// MIT LICENSE
+
+#pragma once
+
+#ifndef INLINE_IF_HEADER_ONLY
+#define INLINE_IF_HEADER_ONLY
+#endif
+
+#include "common.h"
+
+#include "Parameter/Parameter.h"
+#include "Parameter/ParameterView.h"
+#include "Dynamics/Annotation.h"
+
+struct FixedPointSignature_;
+
+/// FixedPointSignature
+///   The fixed points of a parameter, computed from its labelling alone
+///   without building the domain graph, its strong components or the
+///   Morse graph. A domain is a fixed point exactly when its label is 0:
+///   its only edge in the domain graph is then the self-edge, so it is a
+///   minimal Morse set by itself, annotated "FP { ... }" in the Morse
+///   graph. Whether the fixed points are all of the minimal Morse sets is
+///   answered by "complete", which needs a reachability search; assign
+///   runs it unless "check_complete" is false, and keeps only the answer.
+class FixedPointSignature {
+public:
+  /// FixedPointSignature
+  FixedPointSignature ( void );
+
+  /// FixedPointSignature
+  ///   Find the fixed points of a parameter
+  FixedPointSignature ( Parameter const& parameter );
+
+  /// assign
+  ///   Find the fixed points of a parameter, and whether they are
+  ///   complete if "check_complete" is true
+  void
+  assign ( Parameter const& parameter, bool check_complete = true );
+
+  /// assign
+  ///   Find the fixed points of a parameter, given its labelling
+  ///   (This method is provided in case the labelling
+  ///    is already computed.)
+  void
+  assign ( Parameter const& parameter,
+           std::vector<uint64_t> const& labelling,
+           bool check_complete = true );
+
+  /// FixedPointSignature
+  ///   Find the fixed points of a parameter view
+  FixedPointSignature ( ParameterView const& parameter );
+
+  /// assign
+  ///   Find the fixed points of a parameter view, and whether they are
+  ///   complete if "check_complete" is true
+  void
+  assign ( ParameterView const& parameter, bool check_complete = true );
+
+  /// assign
+  ///   Find the fixed points of a parameter view, given its labelling
+  void
+  assign ( ParameterView const& parameter,
+           std::vector<uint64_t> const& labelling,
+           bool check_complete = true );
+
+  /// size
+  ///   Return the number of fixed points
+  uint64_t
+  size ( void ) const;
+
+  /// domains
+  ///   Return the indices of the fixed point domains, in increasing order
+  std::vector<uint64_t> const&
+  domains ( void ) const;
+
+  /// coordinates
+  ///   Return the coordinates of the ith fixed point domain
+  std::vector<uint64_t>
+  coordinates ( uint64_t i ) const;
+
+  /// annotation
+  ///   Return the annotation of the ith fixed point, as in the Morse graph
+  Annotation const
+  annotation ( uint64_t i ) const;
+
+  /// complete
+  ///   Return true if the fixed points are all of the minimal Morse
+  ///   sets, i.e. the domains which do not reach a fixed point in the
+  ///   domain graph contain no cycle. Searches backwards from the fixed
+  ///   points along the edges implied by the labelling, when assigned;
+  ///   linear in the number of domains. Throws if assign was asked not
+  ///   to check.
+  bool
+  complete ( void ) const;
+
+  /// stringify
+  ///   Return the list of fixed point coordinates as a JSON string
+  std::string
+  stringify ( void ) const;
+
+  /// operator <<
+  ///   Stream out the list of fixed point coordinates
+  friend std::ostream& operator << ( std::ostream& stream, FixedPointSignature const& signature );
+
+private:
+  std::shared_ptr<FixedPointSignature_> data_;
+
+  /// _assign
+  ///   Find the fixed points from the network and the labelling
+  void
+  _assign ( Network const& network,
+            std::vector<uint64_t> const& labelling,
+            bool check_complete );
+};
+
+struct FixedPointSignature_ {
+  uint64_t dimension_;
+  std::vector<uint64_t> limits_;
+  std::vector<uint64_t> domains_;
+  bool checked_;
+  bool complete_;
+};
+
+/// Python Bindings
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+namespace py = pybind11;
+
+inline void
+FixedPointSignatureBinding (py::module &m) {
+  py::class_<FixedPointSignature, std::shared_ptr<FixedPointSignature>>(m, "FixedPointSignature")
+    .def(py::init<>())
+    .def(py::init<Parameter const&>(), py::call_guard<py::gil_scoped_release>())
+    .def(py::init<ParameterView const&>(), py::call_guard<py::gil_scoped_release>())
+    .def("assign", (void(FixedPointSignature::*)(Parameter const&, bool))&FixedPointSignature::assign, py::arg("parameter"), py::arg("check_complete") = true, py::call_guard<py::gil_scoped_release>())
+    .def("assign", (void(FixedPointSignature::*)(ParameterView const&, bool))&FixedPointSignature::assign, py::arg("parameter"), py::arg("check_complete") = true, py::call_guard<py::gil_scoped_release>())
+    .def("size", &FixedPointSignature::size)
+    .def("domains", &FixedPointSignature::domains)
+    .def("coordinates", &FixedPointSignature::coordinates)
+    .def("annotation", &FixedPointSignature::annotation)
+    .def("complete", &FixedPointSignature::complete)
+    .def("stringify", &FixedPointSignature::stringify)
+    .def("__str__", [](FixedPointSignature const& s){ std::stringstream ss; ss << s; return ss.str(); });
+}
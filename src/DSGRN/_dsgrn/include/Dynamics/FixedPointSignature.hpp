@@ -0,0 +1,224 @@
+/// FixedPointSignature.hpp
+/// Shaun Harker
+/// 2018-11-20
+/// MIT LICENSE
+
+#pragma once
+
+#ifndef INLINE_IF_HEADER_ONLY
+#define INLINE_IF_HEADER_ONLY
+#endif
+
+#include "FixedPointSignature.h"
+
+namespace FixedPointSignature_detail {
+  /// predecessors
+  ///   Call f(j) for each edge j -> i of the domain graph between
+  ///   neighbors: the label of j points at i and the label of i does not
+  ///   point back at j (see DomainGraph::assign). No label points out of
+  ///   phase space, so a neighbor index past the edge of phase space in
+  ///   dimension d (which lands on the opposite face) never has an edge.
+  template < class F > void
+  predecessors ( uint64_t i, std::vector<uint64_t> const& jump,
+                 std::vector<uint64_t> const& labelling, F const& f ) {
+    uint64_t D = jump . size ();
+    uint64_t N = labelling . size ();
+    uint64_t label = labelling [ i ];
+    for ( uint64_t d = 0; d < D; ++ d ) {
+      uint64_t leftbit = 1LL << d;
+      uint64_t rightbit = 1LL << (D+d);
+      if ( i >= jump[d] && not ( label & leftbit ) && ( labelling [ i - jump[d] ] & rightbit ) ) {
+        f ( i - jump[d] );
+      }
+      if ( i + jump[d] < N && not ( label & rightbit ) && ( labelling [ i + jump[d] ] & leftbit ) ) {
+        f ( i + jump[d] );
+      }
+    }
+  }
+
+  /// complete
+  ///   Return true if the domains which do not reach one of the fixed
+  ///   points "domains" contain no cycle (see FixedPointSignature::complete)
+  inline bool
+  complete ( std::vector<uint64_t> const& limits,
+             std::vector<uint64_t> const& labelling,
+             std::vector<uint64_t> const& domains ) {
+    uint64_t D = limits . size ();
+    uint64_t N = labelling . size ();
+    std::vector<uint64_t> jump ( D );
+    uint64_t M = 1;
+    for ( uint64_t d = 0; d < D; ++ d ) {
+      jump[d] = M;
+      M *= limits[d];
+    }
+    // Search backwards from the fixed points
+    std::vector<bool> reached ( N, false );
+    std::vector<uint64_t> stack = domains;
+    for ( uint64_t i : stack ) reached [ i ] = true;
+    uint64_t count = stack . size ();
+    while ( not stack . empty () && count < N ) {
+      uint64_t i = stack . back ();
+      stack . pop_back ();
+      FixedPointSignature_detail::predecessors ( i, jump, labelling, [&] ( uint64_t j ) {
+        if ( reached [ j ] ) return;
+        reached [ j ] = true;
+        ++ count;
+        stack . push_back ( j );
+      });
+    }
+    if ( count == N ) return true;
+    // The remaining domains have all their successors among themselves.
+    // They hold another minimal Morse set unless they are acyclic, which
+    // is checked by peeling off domains without remaining successors.
+    std::vector<uint64_t> outdegree ( N, 0 );
+    stack . clear ();
+    for ( uint64_t i = 0; i < N; ++ i ) {
+      if ( reached [ i ] ) continue;
+      FixedPointSignature_detail::predecessors ( i, jump, labelling, [&] ( uint64_t j ) {
+        if ( not reached [ j ] ) ++ outdegree [ j ];
+      });
+    }
+    for ( uint64_t i = 0; i < N; ++ i ) {
+      if ( not reached [ i ] && outdegree [ i ] == 0 ) stack . push_back ( i );
+    }
+    while ( not stack . empty () ) {
+      uint64_t i = stack . back ();
+      stack . pop_back ();
+      ++ count;
+      FixedPointSignature_detail::predecessors ( i, jump, labelling, [&] ( uint64_t j ) {
+        if ( not reached [ j ] && -- outdegree [ j ] == 0 ) stack . push_back ( j );
+      });
+    }
+    return count == N;
+  }
+}
+
+INLINE_IF_HEADER_ONLY FixedPointSignature::
+FixedPointSignature ( void ) {
+  data_ . reset ( new FixedPointSignature_ );
+  data_ -> dimension_ = 0;
+  data_ -> checked_ = true;
+  data_ -> complete_ = true;
+}
+
+INLINE_IF_HEADER_ONLY FixedPointSignature::
+FixedPointSignature ( Parameter const& parameter ) {
+  assign ( parameter );
+}
+
+INLINE_IF_HEADER_ONLY void FixedPointSignature::
+assign ( Parameter const& parameter, bool check_complete ) {
+  assign ( parameter, parameter . labelling (), check_complete );
+}
+
+INLINE_IF_HEADER_ONLY void FixedPointSignature::
+assign ( Parameter const& parameter,
+         std::vector<uint64_t> const& labelling,
+         bool check_complete ) {
+  _assign ( parameter . network (), labelling, check_complete );
+}
+
+INLINE_IF_HEADER_ONLY FixedPointSignature::
+FixedPointSignature ( ParameterView const& parameter ) {
+  assign ( parameter );
+}
+
+INLINE_IF_HEADER_ONLY void FixedPointSignature::
+assign ( ParameterView const& parameter, bool check_complete ) {
+  assign ( parameter, parameter . labelling (), check_complete );
+}
+
+INLINE_IF_HEADER_ONLY void FixedPointSignature::
+assign ( ParameterView const& parameter,
+         std::vector<uint64_t> const& labelling,
+         bool check_complete ) {
+  _assign ( parameter . network (), labelling, check_complete );
+}
+
+INLINE_IF_HEADER_ONLY void FixedPointSignature::
+_assign ( Network const& network,
+          std::vector<uint64_t> const& labelling,
+          bool check_complete ) {
+  data_ . reset ( new FixedPointSignature_ );
+  data_ -> dimension_ = network . size ();
+  data_ -> limits_ = network . domains ();
+  uint64_t N = 1;
+  for ( uint64_t limit : data_ -> limits_ ) N *= limit;
+  if ( labelling . size () != N ) {
+    throw std::invalid_argument ( "FixedPointSignature::assign: labelling has the wrong size" );
+  }
+  for ( uint64_t i = 0; i < N; ++ i ) {
+    if ( labelling [ i ] == 0 ) data_ -> domains_ . push_back ( i );
+  }
+  data_ -> checked_ = check_complete;
+  data_ -> complete_ = check_complete &&
+    FixedPointSignature_detail::complete ( data_ -> limits_, labelling, data_ -> domains_ );
+}
+
+INLINE_IF_HEADER_ONLY uint64_t FixedPointSignature::
+size ( void ) const {
+  return data_ -> domains_ . size ();
+}
+
+INLINE_IF_HEADER_ONLY std::vector<uint64_t> const& FixedPointSignature::
+domains ( void ) const {
+  return data_ -> domains_;
+}
+
+INLINE_IF_HEADER_ONLY std::vector<uint64_t> FixedPointSignature::
+coordinates ( uint64_t i ) const {
+  uint64_t D = data_ -> dimension_;
+  std::vector<uint64_t> result ( D );
+  uint64_t domain = data_ -> domains_ . at ( i );
+  for ( uint64_t d = 0; d < D; ++ d ) {
+    result[d] = domain % data_ -> limits_[d];
+    domain = domain / data_ -> limits_[d];
+  }
+  return result;
+}
+
+INLINE_IF_HEADER_ONLY Annotation const FixedPointSignature::
+annotation ( uint64_t i ) const {
+  std::stringstream ss;
+  ss << "FP { ";
+  bool first_term = true;
+  for ( uint64_t x : coordinates ( i ) ) {
+    if ( first_term ) first_term = false; else ss << ", ";
+    ss << x;
+  }
+  ss << " }";
+  Annotation a;
+  a . append ( ss . str () );
+  return a;
+}
+
+INLINE_IF_HEADER_ONLY bool FixedPointSignature::
+complete ( void ) const {
+  if ( not data_ -> checked_ ) {
+    throw std::logic_error ( "FixedPointSignature::complete: assigned without check_complete" );
+  }
+  return data_ -> complete_;
+}
+
+INLINE_IF_HEADER_ONLY std::string FixedPointSignature::
+stringify ( void ) const {
+  std::stringstream ss;
+  ss << "[";
+  for ( uint64_t i = 0; i < size (); ++ i ) {
+    if ( i > 0 ) ss << ",";
+    ss << "[";
+    bool first_term = true;
+    for ( uint64_t x : coordinates ( i ) ) {
+      if ( first_term ) first_term = false; else ss << ",";
+      ss << x;
+    }
+    ss << "]";
+  }
+  ss << "]";
+  return ss . str ();
+}
+
+INLINE_IF_HEADER_ONLY std::ostream& operator << ( std::ostream& stream, FixedPointSignature const& signature ) {
+  stream << signature . stringify ();
+  return stream;
+}
@@ -106,8 +106,8 @@ inline void
 MorseDecompositionBinding (py::module &m) {
   py::class_<MorseDecomposition, std::shared_ptr<MorseDecomposition>, TypedObject>(m, "MorseDecomposition")
     .def(py::init<>())
-    .def(py::init<Digraph const&>())
-    .def(py::init<Digraph const&,Components const&>())    
+    .def(py::init<Digraph const&>(), py::call_guard<py::gil_scoped_release>())
+    .def(py::init<Digraph const&,Components const&>(), py::call_guard<py::gil_scoped_release>())
     //.def("assign", (void(MorseDecomposition::*)(std::shared_ptr<Digraph>))&Complex::assign)
     //.def("assign", (void(MorseDecomposition::*)(std::shared_ptr<Digraph>,std::shared_ptr<Components>))&Complex::assign)    
     .def("poset", &MorseDecomposition::poset)
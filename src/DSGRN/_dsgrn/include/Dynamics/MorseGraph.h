@@ -73,6 +73,19 @@ public:
   MorseGraph &
   parse ( std::string const& str );
 
+  /// serialize
+  ///   Return a compact binary description: the children of each vertex
+  ///   in the Hasse diagram followed by its annotations
+  ///   (see Tools/serialization.hpp). Like stringify, equal Morse graphs
+  ///   give equal descriptions, so it can serve as a dictionary key.
+  std::string
+  serialize ( void ) const;
+
+  /// deserialize
+  ///   Initialize from a binary description returned by serialize
+  MorseGraph &
+  deserialize ( std::string const& bytes );
+
   /// graphviz
   ///   Return a graphviz representation of the Morse graph
   std::string
@@ -107,25 +120,32 @@ MorseGraphBinding (py::module &m) {
   py::class_<MorseGraph, std::shared_ptr<MorseGraph>>(m, "MorseGraph")
     .def(py::init<>())
     .def(py::init<Poset const&,std::unordered_map<uint64_t,Annotation>>())
-    .def(py::init<TypedObject const&,TypedObject const&>())
-    .def(py::init<TypedObject const&>())
-    .def("assign", &MorseGraph::assign)
+    .def(py::init<TypedObject const&,TypedObject const&>(), py::call_guard<py::gil_scoped_release>())
+    .def(py::init<TypedObject const&>(), py::call_guard<py::gil_scoped_release>())
+    .def("assign", &MorseGraph::assign, py::call_guard<py::gil_scoped_release>())
     .def("poset", &MorseGraph::poset)
     .def("annotation", &MorseGraph::annotation)
     .def("SHA256", &MorseGraph::SHA256)
     .def("__str__", &MorseGraph::stringify)
     .def("stringify", &MorseGraph::stringify)
     .def("parse", &MorseGraph::parse)
+    .def("serialize", [](MorseGraph const& mg) { return py::bytes ( mg . serialize () ); })
+    .def("deserialize", &MorseGraph::deserialize)
     .def("graphviz", &MorseGraph::graphviz)
     .def(py::pickle(
     [](MorseGraph const& p) { // __getstate__
         /* Return a tuple that fully encodes the state of the object */
-        return py::make_tuple(p.poset(), p.annotations());
+        return py::make_tuple(py::bytes(p.serialize()));
     },
     [](py::tuple t) { // __setstate__
-        if (t.size() != 2)
-            throw std::runtime_error("Unpickling MorseGraph object: Invalid state!");
         /* Create a new C++ instance */
-        return MorseGraph(t[0].cast<Poset>(), t[1].cast<std::unordered_map<uint64_t, Annotation>>());
+        if (t.size() == 1) {
+            MorseGraph mg;
+            mg.deserialize(t[0].cast<std::string>());
+            return mg;
+        } else if (t.size() == 2) { // state pickled by earlier versions
+            return MorseGraph(t[0].cast<Poset>(), t[1].cast<std::unordered_map<uint64_t, Annotation>>());
+        }
+        throw std::runtime_error("Unpickling MorseGraph object: Invalid state!");
     }));
 }
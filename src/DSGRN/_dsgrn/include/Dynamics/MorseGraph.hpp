@@ -10,6 +10,8 @@
 
 #include "MorseGraph.h"
 
+#include "Tools/serialization.hpp"
+
 INLINE_IF_HEADER_ONLY MorseGraph::
 MorseGraph ( void ) {
   data_ . reset ( new MorseGraph_ );
@@ -116,13 +118,53 @@ stringify ( void ) const {
 INLINE_IF_HEADER_ONLY MorseGraph & MorseGraph::
 parse ( std::string const& str ) {
   json mg = json::parse(str);
-  data_ -> poset_ . parse ( json::stringify ( mg["poset"] )); //TODO: inefficient
+  std::vector<std::vector<uint64_t>> adjacencies;
+  for ( auto const& adjlist : mg["poset"] ) {
+    adjacencies . push_back ( adjlist . get<std::vector<uint64_t>> () );
+  }
+  data_ -> poset_ . assign ( adjacencies );
   data_ -> annotations_ . clear ();
-  json annotation_array = mg["annotations"];
+  json const& annotation_array = mg["annotations"];
   uint64_t N = annotation_array . size ();
   for ( uint64_t v = 0; v < N; ++ v ) {
-    data_ -> annotations_ [ v ] . parse ( json::stringify ( annotation_array[v] )); //TODO: inefficient
+    Annotation & annotation = data_ -> annotations_ [ v ];
+    for ( json const& label : annotation_array[v] ) annotation . append ( label . get<std::string> () );
+  }
+  return *this;
+}
+
+INLINE_IF_HEADER_ONLY std::string MorseGraph::
+serialize ( void ) const {
+  dsgrn::BinaryWriter writer ( 'M' );
+  uint64_t N = data_ -> poset_ . size ();
+  writer . integer ( N );
+  for ( uint64_t v = 0; v < N; ++ v ) {
+    writer . integers ( data_ -> poset_ . children ( v ) );
+    Annotation const a = annotation ( v );
+    writer . integer ( a . size () );
+    for ( std::string const& label : a ) writer . string ( label );
   }
+  return writer . bytes ();
+}
+
+INLINE_IF_HEADER_ONLY MorseGraph & MorseGraph::
+deserialize ( std::string const& bytes ) {
+  dsgrn::BinaryReader reader ( bytes, 'M', "MorseGraph::deserialize" );
+  uint64_t N = reader . integer ();
+  std::vector<std::vector<uint64_t>> adjacencies;
+  std::unordered_map<uint64_t, Annotation> annotations;
+  for ( uint64_t v = 0; v < N; ++ v ) {
+    adjacencies . push_back ( reader . integers () );
+    for ( uint64_t u : adjacencies . back () ) {
+      if ( u >= N ) throw std::runtime_error ( "MorseGraph::deserialize: vertex out of range" );
+    }
+    Annotation & annotation = annotations [ v ];
+    uint64_t labels = reader . integer ();
+    for ( uint64_t i = 0; i < labels; ++ i ) annotation . append ( reader . string () );
+  }
+  reader . finish ();
+  data_ -> poset_ . assign ( adjacencies );
+  data_ -> annotations_ = annotations;
   return *this;
 }
 
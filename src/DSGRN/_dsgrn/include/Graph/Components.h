@@ -116,6 +116,24 @@ public:
   uint64_t
   whichComponent ( uint64_t i ) const;
   
+  /// vertices
+  ///   Return all vertices, listed component by component
+  ///   in topological order
+  std::vector<uint64_t> const&
+  vertices ( void ) const;
+
+  /// offsets
+  ///   Return the positions in vertices() at which each component
+  ///   starts, followed by the number of vertices; component i
+  ///   is vertices()[offsets()[i]], ..., vertices()[offsets()[i+1]-1]
+  std::vector<uint64_t> const&
+  offsets ( void ) const;
+
+  /// whichComponents
+  ///   Return the component of each vertex
+  std::vector<uint64_t> const&
+  whichComponents ( void ) const;
+
   /// ptr
   uint64_t
   ptr ( void ) const {
@@ -156,6 +174,7 @@ struct Components_ {
 
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include "Tools/numpy.hpp"
 namespace py = pybind11;
 
 inline void
@@ -193,6 +212,21 @@ ComponentsBinding (py::module &m) {
     .def("recurrentComponents", &Components::recurrentComponents)
     .def("isRecurrent", &Components::isRecurrent)
     .def("whichComponent", &Components::whichComponent)
+    // numpy views of the underlying arrays (no per-element conversion)
+    .def("vertices_array", [](Components const& c) {
+      return dsgrn::numpy_view ( c . vertices () . data (), c . vertices () . size (), c );
+    })
+    .def("offsets_array", [](Components const& c) {
+      return dsgrn::numpy_view ( c . offsets () . data (), c . offsets () . size (), c );
+    })
+    .def("which_component_array", [](Components const& c) {
+      return dsgrn::numpy_view ( c . whichComponents () . data (), c . whichComponents () . size (), c );
+    })
+    .def("recurrent_array", [](Components const& c) {
+      std::vector<uint8_t> flags ( c . size () );
+      for ( uint64_t i = 0; i < c . size (); ++ i ) flags [ i ] = c . isRecurrent ( i );
+      return dsgrn::numpy_array ( std::move ( flags ) );
+    })
     .def("ptr", &Components::ptr)
     .def("__str__", [](Components * c){ std::stringstream ss; ss << *c; return ss.str(); });
 }
@@ -99,6 +99,21 @@ whichComponent ( uint64_t i ) const {
   return data_ -> which_component_ [ i ];
 }
 
+INLINE_IF_HEADER_ONLY std::vector<uint64_t> const& Components::
+vertices ( void ) const {
+  return data_ -> vertices_;
+}
+
+INLINE_IF_HEADER_ONLY std::vector<uint64_t> const& Components::
+offsets ( void ) const {
+  return data_ -> component_select_;
+}
+
+INLINE_IF_HEADER_ONLY std::vector<uint64_t> const& Components::
+whichComponents ( void ) const {
+  return data_ -> which_component_;
+}
+
 INLINE_IF_HEADER_ONLY std::ostream& 
 operator << ( std::ostream& stream, Components const& c ) {
   stream << "[";
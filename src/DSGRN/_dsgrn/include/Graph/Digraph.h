@@ -125,6 +125,7 @@ struct Digraph_ {
 
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include "Tools/numpy.hpp"
 namespace py = pybind11;
 
 inline void
@@ -133,6 +134,21 @@ DigraphBinding (py::module &m) {
     .def(py::init<>())
     .def(py::init<std::vector<std::vector<uint64_t>> const&>())
     .def("adjacencies", &Digraph::adjacencies)    
+    .def("adjacencies_array", [](Digraph const& g, uint64_t v) {
+      // A copy: the graph can still be edited, which would invalidate a view
+      return dsgrn::numpy_array ( std::vector<uint64_t> ( g . adjacencies ( v ) ) );
+    })
+    .def("csr", [](Digraph const& g) {
+      // Compressed sparse row form: the targets of vertex v are
+      // targets[offsets[v]:offsets[v+1]]
+      std::vector<uint64_t> offsets ( 1, 0 );
+      std::vector<uint64_t> targets;
+      for ( uint64_t v = 0; v < g . size (); ++ v ) {
+        targets . insert ( targets . end (), g . adjacencies ( v ) . begin (), g . adjacencies ( v ) . end () );
+        offsets . push_back ( targets . size () );
+      }
+      return py::make_tuple ( dsgrn::numpy_array ( std::move ( offsets ) ), dsgrn::numpy_array ( std::move ( targets ) ) );
+    })
     .def("size", &Digraph::size)
     .def("resize", &Digraph::resize)
     .def("add_vertex", &Digraph::add_vertex)      
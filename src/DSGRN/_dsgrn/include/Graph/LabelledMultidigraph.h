@@ -7,14 +7,60 @@
 
 #include "common.h"
 
+#include <atomic>
+#include <mutex>
+#include <numeric>
+
+/// LabelledMultidigraph
+///   Directed multigraph with labelled edges. add_edge appends new edges
+///   to a pending list; finalize sorts them, drops duplicates and merges
+///   them into a single array in which the out-edges of each vertex are
+///   contiguous and sorted by (label, target). "edges" returns views of
+///   that array. The first read after a modification (edges, num_edges,
+///   adjacencies, ...) finalizes the graph under an internal lock, so a
+///   graph may be read by several threads; calling finalize at the end of
+///   the construction only does that work up front.
 class LabelledMultidigraph {
 public:
 
   typedef char LabelType;
 
+  /// Edge
+  ///   (label, target) pair
+  typedef std::pair<LabelType, uint64_t> Edge;
+
+  /// EdgeRange
+  ///   Non-owning view of a contiguous range of out-edges
+  class EdgeRange {
+  public:
+    EdgeRange ( Edge const* begin, Edge const* end ) : begin_(begin), end_(end) {}
+    Edge const* begin ( void ) const { return begin_; }
+    Edge const* end ( void ) const { return end_; }
+    uint64_t size ( void ) const { return end_ - begin_; }
+    bool empty ( void ) const { return begin_ == end_; }
+  private:
+    Edge const* begin_;
+    Edge const* end_;
+  };
+
   /// LabelledMultidigraph
   LabelledMultidigraph ( void );
 
+  /// LabelledMultidigraph
+  ///   Copy (the copied graph is finalized first)
+  LabelledMultidigraph ( LabelledMultidigraph const& other );
+
+  /// LabelledMultidigraph
+  LabelledMultidigraph ( LabelledMultidigraph && other );
+
+  /// operator =
+  LabelledMultidigraph &
+  operator = ( LabelledMultidigraph const& other );
+
+  /// operator =
+  LabelledMultidigraph &
+  operator = ( LabelledMultidigraph && other );
+
   /// add_vertex
   uint64_t
   add_vertex ( void );
@@ -23,15 +69,45 @@ public:
   void
   add_edge ( uint64_t i, uint64_t j, LabelType l );
 
+  /// finalize
+  ///   Build the compact adjacency array read by "edges" (otherwise
+  ///   built by the first read after a modification)
+  void
+  finalize ( void );
+
+  /// finalized
+  ///   Return true if the graph has not been modified since finalize
+  bool
+  finalized ( void ) const;
+
   /// num_vertices
   uint64_t
   num_vertices ( void ) const;
 
+  /// num_edges
+  ///   Return the number of distinct edges
+  uint64_t
+  num_edges ( void ) const;
+
+  /// edges
+  ///   Return out-edges of v, sorted by (label, target), without copying.
+  ///   The range is valid until the graph is modified.
+  EdgeRange
+  edges ( uint64_t v ) const;
+
+  /// edges
+  ///   Return out-edges of v with label l, sorted by target, without copying.
+  EdgeRange
+  edges ( uint64_t v, LabelType l ) const;
+
   /// adjacencies
-  std::map<LabelType, std::unordered_set<uint64_t>> const&
+  ///   Return a map from labels to targets of out-edges of v, built from
+  ///   "edges (v)" (which does not copy)
+  std::map<LabelType, std::unordered_set<uint64_t>>
   adjacencies( uint64_t v ) const;
 
   /// unlabelled_adjacencies
+  ///   Return targets of out-edges of v
   std::unordered_set<uint64_t>
   unlabelled_adjacencies( uint64_t v ) const;
 
@@ -39,8 +115,29 @@ public:
   std::string 
   graphviz ( void ) const;
 
+protected:
+  /// for_each_edge
+  ///   Call f(source, edge) for each edge, in the order of the edge array
+  template < class F > void
+  for_each_edge ( F const& f ) const;
+
 private:
-  std::vector<std::map<LabelType, std::unordered_set<uint64_t>>> adj_;
+  typedef std::pair<uint64_t, Edge> SourcedEdge;
+  uint64_t num_vertices_;
+  // Edges added since the last finalize, as (source, (label, target)).
+  // They and the edge array are rebuilt by _finalize, which const reads
+  // call: it holds mutex_ and sets finalized_ once it is done.
+  mutable std::atomic<bool> finalized_;
+  mutable std::mutex mutex_;
+  mutable std::vector<SourcedEdge> pending_;
+  // Out-edges of v are edges_[offsets_[v]] ... edges_[offsets_[v+1]-1]
+  mutable std::vector<uint64_t> offsets_;
+  mutable std::vector<Edge> edges_;
+
+  /// _finalize
+  ///   Merge the pending edges into the edge array, if there are any
+  void
+  _finalize ( void ) const;
 };
 
 /// Python Bindings
@@ -51,11 +148,20 @@ namespace py = pybind11;
 
 inline void
 LabelledMultidigraphBinding (py::module &m) {
+  typedef LabelledMultidigraph::EdgeRange EdgeRange;
+  py::class_<EdgeRange>(m, "EdgeRange")
+    .def("__len__", &EdgeRange::size)
+    .def("__iter__", [](EdgeRange const& r) { return py::make_iterator(r.begin(), r.end()); }, py::keep_alive<0,1>());
   py::class_<LabelledMultidigraph, std::shared_ptr<LabelledMultidigraph>>(m, "LabelledMultidigraph")
     .def(py::init<>())
     .def("add_vertex", &LabelledMultidigraph::add_vertex)
     .def("add_edge", &LabelledMultidigraph::add_edge)
+    .def("finalize", &LabelledMultidigraph::finalize)
+    .def("finalized", &LabelledMultidigraph::finalized)
     .def("num_vertices", &LabelledMultidigraph::num_vertices)
+    .def("num_edges", &LabelledMultidigraph::num_edges)
+    .def("edges", (EdgeRange (LabelledMultidigraph::*)(uint64_t) const) &LabelledMultidigraph::edges, py::keep_alive<0,1>())
+    .def("edges", (EdgeRange (LabelledMultidigraph::*)(uint64_t, LabelledMultidigraph::LabelType) const) &LabelledMultidigraph::edges, py::keep_alive<0,1>())
     .def("adjacencies", &LabelledMultidigraph::adjacencies)
     .def("unlabelled_adjacencies", &LabelledMultidigraph::unlabelled_adjacencies)
     .def("graphviz", &LabelledMultidigraph::graphviz);
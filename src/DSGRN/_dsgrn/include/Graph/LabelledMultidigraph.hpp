@@ -6,38 +6,152 @@
 #include "LabelledMultidigraph.h"
 
 inline
-LabelledMultidigraph::LabelledMultidigraph ( void ) {}
+LabelledMultidigraph::LabelledMultidigraph ( void ) : num_vertices_(0), finalized_(true), offsets_(1, 0) {}
+
+inline
+LabelledMultidigraph::LabelledMultidigraph ( LabelledMultidigraph const& other ) : finalized_(true) {
+  *this = other;
+}
+
+inline
+LabelledMultidigraph::LabelledMultidigraph ( LabelledMultidigraph && other ) : finalized_(true) {
+  *this = std::move(other);
+}
+
+inline LabelledMultidigraph &
+LabelledMultidigraph::operator = ( LabelledMultidigraph const& other ) {
+  if ( this == &other ) return *this;
+  other._finalize();
+  num_vertices_ = other.num_vertices_;
+  pending_.clear();
+  offsets_ = other.offsets_;
+  edges_ = other.edges_;
+  finalized_ = true;
+  return *this;
+}
+
+inline LabelledMultidigraph &
+LabelledMultidigraph::operator = ( LabelledMultidigraph && other ) {
+  if ( this == &other ) return *this;
+  num_vertices_ = other.num_vertices_;
+  pending_ = std::move(other.pending_);
+  offsets_ = std::move(other.offsets_);
+  edges_ = std::move(other.edges_);
+  finalized_ = other.finalized_.load();
+  other.num_vertices_ = 0;
+  other.pending_.clear();
+  other.offsets_.assign(1, 0);
+  other.edges_.clear();
+  other.finalized_ = true;
+  return *this;
+}
 
 inline uint64_t 
 LabelledMultidigraph::add_vertex ( void ) {
-  adj_ . push_back ( std::map<LabelType, std::unordered_set<uint64_t>>());
-  return adj_.size() - 1;
+  finalized_ = false;
+  return num_vertices_ ++;
 }
 
 inline void 
 LabelledMultidigraph::add_edge ( uint64_t i, uint64_t j, LabelledMultidigraph::LabelType l ) {
-  adj_[i][l].insert(j);
+  if ( i >= num_vertices_ || j >= num_vertices_ ) throw std::invalid_argument("LabelledMultidigraph::add_edge: vertex out of range");
+  pending_.push_back(SourcedEdge(i, Edge(l, j)));
+  finalized_ = false;
 } 
 
+inline void
+LabelledMultidigraph::finalize ( void ) {
+  _finalize();
+}
+
+inline void
+LabelledMultidigraph::_finalize ( void ) const {
+  if ( finalized_ ) return;
+  std::lock_guard<std::mutex> lock ( mutex_ );
+  if ( finalized_ ) return;
+  // Sort the pending edges by (source, label, target) and merge them
+  // with the edge array, which is already in that order
+  std::sort(pending_.begin(), pending_.end());
+  std::vector<SourcedEdge> sourced;
+  sourced.reserve(edges_.size() + pending_.size());
+  auto p = pending_.begin();
+  for ( uint64_t v = 0; v + 1 < offsets_.size(); ++ v ) {
+    for ( uint64_t k = offsets_[v]; k < offsets_[v+1]; ++ k ) {
+      SourcedEdge e ( v, edges_[k] );
+      while ( p != pending_.end() && *p < e ) sourced.push_back(*p++);
+      sourced.push_back(e);
+    }
+  }
+  sourced.insert(sourced.end(), p, pending_.end());
+  sourced.erase(std::unique(sourced.begin(), sourced.end()), sourced.end());
+  offsets_.assign(num_vertices_ + 1, 0);
+  edges_.clear();
+  edges_.reserve(sourced.size());
+  for ( auto const& e : sourced ) {
+    ++ offsets_[e.first + 1];
+    edges_.push_back(e.second);
+  }
+  std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+  std::vector<SourcedEdge> ().swap(pending_);
+  finalized_ = true;
+}
+
+inline bool
+LabelledMultidigraph::finalized ( void ) const {
+  return finalized_;
+}
+
 inline uint64_t
 LabelledMultidigraph::num_vertices ( void ) const {
-  return adj_.size();
+  return num_vertices_;
+}
+
+inline uint64_t
+LabelledMultidigraph::num_edges ( void ) const {
+  _finalize();
+  return edges_.size();
+}
+
+inline LabelledMultidigraph::EdgeRange
+LabelledMultidigraph::edges ( uint64_t v ) const {
+  if ( v >= num_vertices_ ) throw std::invalid_argument("LabelledMultidigraph::edges: vertex out of range");
+  _finalize();
+  return EdgeRange(edges_.data() + offsets_[v], edges_.data() + offsets_[v+1]);
+}
+
+inline LabelledMultidigraph::EdgeRange
+LabelledMultidigraph::edges ( uint64_t v, LabelledMultidigraph::LabelType l ) const {
+  EdgeRange all = edges(v);
+  auto compare_label = [](Edge const& lhs, Edge const& rhs) { return lhs.first < rhs.first; };
+  Edge key ( l, 0 );
+  auto range = std::equal_range(all.begin(), all.end(), key, compare_label);
+  return EdgeRange(range.first, range.second);
 }
 
-inline std::map<LabelledMultidigraph::LabelType, std::unordered_set<uint64_t>> const&
+inline std::map<LabelledMultidigraph::LabelType, std::unordered_set<uint64_t>>
 LabelledMultidigraph::adjacencies ( uint64_t v ) const {
-  if ( v >= adj_.size() ) throw std::invalid_argument("LabelledMultidigraph::adjacencies: vertex out of range");
-  return adj_[v];
+  if ( v >= num_vertices_ ) throw std::invalid_argument("LabelledMultidigraph::adjacencies: vertex out of range");
+  std::map<LabelType, std::unordered_set<uint64_t>> result;
+  for ( auto const& e : edges(v) ) result[e.first].insert(e.second);
+  return result;
 }
 
 inline std::unordered_set<uint64_t> LabelledMultidigraph::
 unlabelled_adjacencies( uint64_t v ) const {
-  auto adj = adjacencies(v);
+  if ( v >= num_vertices_ ) throw std::invalid_argument("LabelledMultidigraph::unlabelled_adjacencies: vertex out of range");
   std::unordered_set<uint64_t> result;
-  for ( auto x : adj ) result.insert(x.second.begin(),x.second.end());
+  for ( auto const& e : edges(v) ) result.insert(e.second);
   return result;
 }
 
+template < class F > void
+LabelledMultidigraph::for_each_edge ( F const& f ) const {
+  _finalize();
+  for ( uint64_t i = 0; i + 1 < offsets_.size(); ++ i ) {
+    for ( uint64_t k = offsets_[i]; k < offsets_[i+1]; ++ k ) f(i, edges_[k]);
+  }
+}
+
 inline std::string 
 LabelledMultidigraph::graphviz ( void ) const {
   std::stringstream ss;
@@ -45,13 +159,9 @@ LabelledMultidigraph::graphviz ( void ) const {
   for ( uint64_t i = 0; i < num_vertices(); ++ i ) {
     ss << i << " [label=\"" << i << "\"];\n";
   }
-  for ( uint64_t i = 0; i < num_vertices(); ++ i ) {
-    for ( auto label_set : adjacencies(i) ) {
-      auto label = label_set.first;
-      auto set = label_set.second;
-      for ( auto j : set ) ss << i << " -> " << j << "[label=\"" << label << "\"]\n";
-    }
-  }
+  for_each_edge([&](uint64_t i, Edge const& e) {
+    ss << i << " -> " << e.second << "[label=\"" << e.first << "\"]\n";
+  });
   ss << "}\n";
   return ss.str();
 }
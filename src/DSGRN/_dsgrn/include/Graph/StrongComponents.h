@@ -20,5 +20,5 @@ namespace py = pybind11;
 
 inline
 void StrongComponentsBinding(py::module &m) {
-  m.def("StrongComponents", &StrongComponents);
+  m.def("StrongComponents", &StrongComponents, py::call_guard<py::gil_scoped_release>());
 }
@@ -0,0 +1,147 @@
+/// CADDatabase.h
+/// Shaun Harker
+/// 2018-11-12
+/// MIT LICENSE
+
+#pragma once
+
+#include "common.h"
+
+struct CADDatabase_;
+
+/// CADDatabase
+///   Sample instances of the parameter inequalities for every logic
+///   parameter of a network node type (n inputs, m outputs, logic structure),
+///   indexed by logic index, i.e. the position of the hex code in the
+///   corresponding logic .dat file.
+///   The instance of each logic parameter is a record of 2n+m doubles
+///     L[1], ..., L[n], U[1], ..., U[n], T[1], ..., T[m]
+///   Databases can be read from the CAD .json files or from the binary
+///   format written by "save". The binary format is
+///     char     magic[8]           "DSGRNCAD"
+///     uint64_t byte_order         0x0102030405060708
+///     uint64_t version            1
+///     uint64_t n, m, N, digits    inputs, outputs, number of records, hex code length
+///     uint64_t hexcodes[N]        hex code of each logic index, as an integer
+///     uint64_t sorted[N]          logic indices in order of increasing hex code
+///     double   records[N][2n+m]   instance of each logic index
+///   in native byte order. Binary files are memory-mapped where the platform
+///   allows it, so only the pages holding records which are actually used
+///   are read, and processes loading the same file share its pages.
+///   The binary files shipped in Resources/CAD are generated from the JSON
+///   files by Resources/CAD/MakeCAD.py.
+class CADDatabase {
+public:
+  /// CADDatabase
+  CADDatabase ( void );
+
+  /// CADDatabase
+  ///   Load from a .json or binary CAD database file
+  CADDatabase ( std::string const& filename );
+
+  /// assign
+  ///   Load from a .json or binary CAD database file.
+  ///   Files with a ".json" extension are parsed as JSON; all others are
+  ///   expected to be binary.
+  void
+  assign ( std::string const& filename );
+
+  /// save
+  ///   Write the database in binary format
+  void
+  save ( std::string const& filename ) const;
+
+  /// size
+  ///   Return the number of records (i.e. logic parameters)
+  uint64_t
+  size ( void ) const;
+
+  /// inputs
+  ///   Return the number of inputs n of the network node type
+  uint64_t
+  inputs ( void ) const;
+
+  /// outputs
+  ///   Return the number of outputs m of the network node type
+  uint64_t
+  outputs ( void ) const;
+
+  /// variables
+  ///   Return the names of the 2n+m variables of a record, in order
+  std::vector<std::string>
+  variables ( void ) const;
+
+  /// hex
+  ///   Return the hex code of the logic parameter with logic index i
+  std::string
+  hex ( uint64_t i ) const;
+
+  /// index
+  ///   Return the logic index of the logic parameter with hex code "hex".
+  ///   Throws std::out_of_range if there is no such record.
+  uint64_t
+  index ( std::string const& hex ) const;
+
+  /// instance
+  ///   Return a pointer to the 2n+m values of the record with logic index i
+  double const*
+  instance ( uint64_t i ) const;
+
+  /// operator <<
+  ///   Stream out information about the database
+  friend std::ostream& operator << ( std::ostream& stream, CADDatabase const& cad );
+
+private:
+  std::shared_ptr<CADDatabase_> data_;
+};
+
+struct CADDatabase_ {
+  uint64_t inputs_;
+  uint64_t outputs_;
+  uint64_t size_;
+  uint64_t digits_;
+  // The whole database in binary format, either held in "buffer_" or
+  // memory-mapped (in which case "mapping_" owns the mapping)
+  std::vector<char> buffer_;
+  std::shared_ptr<void const> mapping_;
+  char const* bytes_;
+  uint64_t num_bytes_;
+  uint64_t const* hexcodes_;
+  uint64_t const* sorted_;
+  double const* records_;
+};
+
+/// LoadCADDatabase
+///   Return the CAD database stored at "path" + ".cad", or failing that at
+///   "path" + ".json". A binary file whose header does not match (e.g. one
+///   written on a machine of the other byte order) is skipped if the JSON
+///   file exists. Databases are cached, so samplers constructed in the
+///   same process share them.
+CADDatabase
+LoadCADDatabase ( std::string const& path );
+
+/// Python Bindings
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+namespace py = pybind11;
+
+inline void
+CADDatabaseBinding (py::module &m) {
+  py::class_<CADDatabase, std::shared_ptr<CADDatabase>>(m, "CADDatabase")
+    .def(py::init<>())
+    .def(py::init<std::string const&>())
+    .def("save", &CADDatabase::save)
+    .def("size", &CADDatabase::size)
+    .def("inputs", &CADDatabase::inputs)
+    .def("outputs", &CADDatabase::outputs)
+    .def("variables", &CADDatabase::variables)
+    .def("hex", &CADDatabase::hex)
+    .def("index", &CADDatabase::index)
+    .def("instance", [](CADDatabase const& cad, uint64_t i) {
+      double const* record = cad . instance ( i );
+      return std::vector<double> ( record, record + 2 * cad . inputs () + cad . outputs () );
+    })
+    .def("__str__", [](CADDatabase * cad){ std::stringstream ss; ss << *cad; return ss.str(); });
+  m.def("LoadCADDatabase", &LoadCADDatabase);
+}
@@ -0,0 +1,285 @@
+/// CADDatabase.hpp
+/// Shaun Harker
+/// 2018-11-12
+/// MIT LICENSE
+
+#pragma once
+
+#ifndef INLINE_IF_HEADER_ONLY
+#define INLINE_IF_HEADER_ONLY
+#endif
+
+#include "CADDatabase.h"
+
+#include <cstring>
+#include <mutex>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace CADDatabase_detail {
+  static const char magic [ 8 ] = { 'D', 'S', 'G', 'R', 'N', 'C', 'A', 'D' };
+  static const uint64_t byte_order = 0x0102030405060708ULL;
+  static const uint64_t version = 1;
+  // magic, byte order, version, n, m, N, digits
+  static const uint64_t header_size = 8 + 6 * sizeof(uint64_t);
+
+  /// hexvalue
+  ///   Return the integer value of a hex code, or false if it is not one
+  inline bool
+  hexvalue ( std::string const& hex, uint64_t * value ) {
+    if ( hex . empty () || hex . size () > 16 ) return false;
+    *value = 0;
+    for ( char c : hex ) {
+      uint64_t digit;
+      if ( c >= '0' && c <= '9' ) digit = c - '0';
+      else if ( c >= 'A' && c <= 'F' ) digit = c - 'A' + 10;
+      else return false;
+      *value = ( *value << 4 ) | digit;
+    }
+    return true;
+  }
+
+  /// serialize
+  ///   Return the binary format of a database
+  inline std::vector<char>
+  serialize ( uint64_t n, uint64_t m, uint64_t digits,
+              std::vector<uint64_t> const& hexcodes,
+              std::vector<double> const& records ) {
+    uint64_t N = hexcodes . size ();
+    std::vector<uint64_t> sorted ( N );
+    for ( uint64_t i = 0; i < N; ++ i ) sorted[i] = i;
+    std::sort ( sorted . begin (), sorted . end (), [&](uint64_t a, uint64_t b) {
+      return hexcodes[a] < hexcodes[b];
+    });
+    uint64_t header [ 6 ] = { byte_order, version, n, m, N, digits };
+    std::vector<char> bytes;
+    auto append = [&] ( void const* data, uint64_t size ) {
+      char const* begin = (char const*) data;
+      bytes . insert ( bytes . end (), begin, begin + size );
+    };
+    append ( magic, sizeof(magic) );
+    append ( header, sizeof(header) );
+    append ( hexcodes . data (), N * sizeof(uint64_t) );
+    append ( sorted . data (), N * sizeof(uint64_t) );
+    append ( records . data (), records . size () * sizeof(double) );
+    return bytes;
+  }
+}
+
+INLINE_IF_HEADER_ONLY CADDatabase::
+CADDatabase ( void ) {
+  data_ . reset ( new CADDatabase_ );
+  data_ -> inputs_ = 0;
+  data_ -> outputs_ = 0;
+  data_ -> size_ = 0;
+  data_ -> digits_ = 0;
+  data_ -> bytes_ = nullptr;
+  data_ -> num_bytes_ = 0;
+  data_ -> hexcodes_ = nullptr;
+  data_ -> sorted_ = nullptr;
+  data_ -> records_ = nullptr;
+}
+
+INLINE_IF_HEADER_ONLY CADDatabase::
+CADDatabase ( std::string const& filename ) {
+  assign ( filename );
+}
+
+INLINE_IF_HEADER_ONLY void CADDatabase::
+assign ( std::string const& filename ) {
+  using namespace CADDatabase_detail;
+  data_ . reset ( new CADDatabase_ );
+  bool is_json = filename . size () >= 5 && filename . substr ( filename . size () - 5 ) == ".json";
+  if ( is_json ) {
+    std::ifstream infile ( filename );
+    if ( not infile . good () ) {
+      throw std::runtime_error("Missing CAD database " + filename );
+    }
+    json J;
+    infile >> J;
+    uint64_t n = 0, m = 0, digits = 0;
+    if ( not J . empty () ) {
+      for ( json::iterator it = J[0]["Instance"] . begin (); it != J[0]["Instance"] . end (); ++ it ) {
+        if ( it . key () [ 0 ] == 'L' ) ++ n;
+        if ( it . key () [ 0 ] == 'T' ) ++ m;
+      }
+      digits = J[0]["Hex"] . get<std::string> () . size ();
+    }
+    std::vector<std::string> names;
+    for ( uint64_t i = 0; i < n; ++ i ) names . push_back ( "L[" + std::to_string(i+1) + "]" );
+    for ( uint64_t i = 0; i < n; ++ i ) names . push_back ( "U[" + std::to_string(i+1) + "]" );
+    for ( uint64_t i = 0; i < m; ++ i ) names . push_back ( "T[" + std::to_string(i+1) + "]" );
+    std::vector<uint64_t> hexcodes;
+    std::vector<double> records;
+    for ( auto const& entry : J ) {
+      std::string hex = entry["Hex"];
+      uint64_t value;
+      if ( hex . size () != digits || not hexvalue ( hex, &value ) ) {
+        throw std::runtime_error("CADDatabase::assign: bad hex code " + hex + " in " + filename );
+      }
+      hexcodes . push_back ( value );
+      auto const& instance = entry["Instance"];
+      if ( instance . size () != names . size () ) {
+        throw std::runtime_error("CADDatabase::assign: inconsistent instance for hex code " + hex + " in " + filename );
+      }
+      for ( auto const& name : names ) records . push_back ( instance . at ( name ) . get<double> () );
+    }
+    data_ -> buffer_ = serialize ( n, m, digits, hexcodes, records );
+    data_ -> bytes_ = data_ -> buffer_ . data ();
+    data_ -> num_bytes_ = data_ -> buffer_ . size ();
+  } else {
+#if defined(__unix__) || defined(__APPLE__)
+    int fd = ::open ( filename . c_str (), O_RDONLY );
+    if ( fd == -1 ) {
+      throw std::runtime_error("Missing CAD database " + filename );
+    }
+    struct stat st;
+    void * address = MAP_FAILED;
+    uint64_t num_bytes = 0;
+    if ( ::fstat ( fd, &st ) == 0 && st . st_size > 0 ) {
+      num_bytes = st . st_size;
+      address = ::mmap ( nullptr, num_bytes, PROT_READ, MAP_SHARED, fd, 0 );
+    }
+    ::close ( fd );
+    if ( address != MAP_FAILED ) {
+      data_ -> mapping_ . reset ( address, [num_bytes] ( void const* p ) { ::munmap ( (void *) p, num_bytes ); } );
+      data_ -> bytes_ = (char const*) address;
+      data_ -> num_bytes_ = num_bytes;
+    }
+#endif
+    if ( not data_ -> mapping_ ) {
+      std::ifstream infile ( filename, std::ios::binary );
+      if ( not infile . good () ) {
+        throw std::runtime_error("Missing CAD database " + filename );
+      }
+      data_ -> buffer_ . assign ( std::istreambuf_iterator<char> ( infile ), std::istreambuf_iterator<char> () );
+      data_ -> bytes_ = data_ -> buffer_ . data ();
+      data_ -> num_bytes_ = data_ -> buffer_ . size ();
+    }
+  }
+  // Validate the header and locate the tables
+  char const* bytes = data_ -> bytes_;
+  uint64_t const* header = (uint64_t const*) ( bytes + sizeof(magic) );
+  if ( data_ -> num_bytes_ < header_size || std::memcmp ( bytes, magic, sizeof(magic) ) != 0 ) {
+    throw std::runtime_error("CADDatabase::assign: " + filename + " is not a CAD database");
+  }
+  if ( header[0] != byte_order || header[1] != version ) {
+    throw std::runtime_error("CADDatabase::assign: " + filename + " has an unsupported version or byte order");
+  }
+  data_ -> inputs_ = header[2];
+  data_ -> outputs_ = header[3];
+  data_ -> size_ = header[4];
+  data_ -> digits_ = header[5];
+  uint64_t N = data_ -> size_;
+  uint64_t V = 2 * data_ -> inputs_ + data_ -> outputs_;
+  if ( data_ -> num_bytes_ != header_size + N * ( 2 + V ) * sizeof(uint64_t) ) {
+    throw std::runtime_error("CADDatabase::assign: " + filename + " is truncated");
+  }
+  data_ -> hexcodes_ = (uint64_t const*) ( bytes + header_size );
+  data_ -> sorted_ = data_ -> hexcodes_ + N;
+  data_ -> records_ = (double const*) ( data_ -> sorted_ + N );
+}
+
+INLINE_IF_HEADER_ONLY void CADDatabase::
+save ( std::string const& filename ) const {
+  std::ofstream outfile ( filename, std::ios::binary );
+  outfile . write ( data_ -> bytes_, data_ -> num_bytes_ );
+  if ( not outfile . good () ) {
+    throw std::runtime_error("CADDatabase::save: could not write " + filename );
+  }
+}
+
+INLINE_IF_HEADER_ONLY uint64_t CADDatabase::
+size ( void ) const {
+  return data_ -> size_;
+}
+
+INLINE_IF_HEADER_ONLY uint64_t CADDatabase::
+inputs ( void ) const {
+  return data_ -> inputs_;
+}
+
+INLINE_IF_HEADER_ONLY uint64_t CADDatabase::
+outputs ( void ) const {
+  return data_ -> outputs_;
+}
+
+INLINE_IF_HEADER_ONLY std::vector<std::string> CADDatabase::
+variables ( void ) const {
+  std::vector<std::string> result;
+  for ( uint64_t i = 0; i < inputs (); ++ i ) result . push_back ( "L[" + std::to_string(i+1) + "]" );
+  for ( uint64_t i = 0; i < inputs (); ++ i ) result . push_back ( "U[" + std::to_string(i+1) + "]" );
+  for ( uint64_t i = 0; i < outputs (); ++ i ) result . push_back ( "T[" + std::to_string(i+1) + "]" );
+  return result;
+}
+
+INLINE_IF_HEADER_ONLY std::string CADDatabase::
+hex ( uint64_t i ) const {
+  if ( i >= size () ) {
+    throw std::out_of_range("CADDatabase::hex: logic index out of range");
+  }
+  static const char digit [] = "0123456789ABCDEF";
+  std::string result ( data_ -> digits_, '0' );
+  uint64_t value = data_ -> hexcodes_ [ i ];
+  for ( uint64_t k = result . size (); k > 0 && value; -- k, value >>= 4 ) {
+    result [ k - 1 ] = digit [ value & 15 ];
+  }
+  return result;
+}
+
+INLINE_IF_HEADER_ONLY uint64_t CADDatabase::
+index ( std::string const& hex ) const {
+  uint64_t value;
+  if ( hex . size () == data_ -> digits_ && CADDatabase_detail::hexvalue ( hex, &value ) ) {
+    uint64_t const* hexcodes = data_ -> hexcodes_;
+    uint64_t const* it = std::lower_bound ( data_ -> sorted_, data_ -> sorted_ + size (), value,
+      [&] ( uint64_t i, uint64_t v ) { return hexcodes[i] < v; } );
+    if ( it != data_ -> sorted_ + size () && hexcodes[*it] == value ) return *it;
+  }
+  throw std::out_of_range("CADDatabase::index: no record for hex code " + hex );
+}
+
+INLINE_IF_HEADER_ONLY double const* CADDatabase::
+instance ( uint64_t i ) const {
+  if ( i >= size () ) {
+    throw std::out_of_range("CADDatabase::instance: logic index out of range");
+  }
+  return data_ -> records_ + i * ( 2 * inputs () + outputs () );
+}
+
+INLINE_IF_HEADER_ONLY std::ostream& operator << ( std::ostream& stream, CADDatabase const& cad ) {
+  stream << "(CADDatabase: " << cad.size() << " records, "
+         << cad.inputs() << " inputs, " << cad.outputs() << " outputs)";
+  return stream;
+}
+
+INLINE_IF_HEADER_ONLY CADDatabase
+LoadCADDatabase ( std::string const& path ) {
+  static std::mutex cache_mutex;
+  static std::unordered_map<std::string, CADDatabase> cache;
+  {
+    std::lock_guard<std::mutex> lock ( cache_mutex );
+    auto it = cache . find ( path );
+    if ( it != cache . end () ) return it -> second;
+  }
+  CADDatabase result;
+  bool loaded = false;
+  if ( std::ifstream ( path + ".cad" ) . good () ) {
+    // A binary file in another byte order or version of the format
+    // (or a damaged one) is passed over in favor of the JSON file
+    try {
+      result . assign ( path + ".cad" );
+      loaded = true;
+    } catch ( std::runtime_error & ) {
+      if ( not std::ifstream ( path + ".json" ) . good () ) throw;
+    }
+  }
+  if ( not loaded ) result . assign ( path + ".json" );
+  std::lock_guard<std::mutex> lock ( cache_mutex );
+  return cache . insert ( { path, result } ) . first -> second;
+}
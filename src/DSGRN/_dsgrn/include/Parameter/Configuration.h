@@ -10,24 +10,60 @@
 
 #include "common.h"
 
+#include <atomic>
+#include <mutex>
+
+/// Configuration
+///   The path and the labelling cache budgets may be read and set from
+///   any thread
 struct Configuration {
 public:
   Configuration ( void ) {
     path_ = "/usr/local/share/DSGRN/logic";
+    labelling_cache_bytes_ = 1LL << 26;
+    labelling_front_cache_bytes_ = 1LL << 22;
   }
   void set_path ( std::string const& path ) {
+    std::lock_guard<std::mutex> lock ( mutex_ );
     path_ = path;
   }
   std::string
   get_path ( void ) const {
+    std::lock_guard<std::mutex> lock ( mutex_ );
     return path_;
   }
 
+  /// set_labelling_cache_bytes
+  ///   Set the size past which the oldest planes are evicted from the
+  ///   labelling plane cache shared by all threads
+  ///   (see Parameter::cached_labelling). 0 disables the cache.
+  void set_labelling_cache_bytes ( uint64_t bytes ) {
+    labelling_cache_bytes_ = bytes;
+  }
+  uint64_t
+  get_labelling_cache_bytes ( void ) const {
+    return labelling_cache_bytes_;
+  }
+
+  /// set_labelling_front_cache_bytes
+  ///   Set the size of the front cache of recently used planes each
+  ///   thread reads without locking. 0 disables the front caches.
+  void set_labelling_front_cache_bytes ( uint64_t bytes ) {
+    labelling_front_cache_bytes_ = bytes;
+  }
+  uint64_t
+  get_labelling_front_cache_bytes ( void ) const {
+    return labelling_front_cache_bytes_;
+  }
+
 private:
   std::string path_;
+  std::atomic<uint64_t> labelling_cache_bytes_;
+  std::atomic<uint64_t> labelling_front_cache_bytes_;
+  mutable std::mutex mutex_;
 };
 
-std::shared_ptr<Configuration>
+inline std::shared_ptr<Configuration>
 configuration ( void ) {
   static std::shared_ptr<Configuration> global_config ( new Configuration );
   return global_config;
@@ -44,6 +80,10 @@ ConfigurationBinding (py::module &m) {
   py::class_<Configuration, std::shared_ptr<Configuration>>(m, "Configuration")
     .def(py::init<>())
     .def("set_path", &Configuration::set_path)
-    .def("get_path", &Configuration::get_path);
+    .def("get_path", &Configuration::get_path)
+    .def("set_labelling_cache_bytes", &Configuration::set_labelling_cache_bytes)
+    .def("get_labelling_cache_bytes", &Configuration::get_labelling_cache_bytes)
+    .def("set_labelling_front_cache_bytes", &Configuration::set_labelling_front_cache_bytes)
+    .def("get_labelling_front_cache_bytes", &Configuration::get_labelling_front_cache_bytes);
   m.def("configuration", &configuration);
 }
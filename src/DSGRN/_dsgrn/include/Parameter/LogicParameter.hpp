@@ -118,7 +118,7 @@ adjacencies ( void ) const {
   typedef std::vector<bitType> BitContainer;
   // Convert an hex char into a vector of bits (length 4)
   // standard order (right to left)
-  static std::unordered_map<char, BitContainer> hex_lookup =
+  static const std::unordered_map<char, BitContainer> hex_lookup =
     { { '0', {0,0,0,0} }, { '1', {0,0,0,1} }, { '2', {0,0,1,0} },
       { '3', {0,0,1,1} }, { '4', {0,1,0,0} }, { '5', {0,1,0,1} },
       { '6', {0,1,1,0} }, { '7', {0,1,1,1} }, { '8', {1,0,0,0} },
@@ -127,7 +127,7 @@ adjacencies ( void ) const {
       { 'F', {1,1,1,1} }
     };
   auto Hex2Bin = [&](char c) {
-    return hex_lookup[c];
+    return hex_lookup . at ( c );
   };
   //
   // convert a string of hex code into vector of bits.
@@ -6,8 +6,20 @@
 
 #include "common.h"
 
+#include <atomic>
+
 class Network_;
 
+namespace Network_detail {
+  /// next_id
+  ///   Return a number not returned before (see Network::id)
+  inline uint64_t
+  next_id ( void ) {
+    static std::atomic<uint64_t> counter ( 0 );
+    return counter ++;
+  }
+}
+
 /// Network
 ///   This class holds network data.
 ///     * Loads specification files
@@ -93,6 +105,13 @@ public:
   std::string
   specification ( void ) const;
 
+  /// id
+  ///   Return a number identifying the network data. Copies of a network
+  ///   share it; networks constructed, assigned or loaded separately have
+  ///   different ids, even if their specifications agree.
+  uint64_t
+  id ( void ) const;
+
   /// graphviz
   ///   Return a graphviz string (dot language)
   std::string
@@ -122,6 +141,8 @@ struct Network_ {
   std::vector<std::vector<std::vector<uint64_t>>> logic_by_index_;
   std::vector<bool> essential_;
   std::string specification_;
+  uint64_t id_;
+  Network_ ( void ) : id_ ( Network_detail::next_id () ) {}
 };
 
 /// Python Bindings
@@ -107,6 +107,11 @@ specification ( void ) const {
   return data_ -> specification_;
 }
 
+INLINE_IF_HEADER_ONLY uint64_t Network::
+id ( void ) const {
+  return data_ -> id_;
+}
+
 INLINE_IF_HEADER_ONLY std::string Network::
 graphviz ( std::vector<std::string> const& theme ) const {
   std::stringstream result;
@@ -10,9 +10,32 @@
 #include "Parameter/Network.h"
 #include "Parameter/LogicParameter.h"
 #include "Parameter/OrderParameter.h"
+#include "Tools/dimension.hpp"
 
 struct Parameter_;
 
+namespace Parameter_detail {
+  /// BoxFill
+  ///   OR "mask" into result[i] for each domain i in the box with
+  ///   coordinates lower[k] <= x[k] < upper[k], where moving +1 in
+  ///   dimension k adds jump[k] to the index (jump[0] = 1). Rows along
+  ///   dimension 0 are contiguous and filled by a plain loop.
+  template < uint64_t S >
+  struct BoxFill {
+    static void
+    run ( uint64_t dim, dsgrn::DimensionArray<0> const& lower,
+          dsgrn::DimensionArray<0> const& upper, dsgrn::DimensionArray<0> const& jump,
+          uint64_t mask, std::vector<uint64_t> & result );
+  };
+
+  /// BoxFillKernel
+  ///   BoxFill specialized on a dimension (see dsgrn::select_dimension).
+  ///   It is selected once per network, by ParameterGraph (for its
+  ///   parameters and views) or by Parameter::assign, and throws when
+  ///   called if the network has more than dsgrn::max_dimension nodes.
+  typedef dsgrn::DimensionKernel<BoxFill> BoxFillKernel;
+}
+
 class Parameter {
 public:
   /// Parameter
@@ -85,9 +108,29 @@ public:
   ///     left-0, left-1, left-2, ..., left-(d-1),
   ///     right-0, right-1, ... right(d-1)
   ///   A bit of 0 means entrance and 1 means absorbing.
+  ///   Computed directly, without the cached bit planes.
   std::vector<uint64_t>
   labelling ( void ) const;
 
+  /// cached_labelling
+  ///   Return the labelling, as an OR of the cached bit planes of each
+  ///   dimension (see _planes). Faster than "labelling" when many
+  ///   parameters of a network are labelled, since they share the
+  ///   planes of each node factor; slower for a single parameter.
+  std::vector<uint64_t>
+  cached_labelling ( void ) const;
+
+  /// relabel
+  ///   Given the labelling of the parameter "previous", update it in place
+  ///   to the labelling of this parameter. Only the bits of the dimensions
+  ///   whose labelling can differ are recomputed: dimension d if the logic
+  ///   of node d differs, and every target of node u if the output order
+  ///   of u differs. For adjacent parameters this is one dimension (logic
+  ///   change) or the targets of one node (order change). The bits are
+  ///   read from the cached bit planes, as in "cached_labelling".
+  void
+  relabel ( std::vector<uint64_t> & labelling, Parameter const& previous ) const;
+
   /// network
   ///   Return network
   Network const
@@ -103,6 +146,18 @@ public:
   void
   parse ( std::string const& str );
 
+  /// serialize
+  ///   Return a compact binary description: the network specification
+  ///   followed by the hex code and order index of each node
+  ///   (see Tools/serialization.hpp)
+  std::string
+  serialize ( void ) const;
+
+  /// deserialize
+  ///   Initialize from a binary description returned by serialize
+  void
+  deserialize ( std::string const& bytes );
+
   /// inequalities
   ///    Output a list of inequalities corresponding to the parameter node.
   ///    We output the list in a format which is compatible with Mathematica's syntax,
@@ -126,19 +181,50 @@ public:
   friend std::ostream& operator << ( std::ostream& stream, Parameter const& p );
 
 private:
+  friend class ParameterGraph;
+  friend class ParameterView;
   std::shared_ptr<Parameter_> data_;
+
+  /// _assign
+  ///   Assign data to parameter, labelling with "box_fill" (BoxFill for
+  ///   the dimension of the network)
+  void
+  _assign ( std::vector<LogicParameter> const& logic,
+            std::vector<OrderParameter> const& order,
+            Network const& network,
+            Parameter_detail::BoxFillKernel box_fill );
+
+  /// _labelling
+  ///   Set the left and right wall bits of dimension d in "result"
+  ///   (assumed to be clear)
+  void
+  _labelling ( uint64_t d, std::vector<uint64_t> & result ) const;
+
+  /// _planes
+  ///   Return the left and right wall bits of dimension d as two bit
+  ///   planes indexed by domain, the left plane followed by the right.
+  ///   They depend only on the logic of node d and the thresholds of the
+  ///   in-edges of d, so they are cached process-wide under that key
+  ///   (and Network::id) and shared by all parameters of the network
+  ///   which agree there. Each thread reads recently used planes from
+  ///   its own front cache without locking. The sizes of both caches
+  ///   are set through Configuration.
+  std::shared_ptr<std::vector<uint64_t> const>
+  _planes ( uint64_t d ) const;
 };
 
 struct Parameter_ {
   std::vector<LogicParameter> logic_;
   std::vector<OrderParameter> order_;
   Network network_;
+  Parameter_detail::BoxFillKernel box_fill_ = &Parameter_detail::BoxFill<0>::run;
 };
 
 /// Python Bindings
 
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include "Tools/numpy.hpp"
 namespace py = pybind11;
 
 inline void
@@ -151,23 +237,44 @@ ParameterBinding (py::module &m) {
     .def("attracting", &Parameter::attracting)
     .def("absorbing", &Parameter::absorbing)
     .def("regulator", &Parameter::regulator)
-    .def("labelling", &Parameter::labelling)
+    .def("labelling", &Parameter::labelling, py::call_guard<py::gil_scoped_release>())
+    .def("labelling_array", [](Parameter const& p) {
+      std::vector<uint64_t> labelling;
+      {
+        py::gil_scoped_release release;
+        labelling = p . labelling ();
+      }
+      return dsgrn::numpy_array ( std::move ( labelling ) );
+    })
+    .def("cached_labelling", &Parameter::cached_labelling, py::call_guard<py::gil_scoped_release>())
+    .def("relabel", [](Parameter const& p, std::vector<uint64_t> labelling, Parameter const& previous) {
+      p . relabel ( labelling, previous );
+      return labelling;
+    }, py::call_guard<py::gil_scoped_release>())
     .def("network", &Parameter::network)
     .def("stringify", &Parameter::stringify)
     .def("parse", &Parameter::parse)
-    .def("inequalities", &Parameter::inequalities)
+    .def("serialize", [](Parameter const& p) { return py::bytes ( p . serialize () ); })
+    .def("deserialize", &Parameter::deserialize)
+    .def("inequalities", &Parameter::inequalities, py::call_guard<py::gil_scoped_release>())
     .def("logic", &Parameter::logic)
     .def("order", &Parameter::order)
     .def("__str__", [](Parameter * lp){ std::stringstream ss; ss << *lp; return ss.str(); })
     .def(py::pickle(
     [](Parameter const& p) { // __getstate__
         /* Return a tuple that fully encodes the state of the object */
-        return py::make_tuple(p.logic(), p.order(), p.network());
+        return py::make_tuple(py::bytes(p.serialize()));
     },
     [](py::tuple t) { // __setstate__
-        if (t.size() != 3)
-            throw std::runtime_error("Unpickling Parameter object: Invalid state!");
         /* Create a new C++ instance */
-        return Parameter(t[0].cast<std::vector<LogicParameter>>(), t[1].cast<std::vector<OrderParameter>>(), t[2].cast<Network>() );
+        Parameter p;
+        if (t.size() == 1) {
+            p.deserialize(t[0].cast<std::string>());
+        } else if (t.size() == 3) { // state pickled by earlier versions
+            p.assign(t[0].cast<std::vector<LogicParameter>>(), t[1].cast<std::vector<OrderParameter>>(), t[2].cast<Network>());
+        } else {
+            throw std::runtime_error("Unpickling Parameter object: Invalid state!");
+        }
+        return p;
     }));
 }
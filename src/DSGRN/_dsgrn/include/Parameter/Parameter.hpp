@@ -10,6 +10,194 @@
 
 #include "Parameter.h"
 
+#include <deque>
+#include <mutex>
+
+#include "Parameter/Configuration.h"
+#include "Tools/serialization.hpp"
+#include "Tools/dimension.hpp"
+
+namespace Parameter_detail {
+  /// PlanesKey
+  ///   Key of the labelling planes of dimension d of a network. They
+  ///   depend on the logic of d, through its hex code ("logic" is a hash
+  ///   of it, so entries also keep the hex code to compare), and on the
+  ///   thresholds of the in-edges of d, packed in mixed radix by the
+  ///   out-degrees of the sources (exact, since the product of these is
+  ///   at most the number of domains).
+  struct PlanesKey {
+    uint64_t network;
+    uint64_t d;
+    uint64_t logic;
+    uint64_t thresholds;
+
+    bool
+    operator == ( PlanesKey const& rhs ) const {
+      return network == rhs . network && d == rhs . d &&
+             logic == rhs . logic && thresholds == rhs . thresholds;
+    }
+  };
+
+  /// PlanesKeyHash
+  struct PlanesKeyHash {
+    std::size_t
+    operator () ( PlanesKey const& key ) const {
+      uint64_t h = key . logic;
+      for ( uint64_t x : { key . network, key . d, key . thresholds } ) {
+        h ^= x + 0x9e3779b97f4a7c15ULL + ( h << 6 ) + ( h >> 2 );
+      }
+      return h;
+    }
+  };
+
+  /// PlanesEntry
+  struct PlanesEntry {
+    std::string hex;
+    std::shared_ptr<std::vector<uint64_t> const> planes;
+  };
+
+  typedef std::unordered_map<PlanesKey, PlanesEntry, PlanesKeyHash> PlanesCache;
+
+  /// apply_planes
+  ///   Set bit d (resp. D+d) of result[i] for each domain i whose bit is
+  ///   set in the left (resp. right) plane, where "planes" holds the left
+  ///   plane followed by the right plane. The planes are read a word at a
+  ///   time and only the domains of set bits are visited.
+  inline void
+  apply_planes ( std::vector<uint64_t> const& planes, uint64_t d, uint64_t D,
+                 std::vector<uint64_t> & result ) {
+    uint64_t N = result . size ();
+    uint64_t W = ( N + 63 ) / 64;
+    uint64_t * data = result . data ();
+    for ( uint64_t side = 0; side < 2; ++ side ) {
+      uint64_t const* plane = planes . data () + side * W;
+      uint64_t const mask = 1LL << ( side ? D + d : d );
+      for ( uint64_t w = 0; w < W; ++ w ) {
+        uint64_t word = plane [ w ];
+        uint64_t * block = data + 64 * w;
+        while ( word ) {
+          block [ __builtin_ctzll ( word ) ] |= mask;
+          word &= word - 1;
+        }
+      }
+    }
+  }
+
+  template < uint64_t S > void
+  BoxFill<S>::run ( uint64_t dim, dsgrn::DimensionArray<0> const& lower,
+                    dsgrn::DimensionArray<0> const& upper, dsgrn::DimensionArray<0> const& jump,
+                    uint64_t mask, std::vector<uint64_t> & result ) {
+    uint64_t const D = S ? S : dim;
+    if ( D == 0 ) return;
+    dsgrn::DimensionArray<S> lo, hi, step, x;
+    uint64_t base = 0;
+    for ( uint64_t k = 0; k < D; ++ k ) {
+      if ( upper[k] <= lower[k] ) return;
+      lo[k] = x[k] = lower[k];
+      hi[k] = upper[k];
+      step[k] = jump[k];
+      base += jump[k] * lower[k];
+    }
+    uint64_t const row = hi[0] - lo[0];
+    uint64_t * data = result . data ();
+    while ( true ) {
+      uint64_t * p = data + base;
+      for ( uint64_t i = 0; i < row; ++ i ) p[i] |= mask;
+      // next row
+      uint64_t k = 1;
+      for ( ; k < D; ++ k ) {
+        base += step[k];
+        if ( ++ x[k] < hi[k] ) break;
+        base -= ( hi[k] - lo[k] ) * step[k];
+        x[k] = lo[k];
+      }
+      if ( k == D ) return;
+    }
+  }
+
+  /// label_dimension
+  ///   Set the left and right wall bits of dimension d in "result"
+  ///   (assumed to be clear). The logic of node d and the output orders
+  ///   of its sources are read through "bin" and "inverse":
+  ///     bin(in) is the bin the target point of node d lands in for the
+  ///       input combination "in"
+  ///     inverse(source, k) is the threshold of the kth output edge of
+  ///       "source" (counting from the lowest)
+  ///   so that Parameter and ParameterView share this kernel. "box_fill"
+  ///   is BoxFill for the dimension of the network, as stored by the
+  ///   ParameterGraph or Parameter.
+  template < class Bin, class Inverse > void
+  label_dimension ( Network const& network, uint64_t d, BoxFillKernel box_fill,
+                    Bin const& bin, Inverse const& inverse, std::vector<uint64_t> & result ) {
+    uint64_t D = network . size ();
+    dsgrn::check_dimension ( D, "labelling" );
+
+    // per-dimension limits on the stack
+    dsgrn::DimensionArray<0> lower_limits {}, upper_limits {}, limits {};
+    dsgrn::DimensionArray<0> jump {}; // index offset in each dim
+    uint64_t N = 1;
+    for ( uint64_t k = 0; k < D; ++ k ) {
+      limits[k] = network . outputs ( k ) . size () + 1;
+      jump[k] =  N;
+      N *= limits [ k ];
+    }
+    // N is now number of domains
+    // Domains are implicitly indexed.
+    // "jump" is an array telling us how much to change the index
+    //   to move +1 in each dimension
+    std::vector<uint64_t> const& inputs = network . inputs ( d );
+    uint64_t sources = inputs . size ();
+    uint64_t numInComb = ( 1LL << sources );
+    for ( uint64_t in = 0; in < numInComb; ++ in ) {
+      /// What bin does the target point land in for dimension d?
+      uint64_t target_bin = bin ( in );
+      /// Which domains have this input combination for dimension d?
+      std::fill ( lower_limits.begin(), lower_limits.begin() + D, 0 );
+      upper_limits = limits;
+      for ( uint64_t inorder = 0; inorder < sources; ++ inorder ) {
+        uint64_t source = inputs [ inorder ];
+        bool activating = network . interaction ( source, d );
+        bool side = in & ( 1LL << inorder );
+        uint64_t thres = inverse ( source, network . order ( source, d ) ) + 1;
+        if ( activating ^ side ) {
+          lower_limits[source] = 0;
+          upper_limits[source] = thres;
+        } else {
+          lower_limits[source] = thres;
+          upper_limits[source] = limits [ source ];
+        }
+      }
+      /// Iterate through two zones:
+      ///   Zone 1. domain left of bin
+      ///   Zone 2. domain right of bin
+      ///   Note. domains matching bin do not
+      ///         require anything to be done
+      auto apply_mask = [&] ( uint64_t mask ) {
+        box_fill ( D, lower_limits, upper_limits, jump, mask, result );
+      };
+
+      //   Note. If node d is one of its own inputs, the input
+      //         combination already restricts dimension d to
+      //         [left, right), so the zones are clipped to it
+      uint64_t left = lower_limits [ d ];
+      uint64_t right = upper_limits [ d ];
+
+      // Zone 1. (Flows to right.)
+      if ( target_bin > left ) {
+        lower_limits [ d ] = left;
+        upper_limits [ d ] = std::min ( target_bin, right );
+        apply_mask (1LL << (D+d));
+      }
+      // Zone 2. (Flows to left.)
+      if ( target_bin+1 < right ) {
+        lower_limits [ d ] = std::max ( target_bin + 1, left );
+        upper_limits [ d ] = right;
+        apply_mask (1LL << d);
+      }
+    }
+  }
+}
+
 INLINE_IF_HEADER_ONLY Parameter::
 Parameter ( void ) {
   data_ . reset ( new Parameter_ );
@@ -31,16 +219,26 @@ INLINE_IF_HEADER_ONLY void Parameter::
 assign ( std::vector<LogicParameter> const& logic,
          std::vector<OrderParameter> const& order,
          Network const& network ) {
+  _assign ( logic, order, network, dsgrn::select_dimension_deferred<Parameter_detail::BoxFill> ( network . size () ) );
+}
+
+INLINE_IF_HEADER_ONLY void Parameter::
+assign ( Network const& network ) {
   data_ . reset ( new Parameter_ );
-  data_ -> logic_ = logic;
-  data_ -> order_ = order;
   data_ -> network_ = network;
+  data_ -> box_fill_ = dsgrn::select_dimension_deferred<Parameter_detail::BoxFill> ( network . size () );
 }
 
 INLINE_IF_HEADER_ONLY void Parameter::
-assign ( Network const& network ) {
+_assign ( std::vector<LogicParameter> const& logic,
+          std::vector<OrderParameter> const& order,
+          Network const& network,
+          Parameter_detail::BoxFillKernel box_fill ) {
   data_ . reset ( new Parameter_ );
+  data_ -> logic_ = logic;
+  data_ -> order_ = order;
   data_ -> network_ = network;
+  data_ -> box_fill_ = box_fill;
 }
 
 
@@ -108,112 +306,142 @@ regulator ( uint64_t variable, uint64_t threshold ) const {
 
 INLINE_IF_HEADER_ONLY std::vector<uint64_t> Parameter::
 labelling ( void ) const {
-  std::vector<uint64_t> result;
+  // Check before allocating, as a network this large has too many domains
+  dsgrn::check_dimension ( network () . size (), "labelling" );
+  uint64_t N = 1;
+  for ( uint64_t limit : network () . domains () ) N *= limit;
+  std::vector<uint64_t> result ( N, 0 );
   uint64_t D = network () . size ();
+  for ( uint64_t d = 0; d < D; ++ d ) _labelling ( d, result );
+  return result;
+}
 
-  // pre-allocated vectors (for efficiency)
-  std::vector<uint64_t> lower_limits ( D );
-  std::vector<uint64_t> upper_limits ( D );
-  std::vector<uint64_t> dom ( D );
-  std::vector<uint64_t> width ( D );
-
-  std::vector<uint64_t> limits = network () . domains ();
-  std::vector<uint64_t> jump ( D ); // index offset in each dim
+INLINE_IF_HEADER_ONLY std::vector<uint64_t> Parameter::
+cached_labelling ( void ) const {
+  // Check before allocating, as a network this large has too many domains
+  dsgrn::check_dimension ( network () . size (), "labelling" );
   uint64_t N = 1;
+  for ( uint64_t limit : network () . domains () ) N *= limit;
+  std::vector<uint64_t> result ( N, 0 );
+  uint64_t D = network () . size ();
   for ( uint64_t d = 0; d < D; ++ d ) {
-    jump[d] =  N;
-    N *= limits [ d ];
+    Parameter_detail::apply_planes ( *_planes ( d ), d, D, result );
   }
-  // N is now number of domains
-  // Domains are implicitly indexed.
-  // "jump" is an array telling us how much to change the index
-  //   to move +1 in each dimension
-  result . resize ( N, 0 );
-  for ( int d = 0; d < D; ++ d ) {
-    uint64_t n = network() . inputs ( d ) . size ();
-    uint64_t numInComb = ( 1LL << n );
-    //uint64_t num_debug_domains = 0;
-    for ( uint64_t in = 0; in < numInComb; ++ in ) {
-      /// What bin does the target point land in for dimension d?
-      uint64_t bin = data_ -> logic_ [ d ] . bin ( in );
-      /// Which domains have this input combination for dimension d?
-      std::fill ( lower_limits.begin(), lower_limits.end(), 0 );
-      upper_limits = limits;
-      uint64_t sources = network () . inputs ( d ) . size ();
-      for ( uint64_t inorder = 0; inorder < sources; ++ inorder ) {
-        //std::cout << "Dim " << d << ", in = " << in << " inorder = " << inorder << "\n";
-        uint64_t source = network () . inputs ( d ) [ inorder ];
-        //std::cout << "source = " << source << "\n";
-        bool activating = network () . interaction ( source, d );
-        //std::cout << "high is activating? " << ( activating ? "yes" : "no" ) << "\n";
-        int outorder = network () . order ( source, d );
-        //std::cout << "outorder = " << outorder << "\n";
-        bool side = in & ( 1LL << inorder );
-        //std::cout << "on activating side? " << ( side ? "yes" : "no" ) << "\n";
-        uint64_t thres = data_ -> order_ [ source ] . inverse ( outorder ) + 1;
-        //std::cout << "critical bin = " << thres << "\n";
-        if ( activating ^ side ) {
-          //std::cout << "Case A.\n";
-          lower_limits[source] = 0;
-          upper_limits[source] = thres;
-        } else {
-          //std::cout << "Case B.\n";
-          lower_limits[source] = thres;
-          upper_limits[source] = limits [ source ];
-        }
-      }
-      /// Iterate through two zones:
-      ///   Zone 1. domain left of bin
-      ///   Zone 2. domain right of bin
-      ///   Note. domains matching bin do not
-      ///         require anything to be done
-      auto apply_mask = [&] ( uint64_t mask ) {
-        // Iterate between lower and upper limits applying mask
-        uint64_t dom_index = 0;
-        dom = lower_limits;
-        for ( uint64_t k = 0; k < D; ++ k ) {
-          width[k] = upper_limits[k] - lower_limits[k];
-          dom_index += jump[k] * lower_limits[k];
-          if ( width[k] == 0 ) return;
-        }
-        while ( 1 ) {
-          // apply mask
-          result [ dom_index ] |= mask;
-          // next domain
-          for ( uint64_t k = 0; k < D; ++ k ) {
-            ++ dom[k];
-            dom_index += jump[k];
-            if ( dom[k] < upper_limits[k] ) break;
-            dom[k] = lower_limits[k];
-            dom_index -= width[k] * jump[k];
-          }
-          // If we are back to start, return
-          bool done = true;
-          for ( uint64_t k = 0; k < D; ++ k ) {
-            if ( dom[k] != lower_limits[k] ) done = false;
-          }
-          if ( done ) break;
-        }
-      };
+  return result;
+}
 
-      uint64_t left = lower_limits [ d ];
-      uint64_t right = upper_limits [ d ];
+INLINE_IF_HEADER_ONLY void Parameter::
+relabel ( std::vector<uint64_t> & labelling, Parameter const& previous ) const {
+  uint64_t D = network () . size ();
+  // Bits for dimension d depend only on the logic of node d and on the
+  // output orders of the sources of d
+  std::vector<bool> changed ( D, false );
+  for ( uint64_t d = 0; d < D; ++ d ) {
+    if ( data_ -> logic_ [ d ] . hex () != previous . data_ -> logic_ [ d ] . hex () ) {
+      changed [ d ] = true;
+    }
+    if ( not ( data_ -> order_ [ d ] == previous . data_ -> order_ [ d ] ) ) {
+      for ( uint64_t target : network () . outputs ( d ) ) changed [ target ] = true;
+    }
+  }
+  uint64_t mask = 0;
+  for ( uint64_t d = 0; d < D; ++ d ) {
+    if ( changed [ d ] ) mask |= ( 1LL << d ) | ( 1LL << (D+d) );
+  }
+  if ( mask == 0 ) return;
+  for ( uint64_t & label : labelling ) label &= ~mask;
+  for ( uint64_t d = 0; d < D; ++ d ) {
+    if ( changed [ d ] ) Parameter_detail::apply_planes ( *_planes ( d ), d, D, labelling );
+  }
+}
 
-      // Zone 1. (Flows to right.)
-      if ( bin > left ) {
-        lower_limits [ d ] = left;
-        upper_limits [ d ] = bin;
-        apply_mask (1LL << (D+d));
-      }
-      // Zone 2. (Flows to left.)
-      if ( bin+1 < right ) {
-        lower_limits [ d ] = bin + 1;
-        upper_limits [ d ] = right;
-        apply_mask (1LL << d);
-      }
+INLINE_IF_HEADER_ONLY std::shared_ptr<std::vector<uint64_t> const> Parameter::
+_planes ( uint64_t d ) const {
+  typedef std::shared_ptr<std::vector<uint64_t> const> Planes;
+  using Parameter_detail::PlanesKey;
+  using Parameter_detail::PlanesEntry;
+  static std::mutex cache_mutex;
+  static Parameter_detail::PlanesCache cache;
+  static std::deque<PlanesKey> insertion_order;
+  static uint64_t cache_bytes = 0;
+  static thread_local Parameter_detail::PlanesCache front;
+  static thread_local uint64_t front_bytes = 0;
+  uint64_t const cache_limit = configuration () -> get_labelling_cache_bytes ();
+  uint64_t const front_limit = configuration () -> get_labelling_front_cache_bytes ();
+  // Look in this thread's front cache first, without locking; on a miss
+  // look in (or add to) the shared cache and remember the planes in front
+  Network const& net = data_ -> network_;
+  std::string const& hex = data_ -> logic_ [ d ] . hex ();
+  PlanesKey key;
+  key . network = net . id ();
+  key . d = d;
+  key . logic = std::hash<std::string> () ( hex );
+  key . thresholds = 0;
+  for ( uint64_t source : net . inputs ( d ) ) {
+    uint64_t thres = data_ -> order_ [ source ] . inverse ( net . order ( source, d ) );
+    key . thresholds = key . thresholds * net . outputs ( source ) . size () + thres;
+  }
+  auto front_it = front . find ( key );
+  if ( front_it != front . end () && front_it -> second . hex == hex ) return front_it -> second . planes;
+  Planes planes;
+  {
+    std::lock_guard<std::mutex> lock ( cache_mutex );
+    auto it = cache . find ( key );
+    if ( it != cache . end () && it -> second . hex == hex ) planes = it -> second . planes;
+  }
+  if ( not planes ) {
+    uint64_t D = network () . size ();
+    uint64_t N = 1;
+    for ( uint64_t limit : network () . domains () ) N *= limit;
+    uint64_t W = ( N + 63 ) / 64;
+    std::vector<uint64_t> bits ( N, 0 );
+    _labelling ( d, bits );
+    std::shared_ptr<std::vector<uint64_t>> computed ( new std::vector<uint64_t> ( 2 * W, 0 ) );
+    for ( uint64_t i = 0; i < N; ++ i ) {
+      if ( bits [ i ] & ( 1LL << d ) ) (*computed) [ i >> 6 ] |= 1LL << ( i & 63 );
+      if ( bits [ i ] & ( 1LL << (D+d) ) ) (*computed) [ W + ( i >> 6 ) ] |= 1LL << ( i & 63 );
+    }
+    planes = computed;
+    std::lock_guard<std::mutex> lock ( cache_mutex );
+    // If another thread finished first (or, rarely, another hex code has
+    // the same key) keep the existing entry
+    auto inserted = cache . insert ( { key, PlanesEntry { hex, planes } } );
+    if ( inserted . second ) {
+      insertion_order . push_back ( key );
+      cache_bytes += sizeof(PlanesKey) + hex . size () + planes -> size () * sizeof(uint64_t);
+    } else if ( inserted . first -> second . hex == hex ) {
+      planes = inserted . first -> second . planes;
+    }
+    // Evict the oldest planes down to the limit (all of them if the
+    // cache is disabled)
+    while ( cache_bytes > cache_limit && not insertion_order . empty () ) {
+      auto it = cache . find ( insertion_order . front () );
+      cache_bytes -= sizeof(PlanesKey) + it -> second . hex . size () + it -> second . planes -> size () * sizeof(uint64_t);
+      cache . erase ( it );
+      insertion_order . pop_front ();
     }
   }
-  return result;
+  uint64_t bytes = planes -> size () * sizeof(uint64_t);
+  if ( front_bytes + bytes > front_limit ) {
+    front . clear ();
+    front_bytes = 0;
+  }
+  if ( bytes > front_limit ) return planes;
+  auto inserted = front . insert ( { key, PlanesEntry { hex, planes } } );
+  if ( inserted . second ) {
+    front_bytes += bytes;
+  } else {
+    inserted . first -> second = PlanesEntry { hex, planes };
+  }
+  return planes;
+}
+
+INLINE_IF_HEADER_ONLY void Parameter::
+_labelling ( uint64_t d, std::vector<uint64_t> & result ) const {
+  Parameter_detail::label_dimension ( network (), d, data_ -> box_fill_,
+    [&] ( uint64_t in ) { return data_ -> logic_ [ d ] . bin ( in ); },
+    [&] ( uint64_t source, uint64_t outorder ) { return data_ -> order_ [ source ] . inverse ( outorder ); },
+    result );
 }
 
 INLINE_IF_HEADER_ONLY Network const Parameter::
@@ -249,6 +477,41 @@ parse ( std::string const& str ) {
   }
 }
 
+INLINE_IF_HEADER_ONLY std::string Parameter::
+serialize ( void ) const {
+  dsgrn::BinaryWriter writer ( 'P' );
+  writer . string ( data_ -> network_ . specification () );
+  uint64_t D = data_ -> logic_ . size ();
+  writer . integer ( D );
+  for ( uint64_t d = 0; d < D; ++ d ) {
+    writer . string ( data_ -> logic_[d] . hex () );
+    writer . integer ( data_ -> order_[d] . index () );
+  }
+  return writer . bytes ();
+}
+
+INLINE_IF_HEADER_ONLY void Parameter::
+deserialize ( std::string const& bytes ) {
+  dsgrn::BinaryReader reader ( bytes, 'P', "Parameter::deserialize" );
+  std::string specification = reader . string ();
+  Network network;
+  if ( not specification . empty () ) network . assign ( specification );
+  uint64_t D = reader . integer ();
+  if ( D != network . size () ) {
+    throw std::runtime_error ( "Parameter::deserialize: node count does not match network" );
+  }
+  std::vector<LogicParameter> logic;
+  std::vector<OrderParameter> order;
+  for ( uint64_t d = 0; d < D; ++ d ) {
+    uint64_t n = network . inputs ( d ) . size ();
+    uint64_t m = network . outputs ( d ) . size ();
+    logic . push_back ( LogicParameter ( n, m, reader . string () ) );
+    order . push_back ( OrderParameter ( m, reader . integer () ) );
+  }
+  reader . finish ();
+  assign ( logic, order, network );
+}
+
 INLINE_IF_HEADER_ONLY std::string Parameter::
 inequalities ( void ) const {
   // input_string
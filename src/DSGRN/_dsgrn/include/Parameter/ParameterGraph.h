@@ -6,6 +6,8 @@
 
 #include "common.h"
 
+#include <mutex>
+
 #include "Parameter/Network.h"
 #include "Parameter/Parameter.h" 
 #include "Parameter/Configuration.h" 
@@ -59,6 +61,16 @@ public:
   ///   ith factor graph
   std::vector<std::string> const& 
   factorgraph ( uint64_t i ) const;
+
+  /// factorgraph_edges
+  ///   Return the edges of the ith factor graph, i.e. the pairs (a,b) of
+  ///   positions in factorgraph(i) whose hex codes differ in exactly one
+  ///   bit, with the code at a less than the code at b. The list is sorted.
+  ///   Edges depend only on the hex codes, so they are computed once per
+  ///   factor graph class (list of hex codes) and shared by every node
+  ///   and ParameterGraph in the process with that class.
+  std::vector<std::pair<uint64_t,uint64_t>> const&
+  factorgraph_edges ( uint64_t i ) const;
   
   /// parameter
   ///   Return the parameter associated with an index
@@ -71,6 +83,18 @@ public:
   uint64_t
   index ( Parameter const& p ) const;
 
+  /// gray_code
+  ///   Return the index of the kth parameter in a reflected mixed-radix
+  ///   Gray code order of the parameter graph. As k runs through
+  ///   0, ..., size()-1 the result runs through every parameter index
+  ///   once, and consecutive parameters differ in exactly one logic
+  ///   or order digit, i.e. in the logic or the output order of a single
+  ///   node. Visiting parameters in this order lets Parameter::relabel
+  ///   update the labelling of the previous parameter rather than
+  ///   computing it from scratch.
+  uint64_t
+  gray_code ( uint64_t k ) const;
+
   /// adjacencies
   ///   Return the adjacent parameter indices to a given parameter index
   std::vector<uint64_t>
@@ -81,6 +105,20 @@ public:
   Network const
   network ( void ) const;
 
+  /// serialize
+  ///   Return a compact binary description: the network specification
+  ///   and the logic shape and hex code table of each factor graph
+  ///   (see Tools/serialization.hpp)
+  std::string
+  serialize ( void ) const;
+
+  /// deserialize
+  ///   Initialize from a binary description returned by serialize.
+  ///   The factor graphs come from the description, so unlike assign
+  ///   this does not read any logic resource files.
+  void
+  deserialize ( std::string const& bytes );
+
   /// fixedordersize
   ///   Return the number of parameters
   ///   for a fixed ordering
@@ -98,8 +136,22 @@ public:
   friend std::ostream& operator << ( std::ostream& stream, ParameterGraph const& pg );
 
 private:
+  friend class ParameterView;
+  friend class ParameterSampler;
   std::shared_ptr<ParameterGraph_> data_;
   uint64_t _factorial ( uint64_t m ) const;
+
+  /// _tables
+  ///   Compute the place bases and values and the hex code lookup
+  ///   tables from the network and the factor graphs, and select the
+  ///   labelling kernel for the dimension of the network
+  void _tables ( void );
+
+  /// _view_tables
+  ///   Compute the tables read by ParameterView (bins of each hex code
+  ///   and output edge permutations), once, when the first view of the
+  ///   graph is created. Safe to call from several threads.
+  void _view_tables ( void ) const;
 };
 
 struct ParameterGraph_ {
@@ -113,6 +165,15 @@ struct ParameterGraph_ {
   std::vector<std::unordered_map<std::string,uint64_t>> factors_inv_;
   std::vector<uint64_t> logic_place_bases_;
   std::vector<uint64_t> order_place_bases_;
+  // BoxFill for the dimension of the network, selected by _tables
+  Parameter_detail::BoxFillKernel box_fill_ = &Parameter_detail::BoxFill<0>::run;
+  // Built by factorgraph_edges, from the process-wide cache
+  std::once_flag factorgraph_edges_once_;
+  std::vector<std::shared_ptr<std::vector<std::pair<uint64_t,uint64_t>> const>> factorgraph_edges_;
+  // Built by _view_tables
+  std::once_flag view_tables_once_;
+  std::vector<std::vector<uint8_t>> logic_bins_;
+  std::vector<std::vector<uint8_t>> order_tables_;
 };
 
 /// Python Bindings
@@ -125,28 +186,37 @@ inline void
 ParameterGraphBinding (py::module &m) {
   py::class_<ParameterGraph, std::shared_ptr<ParameterGraph>>(m, "ParameterGraph")
     .def(py::init<>())
-    .def(py::init<Network const&>())
+    .def(py::init<Network const&>(), py::call_guard<py::gil_scoped_release>())
     .def("size", &ParameterGraph::size)
     .def("dimension", &ParameterGraph::dimension)
     .def("logicsize", &ParameterGraph::logicsize)
     .def("ordersize", &ParameterGraph::ordersize)
     .def("factorgraph", &ParameterGraph::factorgraph)
-    .def("parameter", &ParameterGraph::parameter)    
-    .def("index", &ParameterGraph::index)
-    .def("adjacencies", &ParameterGraph::adjacencies)
+    .def("factorgraph_edges", &ParameterGraph::factorgraph_edges)
+    .def("parameter", &ParameterGraph::parameter, py::call_guard<py::gil_scoped_release>())
+    .def("index", &ParameterGraph::index, py::call_guard<py::gil_scoped_release>())
+    .def("gray_code", &ParameterGraph::gray_code)
+    .def("adjacencies", &ParameterGraph::adjacencies, py::call_guard<py::gil_scoped_release>())
     .def("network", &ParameterGraph::network)
+    .def("serialize", [](ParameterGraph const& pg) { return py::bytes ( pg . serialize () ); })
+    .def("deserialize", &ParameterGraph::deserialize)
     .def("fixedordersize", &ParameterGraph::fixedordersize)
     .def("reorderings", &ParameterGraph::reorderings)
     .def("__str__", [](ParameterGraph * lp){ std::stringstream ss; ss << *lp; return ss.str(); })
     .def(py::pickle(
     [](ParameterGraph const& p) { // __getstate__
         /* Return a tuple that fully encodes the state of the object */
-        return py::make_tuple(p.network());
+        return py::make_tuple(py::bytes(p.serialize()));
     },
     [](py::tuple t) { // __setstate__
         if (t.size() != 1)
             throw std::runtime_error("Unpickling ParameterGraph object: Invalid state!");
         /* Create a new C++ instance */
-        return ParameterGraph(t[0].cast<Network>());
+        if (py::isinstance<Network>(t[0])) { // state pickled by earlier versions
+            return ParameterGraph(t[0].cast<Network>());
+        }
+        ParameterGraph pg;
+        pg.deserialize(t[0].cast<std::string>());
+        return pg;
     }));
 }
@@ -10,6 +10,196 @@
 
 #include "ParameterGraph.h"
 
+#include <mutex>
+
+#include "Tools/serialization.hpp"
+
+namespace ParameterGraph_detail {
+  /// logic_shape
+  ///   Return "n_m_p1_p2..." (with "_E" appended if node d is essential),
+  ///   where n and m are the numbers of inputs and outputs of node d and
+  ///   p1, p2, ... are the sizes of the factors of its logic. This
+  ///   determines the factor graph of node d, and names its logic resource.
+  inline std::string
+  logic_shape ( Network const& network, uint64_t d ) {
+    std::stringstream ss;
+    ss << network . inputs ( d ) . size () << "_" << network . outputs ( d ) . size ();
+    for ( auto const& p : network . logic ( d ) ) ss << "_" << p . size ();
+    if ( network . essential ( d ) ) ss << "_E";
+    return ss . str ();
+  }
+
+  /// logic_file
+  ///   Return the path of the logic resource of a logic shape, under
+  ///   the configured resource path
+  inline std::string
+  logic_file ( std::string const& shape ) {
+    return configuration () -> get_path () + "/logic/" + shape + ".dat";
+  }
+
+  /// factorgraph_edges
+  ///   Compute the pairs (a,b) such that hexcodes[b] is obtained from
+  ///   hexcodes[a] by setting a single bit. Each code is parsed once and
+  ///   each of its promotions is looked up in a hash table, so this takes
+  ///   O(NM) time for N codes of M bits.
+  inline std::vector<std::pair<uint64_t,uint64_t>>
+  factorgraph_edges ( std::vector<std::string> const& hexcodes ) {
+    uint64_t N = hexcodes . size ();
+    std::vector<uint64_t> codes ( N );
+    std::unordered_map<uint64_t,uint64_t> position;
+    uint64_t bits = 0;
+    for ( uint64_t a = 0; a < N; ++ a ) {
+      std::string const& hex = hexcodes[a];
+      if ( hex . size () > 16 ) {
+        throw std::runtime_error ( "ParameterGraph::factorgraph_edges: hex code " + hex + " exceeds 64 bits" );
+      }
+      bits = std::max<uint64_t> ( bits, 4 * hex . size () );
+      codes[a] = std::stoull ( hex, 0, 16 );
+      position [ codes[a] ] = a;
+    }
+    std::vector<std::pair<uint64_t,uint64_t>> edges;
+    for ( uint64_t a = 0; a < N; ++ a ) {
+      for ( uint64_t k = 0; k < bits; ++ k ) {
+        uint64_t bit = 1ULL << k;
+        if ( codes[a] & bit ) continue;
+        auto it = position . find ( codes[a] | bit );
+        if ( it != position . end () ) edges . push_back ( { a, it -> second } );
+      }
+    }
+    std::sort ( edges . begin (), edges . end () );
+    return edges;
+  }
+
+  /// shared_factorgraph_edges
+  ///   Return factorgraph_edges(hexcodes) from a process-wide cache keyed
+  ///   by a hash of the hex codes; entries also keep the codes to compare.
+  ///   There are few factor graph classes, so entries are never evicted.
+  inline std::shared_ptr<std::vector<std::pair<uint64_t,uint64_t>> const>
+  shared_factorgraph_edges ( std::vector<std::string> const& hexcodes ) {
+    typedef std::shared_ptr<std::vector<std::pair<uint64_t,uint64_t>> const> Edges;
+    struct Entry {
+      std::vector<std::string> hexcodes;
+      Edges edges;
+    };
+    static std::mutex cache_mutex;
+    static std::unordered_map<uint64_t, Entry> cache;
+    uint64_t key = hexcodes . size ();
+    for ( auto const& hex : hexcodes ) {
+      key ^= std::hash<std::string> () ( hex ) + 0x9e3779b97f4a7c15ULL + ( key << 6 ) + ( key >> 2 );
+    }
+    {
+      std::lock_guard<std::mutex> lock ( cache_mutex );
+      auto it = cache . find ( key );
+      if ( it != cache . end () && it -> second . hexcodes == hexcodes ) return it -> second . edges;
+    }
+    Edges edges ( new std::vector<std::pair<uint64_t,uint64_t>> ( factorgraph_edges ( hexcodes ) ) );
+    std::lock_guard<std::mutex> lock ( cache_mutex );
+    // If another thread finished first (or, rarely, another class has the
+    // same key) keep the existing entry
+    auto inserted = cache . insert ( { key, Entry { hexcodes, edges } } );
+    if ( inserted . first -> second . hexcodes == hexcodes ) return inserted . first -> second . edges;
+    return edges;
+  }
+
+  /// pack_hexcodes
+  ///   Write a list of hex codes. Codes of a common width written in
+  ///   uppercase digits (as in the logic resource files) are packed two
+  ///   digits per byte; any other list is written code by code.
+  inline void
+  pack_hexcodes ( dsgrn::BinaryWriter & writer, std::vector<std::string> const& hexcodes ) {
+    uint64_t width = hexcodes . empty () ? 0 : hexcodes[0] . size ();
+    std::string digits;
+    for ( std::string const& hex : hexcodes ) {
+      if ( hex . size () != width ) { width = 0; break; }
+      for ( char c : hex ) {
+        if ( c >= '0' && c <= '9' ) digits . push_back ( c - '0' );
+        else if ( c >= 'A' && c <= 'F' ) digits . push_back ( c - 'A' + 10 );
+        else { width = 0; break; }
+      }
+      if ( width == 0 ) break;
+    }
+    writer . integer ( hexcodes . size () );
+    writer . integer ( width );
+    if ( width == 0 ) {
+      for ( std::string const& hex : hexcodes ) writer . string ( hex );
+      return;
+    }
+    std::string packed ( ( digits . size () + 1 ) / 2, 0 );
+    for ( uint64_t i = 0; i < digits . size (); ++ i ) {
+      packed [ i / 2 ] |= digits [ i ] << ( 4 * ( i % 2 ) );
+    }
+    writer . string ( packed );
+  }
+
+  /// unpack_hexcodes
+  ///   Read a list of hex codes written by pack_hexcodes
+  inline std::vector<std::string>
+  unpack_hexcodes ( dsgrn::BinaryReader & reader ) {
+    static const char digit [] = "0123456789ABCDEF";
+    uint64_t N = reader . integer ();
+    uint64_t width = reader . integer ();
+    std::vector<std::string> hexcodes;
+    if ( width == 0 ) {
+      for ( uint64_t i = 0; i < N; ++ i ) hexcodes . push_back ( reader . string () );
+      return hexcodes;
+    }
+    std::string packed = reader . string ();
+    if ( packed . size () != ( N * width + 1 ) / 2 ) {
+      throw std::runtime_error ( "ParameterGraph::deserialize: inconsistent hex code table" );
+    }
+    hexcodes . resize ( N, std::string ( width, '0' ) );
+    for ( uint64_t i = 0; i < N * width; ++ i ) {
+      hexcodes [ i / width ] [ i % width ] = digit [ ( packed [ i / 2 ] >> ( 4 * ( i % 2 ) ) ) & 15 ];
+    }
+    return hexcodes;
+  }
+
+  /// logic_bins
+  ///   Return the table of bins of a factor graph of n inputs and m
+  ///   outputs: entry (k << n) + in is the bin the target point lands in
+  ///   under the kth hex code and input combination "in", i.e. what
+  ///   LogicParameter::bin returns, without constructing LogicParameters
+  inline std::vector<uint8_t>
+  logic_bins ( std::vector<std::string> const& hexcodes, uint64_t n, uint64_t m ) {
+    uint64_t C = 1LL << n;
+    std::vector<uint8_t> bins ( hexcodes . size () * C, 0 );
+    for ( uint64_t k = 0; k < hexcodes . size (); ++ k ) {
+      std::string const& hex = hexcodes [ k ];
+      uint64_t L = hex . size ();
+      // bit b of the logic is bit b%4 of the (b/4)th digit from the right
+      auto bit = [&] ( uint64_t b ) {
+        if ( b / 4 >= L ) return false;
+        char c = hex [ L - 1 - b / 4 ];
+        int digit = ( c >= 'A' ) ? c - 'A' + 10 : c - '0';
+        return ( ( digit >> ( b % 4 ) ) & 1 ) != 0;
+      };
+      for ( uint64_t in = 0; in < C; ++ in ) {
+        uint8_t result = 0;
+        while ( result < m && bit ( in * m + result ) ) ++ result;
+        bins [ k * C + in ] = result;
+      }
+    }
+    return bins;
+  }
+
+  /// order_table
+  ///   Return the permutations of m elements in the order of
+  ///   OrderParameter indices: entry k holds 2m values, the permutation
+  ///   with index k followed by its inverse
+  inline std::vector<uint8_t>
+  order_table ( uint64_t m, uint64_t count ) {
+    std::vector<uint8_t> table ( 2 * m * count );
+    for ( uint64_t k = 0; k < count; ++ k ) {
+      OrderParameter order ( m, k );
+      for ( uint64_t i = 0; i < m; ++ i ) {
+        table [ 2 * m * k + i ] = order ( i );
+        table [ 2 * m * k + m + i ] = order . inverse ( i );
+      }
+    }
+    return table;
+  }
+}
+
 INLINE_IF_HEADER_ONLY ParameterGraph::
 ParameterGraph ( void ) {
   data_ . reset ( new ParameterGraph_ );
@@ -22,57 +212,63 @@ ParameterGraph ( Network const& network ) {
 
 INLINE_IF_HEADER_ONLY void ParameterGraph::
 assign ( Network const& network ) {
-  std::string path = configuration() -> get_path() + "/logic";
   data_ . reset ( new ParameterGraph_ );
   data_ -> network_ = network;
-  data_ -> reorderings_ = 1;
-  data_ -> fixedordersize_ = 1;
   // Load the logic files one by one.
   uint64_t D = data_ -> network_ . size ();
   for ( uint64_t d = 0; d < D; ++ d ) {
-    uint64_t n = data_ -> network_ . inputs ( d ) . size ();
-    uint64_t m = data_ -> network_ . outputs ( d ) . size ();
-    data_ -> order_place_bases_ . push_back ( _factorial ( m ) );
-    data_ -> reorderings_ *= data_ -> order_place_bases_ . back ();
-    std::vector<std::vector<uint64_t>> const& logic_struct = data_ -> network_ . logic ( d );
-    std::stringstream ss;
-    ss << path << "/" << n <<  "_" << m;
-    for ( auto const& p : logic_struct ) ss <<  "_" << p.size();
-    if ( data_ -> network_ . essential ( d ) ) ss << "_E";
-    ss << ".dat";
-    //std::cout << "Acquiring logic data in " << ss.str() << "\n";
+    std::string filename = ParameterGraph_detail::logic_file (
+      ParameterGraph_detail::logic_shape ( data_ -> network_, d ) );
     std::vector<std::string> hex_codes;
-    std::ifstream infile ( ss.str() );
+    std::ifstream infile ( filename );
     if ( not infile . good () ) {
-      throw std::runtime_error ( "Error: Could not find logic resource " + ss.str() + ".\n");
+      throw std::runtime_error ( "Error: Could not find logic resource " + filename + ".\n");
     }
     std::string line;
-    std::unordered_map<std::string,uint64_t> hx;
-    uint64_t counter = 0;
     while ( std::getline ( infile, line ) ) {
       hex_codes . push_back ( line );
-      hx [ line ] = counter;
-      ++counter;
     }
     infile . close ();
     data_ -> factors_ . push_back ( hex_codes );
-    data_ -> factors_inv_ . push_back ( hx );
-    data_ -> logic_place_bases_ . push_back ( hex_codes . size () );
-    data_ -> fixedordersize_ *= hex_codes . size ();
-    //std::cout << d << ": " << hex_codes . size () << " factorial(" << m << ")=" << _factorial ( m ) << "\n";
   }
-  data_ -> size_ = data_ -> fixedordersize_ * data_ -> reorderings_;
-  // construction of place_values_ used in method index
-  data_ -> logic_place_values_ . resize ( D, 0 );
-  data_ -> order_place_values_ . resize ( D, 0 );
-  data_ -> logic_place_values_ [ 0 ] = 1;
-  data_ -> order_place_values_ [ 0 ] = 1;
-  for ( uint64_t i = 1; i < D; ++ i ) {
-    data_ -> logic_place_values_ [ i ] = data_ -> logic_place_bases_ [ i - 1 ] *
-                                   data_ -> logic_place_values_ [ i - 1 ];
-    data_ -> order_place_values_ [ i ] = data_ -> order_place_bases_ [ i - 1 ] *
-                                  data_ -> order_place_values_ [ i - 1 ];
+  _tables ();
+}
+
+INLINE_IF_HEADER_ONLY std::string ParameterGraph::
+serialize ( void ) const {
+  dsgrn::BinaryWriter writer ( 'G' );
+  writer . string ( data_ -> network_ . specification () );
+  uint64_t D = data_ -> factors_ . size ();
+  writer . integer ( D );
+  for ( uint64_t d = 0; d < D; ++ d ) {
+    // The logic shape rather than the resource path, which is local to
+    // this machine
+    writer . string ( ParameterGraph_detail::logic_shape ( data_ -> network_, d ) );
+    ParameterGraph_detail::pack_hexcodes ( writer, data_ -> factors_ [ d ] );
+  }
+  return writer . bytes ();
+}
+
+INLINE_IF_HEADER_ONLY void ParameterGraph::
+deserialize ( std::string const& bytes ) {
+  dsgrn::BinaryReader reader ( bytes, 'G', "ParameterGraph::deserialize" );
+  std::shared_ptr<ParameterGraph_> data ( new ParameterGraph_ );
+  std::string specification = reader . string ();
+  if ( not specification . empty () ) data -> network_ . assign ( specification );
+  uint64_t D = reader . integer ();
+  if ( D != data -> network_ . size () ) {
+    throw std::runtime_error ( "ParameterGraph::deserialize: node count does not match network" );
+  }
+  for ( uint64_t d = 0; d < D; ++ d ) {
+    std::string shape = reader . string ();
+    if ( shape != ParameterGraph_detail::logic_shape ( data -> network_, d ) ) {
+      throw std::runtime_error ( "ParameterGraph::deserialize: logic shape " + shape + " does not match network" );
+    }
+    data -> factors_ . push_back ( ParameterGraph_detail::unpack_hexcodes ( reader ) );
   }
+  reader . finish ();
+  data_ = data;
+  _tables ();
 }
 
 INLINE_IF_HEADER_ONLY uint64_t ParameterGraph::
@@ -100,6 +296,19 @@ factorgraph ( uint64_t i ) const {
   return data_ -> factors_[i];
 }
 
+INLINE_IF_HEADER_ONLY std::vector<std::pair<uint64_t,uint64_t>> const& ParameterGraph::
+factorgraph_edges ( uint64_t i ) const {
+  // Looked up once per graph from its own factor tables, so graphs loaded
+  // from different logic files (or deserialized) share edges exactly
+  // when their factor graphs are equal
+  std::call_once ( data_ -> factorgraph_edges_once_, [&] () {
+    for ( auto const& hexcodes : data_ -> factors_ ) {
+      data_ -> factorgraph_edges_ . push_back ( ParameterGraph_detail::shared_factorgraph_edges ( hexcodes ) );
+    }
+  });
+  return *data_ -> factorgraph_edges_ [ i ];
+}
+
 INLINE_IF_HEADER_ONLY Parameter ParameterGraph::
 parameter ( uint64_t index ) const {
   //std::cout << data_ -> "ParameterGraph::parameter( " << index << " )\n";
@@ -134,7 +343,8 @@ parameter ( uint64_t index ) const {
     logic . push_back ( logic_param );
     order . push_back ( order_param );
   }
-  Parameter result ( logic, order, data_ -> network_ );
+  Parameter result;
+  result . _assign ( logic, order, data_ -> network_, data_ -> box_fill_ );
   return result;
 }
 
@@ -175,6 +385,28 @@ index ( Parameter const& p ) const {
   return (index < size()) ? index : -1;
 }
 
+INLINE_IF_HEADER_ONLY uint64_t ParameterGraph::
+gray_code ( uint64_t k ) const {
+  if ( k >= size () ) {
+    throw std::runtime_error ( "ParameterGraph::gray_code Index out of bounds");
+  }
+  // Digits, least significant first: logic digits then order digits
+  uint64_t D = data_ -> network_ . size ();
+  uint64_t index = 0;
+  uint64_t higher = k;
+  for ( uint64_t i = 0; i < 2*D; ++ i ) {
+    uint64_t base = ( i < D ) ? data_ -> logic_place_bases_ [ i ] : data_ -> order_place_bases_ [ i - D ];
+    uint64_t value = ( i < D ) ? data_ -> logic_place_values_ [ i ] :
+                                 data_ -> order_place_values_ [ i - D ] * data_ -> fixedordersize_;
+    uint64_t digit = higher % base;
+    higher /= base;
+    // Reflect the digit whenever the more significant part is odd
+    if ( higher & 1 ) digit = base - 1 - digit;
+    index += digit * value;
+  }
+  return index;
+}
+
 INLINE_IF_HEADER_ONLY std::vector<uint64_t> ParameterGraph::
 adjacencies ( const uint64_t myindex ) const {
   std::vector<uint64_t> output;
@@ -243,3 +475,46 @@ _factorial ( uint64_t m ) const {
     { 1, 1, 2, 6, 24, 120, 720, 5040, 40320, 362880};
   if ( m < 10 ) return table [ m ]; else return m * _factorial ( m - 1 );
 }
+
+INLINE_IF_HEADER_ONLY void ParameterGraph::
+_tables ( void ) {
+  data_ -> reorderings_ = 1;
+  data_ -> fixedordersize_ = 1;
+  uint64_t D = data_ -> network_ . size ();
+  data_ -> box_fill_ = dsgrn::select_dimension_deferred<Parameter_detail::BoxFill> ( D );
+  for ( uint64_t d = 0; d < D; ++ d ) {
+    uint64_t m = data_ -> network_ . outputs ( d ) . size ();
+    data_ -> order_place_bases_ . push_back ( _factorial ( m ) );
+    data_ -> reorderings_ *= data_ -> order_place_bases_ . back ();
+    std::vector<std::string> const& hex_codes = data_ -> factors_ [ d ];
+    std::unordered_map<std::string,uint64_t> hx;
+    for ( uint64_t i = 0; i < hex_codes . size (); ++ i ) hx [ hex_codes [ i ] ] = i;
+    data_ -> factors_inv_ . push_back ( hx );
+    data_ -> logic_place_bases_ . push_back ( hex_codes . size () );
+    data_ -> fixedordersize_ *= hex_codes . size ();
+    //std::cout << d << ": " << hex_codes . size () << " factorial(" << m << ")=" << _factorial ( m ) << "\n";
+  }
+  data_ -> size_ = data_ -> fixedordersize_ * data_ -> reorderings_;
+  // construction of place_values_ used in method index
+  data_ -> logic_place_values_ . resize ( D, 1 );
+  data_ -> order_place_values_ . resize ( D, 1 );
+  for ( uint64_t i = 1; i < D; ++ i ) {
+    data_ -> logic_place_values_ [ i ] = data_ -> logic_place_bases_ [ i - 1 ] *
+                                   data_ -> logic_place_values_ [ i - 1 ];
+    data_ -> order_place_values_ [ i ] = data_ -> order_place_bases_ [ i - 1 ] *
+                                  data_ -> order_place_values_ [ i - 1 ];
+  }
+}
+
+INLINE_IF_HEADER_ONLY void ParameterGraph::
+_view_tables ( void ) const {
+  std::call_once ( data_ -> view_tables_once_, [&] () {
+    uint64_t D = data_ -> network_ . size ();
+    for ( uint64_t d = 0; d < D; ++ d ) {
+      uint64_t n = data_ -> network_ . inputs ( d ) . size ();
+      uint64_t m = data_ -> network_ . outputs ( d ) . size ();
+      data_ -> logic_bins_ . push_back ( ParameterGraph_detail::logic_bins ( data_ -> factors_ [ d ], n, m ) );
+      data_ -> order_tables_ . push_back ( ParameterGraph_detail::order_table ( m, _factorial ( m ) ) );
+    }
+  });
+}
@@ -7,10 +7,14 @@
 
 #include "common.h"
 #include <random>
+#include <mutex>
 
 #include "Parameter/Network.h"
 #include "Parameter/Parameter.h" 
+#include "Parameter/ParameterGraph.h"
 #include "Parameter/Configuration.h" 
+#include "Parameter/CADDatabase.h"
+#include "Tools/parallel.hpp"
 
 class ParameterSampler {
 public:
@@ -19,45 +23,131 @@ public:
   auto assign(Network) -> void;
   auto sample(Parameter p) const -> std::string;
 
+  /// sample
+  ///   Return "count" samples of the parameter, obtained by running
+  ///   independent Gibbs chains for each network node as one batch.
+  ///   Concurrent calls on the same sampler are serialized.
+  auto sample(Parameter p, uint64_t count) const -> std::vector<std::string>;
+
+  /// variables
+  ///   Return the names of the parameters of the network (e.g. "L[X, Y]"),
+  ///   in sorted order. This is the column order of sample_many.
+  auto variables() const -> std::vector<std::string>;
+
+  /// sample_many
+  ///   Draw "samples_per_index" samples for each of the parameter indices
+  ///   (of the parameter graph of the network) in "parameter_indices", using
+  ///   "num_threads" threads (0 means one per hardware thread).
+  ///   Return a row-major matrix with one column per entry of variables();
+  ///   row k*samples_per_index+s holds sample s of parameter_indices[k].
+  ///   Sample s of parameter index pi is drawn from its own counter-based
+  ///   random stream determined by (seed, pi, s), so the result does not
+  ///   depend on the number of threads or on the other requested indices.
+  ///   This method does not use or change the state of "sample".
+  ///   Throws std::out_of_range if an index is not a parameter index.
+  auto sample_many(
+    std::vector<uint64_t> const& parameter_indices,
+    uint64_t samples_per_index,
+    uint64_t num_threads = 0,
+    uint64_t seed = 0) const
+    ->
+    std::vector<double>;
+
 private:
 
   typedef std::string HexCode;
   typedef std::string Variable;
-  typedef std::map<Variable, double> Instance;
-  typedef std::map<HexCode, Instance> InstanceLookup;
+  /// Instance
+  ///   Values of the variables of a network node, in the order
+  ///   L[1..n], U[1..n], T[1..m] (see CADDatabase::variables)
+  typedef std::vector<double> Instance;
+  /// NamedInstance
+  ///   Values of parameters keyed by name, used for output only
+  typedef std::map<Variable, double> NamedInstance;
+
+  /// Tableau
+  ///   Scratch space of the Gibbs sampler, one per call of "sample" and
+  ///   one per thread of "sample_many".
+  ///   Quantities of the B chains of a batch are stored with the chain
+  ///   index varying fastest, so each update is a loop over chains.
+  struct Tableau {
+    std::vector<uint64_t> lower;        // lower[j] : index of lower threshold of formula j
+    std::vector<uint64_t> upper;        // upper[j] : index of upper threshold of formula j
+    std::vector<double> values;         // values[v*B+b] : variable v of chain b, then T[m] = Inf, T[m+1] = 0
+    std::vector<double> sums;           // sums[(j*K+k)*B+b] : kth factor of formula j
+    std::vector<double> products;       // products[j*B+b] : formula j
+    std::vector<double> cofactor;       // cofactor[j*B+b]
+    std::vector<double> cosum;          // cosum[j*B+b]
+    std::vector<double> min;            // min[b] : lower end of interval of chain b
+    std::vector<double> max;            // max[b] : upper end of interval of chain b
+  };
+
+  /// NodeTables
+  ///   Tables of a network node, built by "assign", so that sampling
+  ///   reads the logic and order digits of a parameter index and no
+  ///   strings. The bins of each logic are those of the parameter graph
+  ///   (see ParameterView).
+  struct NodeTables {
+    std::vector<uint64_t> which_factor;   // which_factor[i] : factor containing L[i]/U[i]
+    std::vector<uint64_t> records;        // records[k] : CAD record of logic index k (-1 if none)
+    std::vector<uint64_t> input_columns;  // input_columns[v] : column of L/U variable v in variables()
+    std::vector<uint64_t> output_columns; // output_columns[o*m+i] : column of T[i] under output order o
+  };
 
   Network network;
-  std::vector<InstanceLookup> instancelookups;
+  /// Parameter graph of "network", indexed by sample_many
+  ParameterGraph parametergraph;
+  std::vector<CADDatabase> databases;
+  std::vector<NodeTables> tables;
   mutable std::default_random_engine generator;
   mutable std::uniform_real_distribution<double> distribution;
+  /// Serializes use of "generator" by "sample"
+  std::shared_ptr<std::mutex> mutex = std::make_shared<std::mutex> ();
 
   /// Gibbs_Sampler
+  ///   Advance B independent chains sampling the region of the logic
+  ///   parameter with logic index "logic" of network node d. values[v*B+b]
+  ///   holds variable v of chain b and is updated in place; uniform(b)
+  ///   must return a uniform draw from [0,1) for chain b.
+  template < class Uniform >
   auto
   Gibbs_Sampler(
-    HexCode const& hex, 
-    uint64_t n, 
-    uint64_t m,
-    std::vector<std::vector<uint64_t>> logic,
-    Instance const& initial) const
+    uint64_t d,
+    uint64_t logic,
+    uint64_t B,
+    double * values,
+    Uniform && uniform,
+    Tableau & tableau) const
+    ->
+    void;
+
+  /// Seed_Chains
+  ///   Set the B chains of node d to the CAD record of logic index "logic"
+  auto
+  Seed_Chains(
+    uint64_t d,
+    uint64_t logic,
+    uint64_t B,
+    std::vector<double> & values) const
     ->
-    Instance;
+    void;
 
   /// Name_Parameters
   ///   Given a parameter node and chosen instances for each network node
   ///   determine the parameter names corresponding to each parameter in the instances
-  ///   and construct a Instance suitable for export
+  ///   and construct a NamedInstance suitable for export
   auto
   Name_Parameters(
     Parameter const& p,
     std::vector<Instance> const& instances) const
     -> 
-    Instance;
+    NamedInstance;
 
   /// InstanceToString
   ///   Make a string from an instance
   auto
   InstanceToString(
-    Instance const& instance) const 
+    NamedInstance const& instance) const 
     -> 
     std::string;
 };
@@ -66,6 +156,7 @@ private:
 
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <pybind11/numpy.h>
 namespace py = pybind11;
 
 inline void
@@ -73,5 +164,21 @@ ParameterSamplerBinding (py::module &m) {
   py::class_<ParameterSampler, std::shared_ptr<ParameterSampler>>(m, "ParameterSampler")
     .def(py::init<>())
     .def(py::init<Network>())
-    .def("sample", &ParameterSampler::sample);
+    .def("sample", (std::string (ParameterSampler::*)(Parameter) const) &ParameterSampler::sample, py::call_guard<py::gil_scoped_release>())
+    .def("sample", (std::vector<std::string> (ParameterSampler::*)(Parameter, uint64_t) const) &ParameterSampler::sample, py::call_guard<py::gil_scoped_release>())
+    .def("variables", &ParameterSampler::variables)
+    .def("sample_many", [](ParameterSampler const& sampler, std::vector<uint64_t> const& parameter_indices,
+                           uint64_t samples_per_index, uint64_t num_threads, uint64_t seed) {
+      // Returns a numpy array of shape (len(parameter_indices)*samples_per_index, len(variables()))
+      std::vector<double> values;
+      {
+        py::gil_scoped_release release;
+        values = sampler . sample_many ( parameter_indices, samples_per_index, num_threads, seed );
+      }
+      std::vector<ssize_t> shape = { (ssize_t) ( parameter_indices . size () * samples_per_index ),
+                                     (ssize_t) sampler . variables () . size () };
+      py::array_t<double> result ( shape );
+      std::copy ( values . begin (), values . end (), result . mutable_data () );
+      return result;
+    }, py::arg("parameter_indices"), py::arg("samples_per_index"), py::arg("num_threads") = 0, py::arg("seed") = 0);
 }
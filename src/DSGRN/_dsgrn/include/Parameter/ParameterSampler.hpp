@@ -8,6 +8,38 @@
 
 #include "ParameterSampler.h"
 
+namespace ParameterSampler_detail {
+  /// mix
+  ///   SplitMix64 finalizer; a bijective hash of 64-bit integers
+  inline uint64_t
+  mix ( uint64_t x ) {
+    x = ( x ^ ( x >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+    x = ( x ^ ( x >> 27 ) ) * 0x94D049BB133111EBULL;
+    return x ^ ( x >> 31 );
+  }
+
+  /// Stream
+  ///   Counter-based random stream: the kth draw of the stream with key K
+  ///   is a hash of (K, k), so streams can be created and advanced
+  ///   independently on any thread
+  struct Stream {
+    uint64_t key;
+    uint64_t counter;
+    Stream ( uint64_t seed, uint64_t index, uint64_t sample ) :
+      key ( mix ( mix ( mix ( seed ) ^ index ) ^ sample ) ), counter ( 0 ) {}
+    /// uniform
+    ///   Return the next draw, uniform in [0,1)
+    double uniform ( void ) {
+      uint64_t x = mix ( key + 0x9E3779B97F4A7C15ULL * ++ counter );
+      return ( x >> 11 ) * ( 1.0 / 9007199254740992.0 );
+    }
+  };
+
+  /// no_record
+  ///   Entry of NodeTables::records for hex codes without a CAD record
+  static const uint64_t no_record = -1;
+}
+
 inline
 ParameterSampler::ParameterSampler (){}
 
@@ -26,15 +58,17 @@ ParameterSampler::assign
   void
 {
   network = network_arg;
+  parametergraph = ParameterGraph ( network );
   distribution = std::uniform_real_distribution<double>(0.0,1.0);
 
-  //std::cout << "Loading databases.\n";
-  std::vector<json> CAD_Databases;
   // Obtain folder path containing CAD databases
   std::string path = configuration() -> get_path() + "/CAD";
 
-  // Load the CAD databases one by one
+  // Load the CAD database of each network node. Databases are shared
+  // between samplers, and binary (.cad) databases are memory-mapped
+  // so only the records of hex codes actually sampled are read.
   uint64_t D = network . size ();
+  databases . clear ();
   for ( uint64_t d = 0; d < D; ++ d ) {
     // Construct CAD database file name for network node
     uint64_t n = network . inputs ( d ) . size ();
@@ -43,51 +77,80 @@ ParameterSampler::assign
     std::stringstream ss;
     ss << path << "/" << n <<  "_" << m;
     for ( auto const& p : logic_struct ) ss <<  "_" << p.size();
-    ss << ".json";
-    // Make a new json object to store the file into
-    CAD_Databases . push_back ( json () );
-    json & J = CAD_Databases . back ();
-    // Load the file into the json object
-    std::cout << "Reading " << ss.str () << "\n";
-    std::ifstream infile (ss.str());
-    if ( not infile.good() ) {
-      throw std::runtime_error("Missing CAD database " + ss.str() );
-    }
-    infile >> J;
-    infile.close();
-    //std::cout << "File read.\n";
+    databases . push_back ( LoadCADDatabase ( ss.str () ) );
   }
-  //std::cout << "Databases loaded.\n";
 
-  instancelookups.resize(D);
+  // Build the tables of each node. Hex codes and variable names are
+  // looked up here once, so sampling works with integer indices only.
+  parametergraph . _view_tables ();
+  ParameterGraph_ const& graph = *parametergraph . data_;
+  std::vector<std::string> names = variables ();
+  std::unordered_map<std::string, uint64_t> column;
+  for ( uint64_t c = 0; c < names . size (); ++ c ) column [ names[c] ] = c;
+  tables . assign ( D, NodeTables () );
   for ( uint64_t d = 0; d < D; ++ d ) {
-    for ( auto const& entry : CAD_Databases[d] ) {
-      // Obtain hex code from database entry
-      std::string hex = entry["Hex"];
-      // Obtain instance from database entry
-      Instance instance;
-      auto json_instance = entry["Instance"];
-      for (json::iterator it = json_instance.begin();
-           it != json_instance.end(); 
-           ++it) 
-      {
-        instance[it.key()] = it.value();
+    NodeTables & table = tables[d];
+    uint64_t n = network . inputs ( d ) . size ();
+    uint64_t m = network . outputs ( d ) . size ();
+    std::vector<std::vector<uint64_t>> const& logic_struct = network . logic ( d );
+    for ( uint64_t k = 0; k < logic_struct . size (); ++ k ) {
+      for ( uint64_t t = 0; t < logic_struct [ k ] . size (); ++ t ) table . which_factor . push_back ( k );
+    }
+    for ( std::string const& hex : graph . factors_ [ d ] ) {
+      uint64_t record = ParameterSampler_detail::no_record;
+      try {
+        record = databases [ d ] . index ( hex );
+      } catch ( std::out_of_range const& ) {}
+      table . records . push_back ( record );
+    }
+    std::string const& name = network . name ( d );
+    for ( uint64_t v = 0; v < 2 * n; ++ v ) {
+      std::string const& input_name = network . name ( network . inputs ( d ) [ v % n ] );
+      table . input_columns . push_back ( column . at ( ( v < n ? "L[" : "U[" ) + input_name + ", " + name + "]" ) );
+    }
+    uint8_t const* permutations = graph . order_tables_ [ d ] . data ();
+    for ( uint64_t o = 0; o < graph . order_place_bases_ [ d ]; ++ o ) {
+      for ( uint64_t i = 0; i < m; ++ i ) {
+        std::string const& output_name = network . name ( network . outputs ( d ) [ permutations [ 2 * m * o + i ] ] );
+        table . output_columns . push_back ( column . at ( "T[" + name + ", " + output_name + "]" ) );
       }
-      // Enter instance lookup table entry
-      instancelookups[d][hex] = instance;
     }
   }
 }
 
+inline auto
+ParameterSampler::Seed_Chains
+  (uint64_t d,
+   uint64_t logic,
+   uint64_t B,
+   std::vector<double> & values) const
+  ->
+  void
+{
+  uint64_t record = tables [ d ] . records [ logic ];
+  if ( record == ParameterSampler_detail::no_record ) {
+    throw std::out_of_range ( "ParameterSampler: no CAD record for hex code " +
+                              parametergraph . factorgraph ( d ) [ logic ] );
+  }
+  double const* instance = databases [ d ] . instance ( record );
+  uint64_t V = 2 * network . inputs ( d ) . size () + network . outputs ( d ) . size ();
+  values . resize ( V * B );
+  for ( uint64_t v = 0; v < V; ++ v ) {
+    std::fill ( values.begin() + v * B, values.begin() + (v+1) * B, instance[v] );
+  }
+}
+
+template < class Uniform >
 inline auto
 ParameterSampler::Gibbs_Sampler
-  (ParameterSampler::HexCode const& hex, 
-   uint64_t n, 
-   uint64_t m,
-   std::vector<std::vector<uint64_t>> logic,
-   ParameterSampler::Instance const& initial ) const
+  (uint64_t d,
+   uint64_t logic,
+   uint64_t B,
+   double * values,
+   Uniform && uniform,
+   ParameterSampler::Tableau & tableau ) const
   ->
-  ParameterSampler::Instance
+  void
 {
   // The basic idea of the algorithm is as follows.
   // We have 2^n formulas of the form (L[1])(L[2]+U[3]) (for various U/L combinations)
@@ -102,246 +165,151 @@ ParameterSampler::Gibbs_Sampler
   // following manner:
   //     c < a*(b+x) < d  --> c/a-b < x < d/a - b
   //     Here a is the "coproduct" and "b" is the "cosum"
+  // Every quantity below is kept for all B chains at once, so the innermost
+  // loops run over chains.
   
+  uint64_t n = network . inputs ( d ) . size ();
+  uint64_t m = network . outputs ( d ) . size ();
   uint64_t N = 1 << n;
-  uint64_t K = logic . size ();
-
-  // std::cout << "\nGibbsSampler\n";
-  // std::cout << "n = " << n << "\n";
-  // std::cout << "m = " << n << "\n";
-  // std::cout << "N = " << N << "\n";
-  // std::cout << "K = " << K << "\n";
+  uint64_t K = network . logic ( d ) . size ();
+  uint64_t V = 2 * n + m;
+  uint64_t const* which_factor = tables [ d ] . which_factor . data ();
+  // bins[j] : bin of formula j, i.e. the number of consecutive set bits of
+  //   the logic parameter starting at bit j*m
+  uint8_t const* bins = parametergraph . data_ -> logic_bins_ [ d ] . data () + ( logic << n );
 
   const double Inf = std::numeric_limits<double>::infinity();
 
   // expsample
   //   Sample according to exponential distribution conditioned on being
-  //   in the interval pair = (min, max)
-  auto expsample = [this](std::pair<double,double> const& pair) {
-      double A = std::exp(-pair.first);
-      double B = std::exp(-pair.second);
-      double mu = distribution(generator);
-      //std::cout << "expsample([" << pair.first << ", " << pair.second << "]) = " << -std::log(A - mu *(A-B)) << "\n";
-      double result = -std::log(A - mu *(A-B));
-      // if ( result < pair.first || result > pair.second ) {
-      //   throw std::logic_error("expsample did not return a value within bounds");
-      // }
-      return result;
+  //   in the interval (min, max), given a uniform draw mu
+  auto expsample = [](double min, double max, double mu) {
+    double A = std::exp(-min);
+    double B = std::exp(-max);
+    return -std::log(A - mu *(A-B));
   };
 
-  // Read initial instance into faster data structure
-  std::vector<double> L ( n );
-  std::vector<double> U ( n );
-  std::vector<double> T ( m );
-  for ( auto const& pair : initial ) {
-    uint64_t i = std::stoll(pair.first.substr(2,pair.first.size()-3));
-    switch ( pair.first[0] ) {
-      case 'L':
-        L[i-1] = pair.second;
-        break;
-      case 'U':
-        U[i-1] = pair.second;
-        break;
-      case 'T':
-        T[i-1] = pair.second;
-        break;
-    }
-  }
-
-  // Initialize "computational tableau" to enable rapid iterations
-  //   which_factor[i] : which factor the ith L (or U) variable is in
-  //   sums[j][k]      : the sum of the terms of the kth factor in the jth L/U formula
-  //   products[j]     : the product of factors in the jth L/U formula
-  //   lower[j]        : threshold that is the greatest lower bound of the jth L/U formula. m+1 indicates no lower bound
-  //   upper[j]        : threshold that is the least upper bound  of the jth L/U formula. m indicates no upper bound
-  //   We set T[m] = Inf and T[m+1] = 0 so T[lower[j]] and T[[upper[j]] reflect lack of lower and upper bounds properly
-  std::vector<uint64_t> which_factor;
-  std::vector<std::vector<double>> sums;
-  std::vector<double> products;
-  std::vector<uint64_t> lower;
-  std::vector<uint64_t> upper;
+  // Copy the chains into the tableau, followed by T[m] = Inf and T[m+1] = 0 
+  // so T[lower[j]] and T[upper[j]] reflect lack of lower and upper bounds properly
+  tableau . values . resize ( ( V + 2 ) * B );
+  double * X = tableau . values . data ();
+  std::copy ( values, values + V * B, X );
+  std::fill ( X + V * B, X + ( V + 1 ) * B, Inf );
+  std::fill ( X + ( V + 1 ) * B, X + ( V + 2 ) * B, 0.0 );
+  double * L = X;
+  double * U = X + n * B;
+  double * T = X + 2 * n * B;
 
-  // Compute "which_factor"
-  // std::cout << "Compute which_factor (maps variable index to formula factor).\n";
-  which_factor . resize ( n );
-  {
-    uint64_t i = 0;
-    for ( uint64_t k = 0; k < K; ++ k ) {
-      // std::cout << "  Inspecting factor " << k << "\n";
-      uint64_t num_terms = logic [ k ] . size ();
-      // std::cout << "    There are " << num_terms << " summands in this factor\n";
-      uint64_t start = i;
-      uint64_t stop = i + num_terms;
-      for ( uint64_t j = start; j < stop; ++ j ) {
-        // std::cout << "  Assigning variable " << j << " to factor " << k << "\n";
-        // std::cout << "  e.g. which_factor[" << j << "] <- " << k << "\n";
-        which_factor[j] = k;
-      }
-      i = stop;
-    }
+  // Compute "lower" and "upper"
+  //   lower[j] : threshold that is the greatest lower bound of the jth L/U formula. m+1 indicates no lower bound
+  //   upper[j] : threshold that is the least upper bound  of the jth L/U formula. m indicates no upper bound
+  tableau . lower . resize ( N );
+  tableau . upper . resize ( N );
+  uint64_t * lower = tableau . lower . data ();
+  uint64_t * upper = tableau . upper . data ();
+  for ( uint64_t j = 0; j < N; ++ j ) {
+    uint64_t bin = bins [ j ];
+    lower[j] = (bin == 0) ? m+1 : bin - 1;
+    upper[j] = bin;
   }
 
-  // Compute "sums"
-  // std::cout << "Compute sums.\n";
-  sums . resize ( N, std::vector<double>(K, 0.0));;
+  // Compute "sums" and "products"
+  //   sums[j][k]  : the sum of the terms of the kth factor in the jth L/U formula
+  //   products[j] : the product of factors in the jth L/U formula
+  tableau . sums . assign ( N * K * B, 0.0 );
+  tableau . products . assign ( N * B, 1.0 );
+  tableau . cofactor . resize ( N * B );
+  tableau . cosum . resize ( N * B );
+  tableau . min . resize ( B );
+  tableau . max . resize ( B );
+  double * sums = tableau . sums . data ();
+  double * products = tableau . products . data ();
+  double * cofactor = tableau . cofactor . data ();
+  double * cosum = tableau . cosum . data ();
+  double * min = tableau . min . data ();
+  double * max = tableau . max . data ();
   for ( uint64_t j = 0; j < N; ++ j ) {
-    uint64_t bit = 1;
     for ( uint64_t i = 0; i < n; ++ i ) {
-      // std::cout << "  variable " << i << " is in factor " << which_factor[i] << "\n";
-      sums[j][which_factor[i]] += ( j & bit ) ? U[i] : L[i];
-      bit <<= 1;
-      // std::cout << "  sums[" << j << "][" << which_factor[i] << "] = " << sums[j][which_factor[i]] << "\n";
+      double * s = sums + ( j * K + which_factor[i] ) * B;
+      double const* x = ( j & (1 << i) ) ? U + i * B : L + i * B;
+      for ( uint64_t b = 0; b < B; ++ b ) s[b] += x[b];
     }
-  }
-
-  // Compute "products"
-  // std::cout << "Compute products.\n";
-  products . resize ( N, 1.0 );
-  for ( uint64_t j = 0; j < N; ++ j ) {
-    // std::cout << "  products[" << j << "] = " << products[j] << "\n";
+    double * p = products + j * B;
     for ( uint64_t k = 0; k < K; ++ k ) {
-      // std::cout << "    update via factor " << k << " with sums[" << j << "][" << k << "] = " << sums[j][k] << "\n";
-      products[j] *= sums[j][k]; 
-      // std::cout << "    products[" << j << "] <- " << products[j] << "\n";
+      double const* s = sums + ( j * K + k ) * B;
+      for ( uint64_t b = 0; b < B; ++ b ) p[b] *= s[b];
     }
-    // std::cout << "  products[ " << j << "] <- " << products[j] << "\n";
   }
 
-  // Compute "lower" and "upper"
-  lower . resize ( N );
-  upper . resize ( N );
-  LogicParameter lp ( n, m, hex );
-  // std::cout << "Scanning lower and upper threshold indices for each equation.\n";
-  for ( uint64_t j = 0; j < N; ++ j ) {
-    uint64_t bin = lp . bin ( j );
-    lower[j] = (bin == 0) ? m+1 : bin - 1;
-    upper[j] = bin;
-    // std::cout << " inequality " << j << " : bin = " << bin << " lower = " << lower[j]+1 << " and upper = " << upper[j]+1 << "\n";
-  }
-  // Add special values to T so T[lower[j]] and T[[upper[j]] give what we want
-  T . push_back ( Inf ); // T[m]
-  T . push_back ( 0.0 ); // T[m+1]
-
-  // Temporary storage variables
-  std::vector<double> cofactor(N);
-  std::vector<double> cosum(N);
-
-  typedef std::pair<double,double> Interval;
+  // Resample variable "var" (in factor k) of every chain, given the interval
+  // [min, max] from its own constraints.
   // Note: we use a mask/bit arguments to filter out all inequalities where we have L[i] instead of U[i]
   //       or vice-versa as the case requires
-  auto scan = [&](Interval & interval, uint64_t k, uint64_t mask, uint64_t bit, double var) {
-    double & min = interval.first;
-    double & max = interval.second;
-    // std::cout << "Scanning with initial interval (" << min << ", " << max << "), factor index = " 
-              // << k << ", mask = " << mask << ", bit = " << bit << ", var = " << var << "\n";
+  auto update = [&](uint64_t k, uint64_t mask, uint64_t bit, double * var) {
+    // Intersect with the interval allowed by each inequality
     for ( uint64_t j = 0; j < N; ++ j ) {
       if ( (j & mask) != bit ) continue; 
-      // std::cout << "  inequality " << j << "\n";
-      cofactor[j] = products[j]/sums[j][k];
-      cosum[j] = sums[j][k] - var;
-      // std::cout << "    Lower threshold = " << T[lower[j]] << "\n";
-      // std::cout << "    Upper threshold = " << T[upper[j]] << "\n";
-      // std::cout << "    cofactor["<<j<<"] = " << cofactor[j] << "\n";
-      // std::cout << "    cosum["<<j<<"] = " << cosum[j] << "\n";
-      // std::cout << "    products["<<j<<"] = " << products[j] << "\n";
-      // std::cout << "    sums["<<j<<","<<k<<"] = " << sums[j][k] << "\n";
-      // std::cout << "    var = " << var << "\n";
-      // std::cout << "    Intersecting with (" << T[lower[j]]/cofactor[j] - cosum[j] << ", " << T[upper[j]]/cofactor[j] - cosum[j] << ")\n";
-      min = std::max ( min, T[lower[j]]/cofactor[j] - cosum[j]);
-      max = std::min ( max, T[upper[j]]/cofactor[j] - cosum[j]);
+      double const* s = sums + ( j * K + k ) * B;
+      double const* p = products + j * B;
+      double const* lo = T + lower[j] * B;
+      double const* hi = T + upper[j] * B;
+      double * cf = cofactor + j * B;
+      double * cs = cosum + j * B;
+      for ( uint64_t b = 0; b < B; ++ b ) {
+        cf[b] = p[b]/s[b];
+        cs[b] = s[b] - var[b];
+        min[b] = std::max ( min[b], lo[b]/cf[b] - cs[b]);
+        max[b] = std::min ( max[b], hi[b]/cf[b] - cs[b]);
+      }
     }
-    // std::cout << "  returning with interval (" << min << ", " << max << ")\n";
-  };
-  auto fix = [&](uint64_t k, uint64_t mask, uint64_t bit, double var) {
+    for ( uint64_t b = 0; b < B; ++ b ) var[b] = expsample ( min[b], max[b], uniform ( b ) );
+    // Fix the sums and products of the inequalities involving the variable
     for ( uint64_t j = 0; j < N; ++ j ) {
       if ( (j & mask) != bit ) continue; 
-      // std::cout << "fix: inequality " << j << "\n";
-      sums[j][k] = cosum[j] + var;
-      products[j] = cofactor[j] * sums[j][k];
-      // std::cout << "  products["<<j<<"] = " << products[j] << "\n";
-      // std::cout << "  sums["<<j<<","<<k<<"] = " << sums[j][k] << "\n";
+      double * s = sums + ( j * K + k ) * B;
+      double * p = products + j * B;
+      double const* cf = cofactor + j * B;
+      double const* cs = cosum + j * B;
+      for ( uint64_t b = 0; b < B; ++ b ) {
+        s[b] = cs[b] + var[b];
+        p[b] = cf[b] * s[b];
+      }
     }
   };
+
   int burn_in_limit = 10;
   for ( uint64_t burn_in = 0; burn_in < burn_in_limit; ++ burn_in ) {
-    // std::cout << "===== round = " << burn_in << "\n";
-
-    // // j indices LUT formulas, of which there are N := 2^n of. 
-    // for ( uint64_t j = 0; j < N; ++ j ) {
-    //   std::cout << "j = " << j << "\n";
-    //   std::cout << "  lower threshold printindex for ineq j = " << lower[j]+1 << "\n";
-    //   std::cout << "  upper threshold printindex for ineq j = " << upper[j]+1 << "\n";
-
-    //   std::cout << "  T["<<lower[j] + 1 << "] = " << T[lower[j]] << " ";
-    //   for ( uint64_t i = 0; i < n; ++ i ) {
-    //     if ( ( j & (1 << i)) == 0 ) {
-    //       std::cout << "L[" << i+1 << "] = " << L[i] << " ";
-    //     } else {
-    //       std::cout << "U[" << i+1 << "] = " << U[i] << " ";
-    //     }
-    //   }
-    //   std::cout << "T["<<upper[j] + 1 << "] = " << T[upper[j]] << "\n";
-    // }
-
-    // Update L's
+    // Update L's: 0 < L[i] < U[i]
     for ( uint64_t i = 0; i < n; ++ i ) {
-      uint64_t k = which_factor[i];
-      Interval interval = {0, U[i]};
-      // std::cout << "L[" << i+1 << "] update (current value is " << L[i] << ")\n";
-      // std::cout << "  Initial interval is 0 < L[" << i+1 << "] < U[" << i+1 << "] which gives (" << 0 << ", " << U[i] << ")\n";
-      scan(interval, k, 1 << i, 0, L[i]);
-      // std::cout << "  Fixing all other variables gives L[" << i+1 << "] in (" << interval.first << ", " << interval.second << ")\n";
-      L[i] = expsample(interval);
-      // std::cout << "  Updating L[" << i+1 << "] <- " << L[i] << "\n";
-      fix(k, 1 << i, 0, L[i]);
+      std::fill ( min, min + B, 0.0 );
+      std::copy ( U + i * B, U + ( i + 1 ) * B, max );
+      update ( which_factor[i], 1 << i, 0, L + i * B );
     }
-    // Update U's
+    // Update U's: L[i] < U[i] < Inf
     for ( uint64_t i = 0; i < n; ++ i ) {
-      uint64_t k = which_factor[i];
-      Interval interval = {L[i], Inf};
-      // std::cout << "U[" << i+1 << "] update (current value is " << U[i] << ")\n";
-      // std::cout << "  Initial interval is L[" << i+1 << "] < U[" << i+1 << "] < inf which gives (" << U[i] << ", inf )\n";
-      scan(interval, k, 1 << i, 1 << i, U[i]);
-      // std::cout << "  Fixing all other variables gives gives U[" << i+1 << "]  (" << interval.first << ", " << interval.second << ")\n";
-      U[i] = expsample(interval);
-      // std::cout << "  Updating U[" << i+1 << "] <- " << U[i] << "\n";
-      fix(k, 1 << i, 1 << i, U[i]);
+      std::copy ( L + i * B, L + ( i + 1 ) * B, min );
+      std::fill ( max, max + B, Inf );
+      update ( which_factor[i], 1 << i, 1 << i, U + i * B );
     }
-    // Update T's
+    // Update T's: T[i-1] < T[i] < T[i+1], and T[i] separates the formulas
+    // binned below it from those binned above it
     for ( uint64_t i = 0; i < m; ++ i ) {
-      Interval interval;
-      double & min = interval.first;
-      double & max = interval.second;
-      min = ( i == 0 ) ? 0.0 : T[i-1];
-      max = ( i == (m-1) ) ? Inf : T[i+1];
-      // std::cout << "T[" << (i+1) << "] (currently = " << T[i] << ")\n";
-      // std::cout << "  Initial interval is  ( T[" << i << "] = " << min << ", T[" << i+2 << "] = " << max << ")\n";
+      if ( i == 0 ) std::fill ( min, min + B, 0.0 ); else std::copy ( T + (i-1) * B, T + i * B, min );
+      if ( i == m-1 ) std::fill ( max, max + B, Inf ); else std::copy ( T + (i+1) * B, T + (i+2) * B, max );
       for ( uint64_t j = 0; j < N; ++ j ) {
+        double const* p = products + j * B;
         if ( lower[j] == i ) { 
-          // std::cout << "  Intersecting with (0, " << products[j] << ") due to inequality " << j << "\n";
-          max = std::min(max,products[j]);
+          for ( uint64_t b = 0; b < B; ++ b ) max[b] = std::min(max[b],p[b]);
         }
         if ( upper[j] == i ) { 
-          // std::cout << "  Intersecting with (" << products[j] << ", inf) due to inequality " << j << "\n";
-          min = std::max(min,products[j]);
+          for ( uint64_t b = 0; b < B; ++ b ) min[b] = std::max(min[b],p[b]);
         }
       }
-      // std::cout << "  Constraints give interval is  [T[" << i << "] in (" << min << ", " << max << ")\n";
-      T[i] = expsample(interval);
-      // std::cout << "  T[" << (i+1) << "] <- " << T[i] << "\n";
+      double * t = T + i * B;
+      for ( uint64_t b = 0; b < B; ++ b ) t[b] = expsample ( min[b], max[b], uniform ( b ) );
     }
   }
-  // Create Instance object containing result
-  Instance result;
-  for ( uint64_t i = 0; i < n; ++ i ) {
-    result["L[" + std::to_string(i+1) + "]"] = L[i];
-    result["U[" + std::to_string(i+1) + "]"] = U[i];
-  }
-  for ( uint64_t i = 0; i < m; ++ i ) {
-    result["T[" + std::to_string(i+1) + "]"] = T[i];
-  }
-  // std::cout << "DEBUG: Check this. Hex = " << hex << " and " << InstanceToString(result) << "\n";
-  return result;
+  std::copy ( X, X + V * B, values );
 }
 
 inline auto
@@ -349,11 +317,11 @@ ParameterSampler::Name_Parameters
   (Parameter const& p,
    std::vector<Instance> const& instances) const
   ->
-  ParameterSampler::Instance 
+  ParameterSampler::NamedInstance 
 {
   uint64_t D = network . size ();
   std::vector<OrderParameter> const& order = p . order ();
-  Instance result;
+  NamedInstance result;
   for ( uint64_t d = 0; d < D; ++ d ) {
     Instance const& instance = instances[d];
     std::string const& name = network . name ( d );
@@ -362,15 +330,15 @@ ParameterSampler::Name_Parameters
     for ( uint64_t i = 0; i < n; ++ i ) {
       uint64_t input = network . inputs(d) [ i ];
       std::string const& input_name = network . name ( input );
-      result[ "L[" + input_name + ", " + name + "]" ] = instance . at ("L[" + std::to_string(i+1) + "]");
-      result[ "U[" + input_name + ", " + name + "]" ] = instance . at ("U[" + std::to_string(i+1) + "]");
+      result[ "L[" + input_name + ", " + name + "]" ] = instance [ i ];
+      result[ "U[" + input_name + ", " + name + "]" ] = instance [ n + i ];
     }
     // Handle output parameter (i.e. T)
     uint64_t m = network . outputs ( d ) . size ();
     for ( uint64_t i = 0; i < m; ++ i ) {
       uint64_t output = network . outputs(d) [ order[d](i) ];
       std::string const& output_name = network . name ( output );
-      result[ "T[" + name + ", " + output_name + "]" ] = instance . at ("T[" + std::to_string(i+1) + "]");
+      result[ "T[" + name + ", " + output_name + "]" ] = instance [ 2 * n + i ];
     }
   }
   return result;
@@ -378,7 +346,7 @@ ParameterSampler::Name_Parameters
 
 inline auto
 ParameterSampler::InstanceToString
-  (ParameterSampler::Instance const& instance ) const 
+  (ParameterSampler::NamedInstance const& instance ) const 
   ->
   std::string 
 {
@@ -400,28 +368,133 @@ ParameterSampler::sample
   ->
   std::string
 {
+  return sample ( p, 1 ) [ 0 ];
+}
+
+inline auto
+ParameterSampler::sample
+  (Parameter p, uint64_t count) const
+  ->
+  std::vector<std::string>
+{
+  std::lock_guard<std::mutex> lock ( *mutex );
   uint64_t D = network . size ();
   std::vector<LogicParameter> const& logic = p . logic ();
-  // Loop through network nodes and extract a sample
-  std::vector<Instance> instances;
+  ParameterGraph_ const& graph = *parametergraph . data_;
+  // instances[b][d] is the instance of network node d in sample b
+  std::vector<std::vector<Instance>> instances ( count, std::vector<Instance> ( D ) );
+  std::vector<double> values;
+  Tableau tableau;
+  // Loop through network nodes and extract samples
   for ( uint64_t d = 0; d < D; ++ d ) {
-    // Obtain hex code
+    // Obtain logic index
     HexCode const& hex = logic[d].hex();
-    // Obtain initial instance to seed Gibbs sampling with
-    Instance const& instance = instancelookups[d].at(hex);
+    auto it = graph . factors_inv_ [ d ] . find ( hex );
+    if ( it == graph . factors_inv_ [ d ] . end () ) {
+      throw std::out_of_range ( "ParameterSampler::sample: hex code " + hex + " is not in the factor graph" );
+    }
+    uint64_t V = 2 * network.inputs(d).size() + network.outputs(d).size();
+    // Seed every chain with the instance from the CAD database
+    Seed_Chains ( d, it -> second, count, values );
     // Perform Gibbs sampling
-    Instance sampled = Gibbs_Sampler ( hex, 
-                                       network.inputs(d).size(), 
-                                       network.outputs(d).size(), 
-                                       network.logic(d),
-                                       instance );
+    Gibbs_Sampler ( d, it -> second, count, values.data(),
+                    [this](uint64_t) { return distribution(generator); }, tableau );
     // Record parameters for network node
-    instances . push_back ( sampled );
+    for ( uint64_t b = 0; b < count; ++ b ) {
+      Instance & instance = instances[b][d];
+      instance . resize ( V );
+      for ( uint64_t v = 0; v < V; ++ v ) instance[v] = values[v * count + b];
+    }
   }
-  // Combine instances into single instance with named parameters
-  Instance named_parameters = Name_Parameters ( p, instances );
-  // Output
-  std::stringstream ss;
-  ss << "{\"Parameter\":" << InstanceToString(named_parameters) << "}";
-  return ss . str ();
+  // Combine instances into single instances with named parameters and output
+  std::vector<std::string> result;
+  for ( uint64_t b = 0; b < count; ++ b ) {
+    NamedInstance named_parameters = Name_Parameters ( p, instances[b] );
+    std::stringstream ss;
+    ss << "{\"Parameter\":" << InstanceToString(named_parameters) << "}";
+    result . push_back ( ss . str () );
+  }
+  return result;
+}
+
+inline auto
+ParameterSampler::variables
+  () const
+  ->
+  std::vector<std::string>
+{
+  std::vector<std::string> result;
+  uint64_t D = network . size ();
+  for ( uint64_t d = 0; d < D; ++ d ) {
+    std::string const& name = network . name ( d );
+    for ( uint64_t input : network . inputs ( d ) ) {
+      result . push_back ( "L[" + network . name ( input ) + ", " + name + "]" );
+      result . push_back ( "U[" + network . name ( input ) + ", " + name + "]" );
+    }
+    for ( uint64_t output : network . outputs ( d ) ) {
+      result . push_back ( "T[" + name + ", " + network . name ( output ) + "]" );
+    }
+  }
+  std::sort ( result . begin (), result . end () );
+  return result;
+}
+
+inline auto
+ParameterSampler::sample_many
+  (std::vector<uint64_t> const& parameter_indices,
+   uint64_t samples_per_index,
+   uint64_t num_threads,
+   uint64_t seed) const
+  ->
+  std::vector<double>
+{
+  using ParameterSampler_detail::Stream;
+  for ( uint64_t pi : parameter_indices ) {
+    if ( pi >= parametergraph . size () ) {
+      throw std::out_of_range ( "ParameterSampler::sample_many: parameter index " + std::to_string ( pi ) + " out of bounds" );
+    }
+  }
+  uint64_t D = network . size ();
+  uint64_t B = samples_per_index;
+  // One column per variable of each node (see variables)
+  uint64_t C = 0;
+  for ( uint64_t d = 0; d < D; ++ d ) C += 2 * network . inputs ( d ) . size () + network . outputs ( d ) . size ();
+  ParameterGraph_ const& graph = *parametergraph . data_;
+  std::vector<double> result ( parameter_indices . size () * B * C );
+  uint64_t T = ( num_threads == 0 ) ? dsgrn::hardware_threads () : num_threads;
+  // Per-thread scratch space
+  std::vector<Tableau> tableaux ( T );
+  std::vector<std::vector<double>> buffers ( T );
+  std::vector<std::vector<Stream>> streams ( T );
+  dsgrn::parallel_for ( 0, parameter_indices . size (), T, 1, [&](uint64_t thread, uint64_t k) {
+    uint64_t pi = parameter_indices[k];
+    // The logic and order digits of each node are read off the index
+    // as it is sampled (see ParameterView)
+    uint64_t logic_index = pi % graph . fixedordersize_;
+    uint64_t order_index = pi / graph . fixedordersize_;
+    std::vector<double> & values = buffers[thread];
+    std::vector<Stream> & stream = streams[thread];
+    stream . clear ();
+    for ( uint64_t s = 0; s < B; ++ s ) stream . push_back ( Stream ( seed, pi, s ) );
+    double * rows = result . data () + k * B * C;
+    for ( uint64_t d = 0; d < D; ++ d ) {
+      uint64_t logic = logic_index % graph . logic_place_bases_ [ d ];
+      logic_index /= graph . logic_place_bases_ [ d ];
+      uint64_t order = order_index % graph . order_place_bases_ [ d ];
+      order_index /= graph . order_place_bases_ [ d ];
+      uint64_t n = network.inputs(d).size();
+      uint64_t m = network.outputs(d).size();
+      Seed_Chains ( d, logic, B, values );
+      Gibbs_Sampler ( d, logic, B, values.data(),
+                      [&](uint64_t b) { return stream[b] . uniform (); }, tableaux[thread] );
+      // Scatter variables of the node into their columns
+      NodeTables const& table = tables[d];
+      uint64_t const* output_columns = table . output_columns . data () + order * m;
+      for ( uint64_t v = 0; v < 2 * n + m; ++ v ) {
+        uint64_t c = ( v < 2 * n ) ? table . input_columns [ v ] : output_columns [ v - 2 * n ];
+        for ( uint64_t b = 0; b < B; ++ b ) rows [ b * C + c ] = values [ v * B + b ];
+      }
+    }
+  });
+  return result;
 }
@@ -0,0 +1,161 @@
+/// ParameterView.h
+/// Shaun Harker
+/// 2018-11-21
+/// MIT LICENSE
+
+#pragma once
+
+#include "common.h"
+
+#include <array>
+
+#include "Phase/Domain.h"
+#include "Parameter/Network.h"
+#include "Parameter/Parameter.h"
+#include "Parameter/ParameterGraph.h"
+#include "Tools/dimension.hpp"
+
+/// ParameterView
+///   The parameter of a parameter graph with a given index, held as the
+///   mixed-radix digits of the index (the logic and order index of each
+///   node) together with pointers into the tables of bins and output
+///   order permutations which the parameter graph builds when its first
+///   view is created. Decoding an index this way performs no heap
+///   allocation, whereas ParameterGraph::parameter builds a
+///   LogicParameter and an OrderParameter for every node. The view keeps
+///   its parameter graph alive. It supports the queries the dynamics are
+///   built from (labelling, absorbing, regulator) and gives the same
+///   answers as the Parameter returned by "parameter".
+class ParameterView {
+public:
+  /// ParameterView
+  ParameterView ( void );
+
+  /// ParameterView
+  ///   View the parameter of a parameter graph with a given index
+  ParameterView ( ParameterGraph const& pg, uint64_t index );
+
+  /// assign
+  ///   View the parameter of a parameter graph with a given index
+  void
+  assign ( ParameterGraph const& pg, uint64_t index );
+
+  /// index
+  ///   Return the index of the parameter in its parameter graph
+  uint64_t
+  index ( void ) const;
+
+  /// logic
+  ///   Return the position of the logic of node d in
+  ///   the factor graph of node d
+  uint64_t
+  logic ( uint64_t d ) const;
+
+  /// order
+  ///   Return the index of the output edge ordering of node d
+  ///   (see OrderParameter)
+  uint64_t
+  order ( uint64_t d ) const;
+
+  /// absorbing
+  ///   Return true if wall is absorbing
+  ///   (see Parameter::absorbing)
+  bool
+  absorbing ( Domain const& dom, int collapse_dim, int direction ) const;
+
+  /// regulator
+  ///   Return the variable being regulated on the threshold indicated
+  ///   (see Parameter::regulator)
+  uint64_t
+  regulator ( uint64_t variable, uint64_t threshold ) const;
+
+  /// labelling
+  ///   Return the wall labelling of the domains
+  ///   (see Parameter::labelling)
+  std::vector<uint64_t>
+  labelling ( void ) const;
+
+  /// relabel
+  ///   Given the labelling of the view "previous" of the same parameter
+  ///   graph, update it in place to the labelling of this view,
+  ///   recomputing only the dimensions whose labelling can differ
+  ///   (see Parameter::relabel). Consecutive indices usually differ in
+  ///   the logic of one node, so sweeps over a range of indices relabel
+  ///   one dimension per step.
+  void
+  relabel ( std::vector<uint64_t> & labelling, ParameterView const& previous ) const;
+
+  /// parameter
+  ///   Return the parameter, as ParameterGraph::parameter does
+  Parameter
+  parameter ( void ) const;
+
+  /// network
+  ///   Return network
+  Network const
+  network ( void ) const;
+
+  /// operator <<
+  ///   Output the index and digits to stream
+  friend std::ostream& operator << ( std::ostream& stream, ParameterView const& p );
+
+private:
+  std::shared_ptr<ParameterGraph_ const> graph_;
+  uint64_t index_;
+  uint64_t dimension_;
+  std::array<uint64_t, dsgrn::max_dimension> logic_;
+  std::array<uint64_t, dsgrn::max_dimension> order_;
+  /// bins_[d] points at the bins of the logic of node d
+  ///   (one per input combination)
+  std::array<uint8_t const*, dsgrn::max_dimension> bins_;
+  /// permutation_[d] points at the output edge permutation of
+  ///   node d, which is followed by its inverse
+  std::array<uint8_t const*, dsgrn::max_dimension> permutation_;
+
+  /// _threshold
+  ///   Return the threshold of the edge from source to target
+  uint64_t
+  _threshold ( Network const& network, uint64_t source, uint64_t target ) const;
+
+  /// _labelling
+  ///   Set the left and right wall bits of dimension d in "result"
+  ///   (assumed to be clear)
+  void
+  _labelling ( uint64_t d, std::vector<uint64_t> & result ) const;
+};
+
+/// Python Bindings
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include "Tools/numpy.hpp"
+namespace py = pybind11;
+
+inline void
+ParameterViewBinding (py::module &m) {
+  py::class_<ParameterView, std::shared_ptr<ParameterView>>(m, "ParameterView")
+    .def(py::init<>())
+    .def(py::init<ParameterGraph const&, uint64_t>())
+    .def("assign", &ParameterView::assign)
+    .def("index", &ParameterView::index)
+    .def("logic", &ParameterView::logic)
+    .def("order", &ParameterView::order)
+    .def("absorbing", &ParameterView::absorbing)
+    .def("regulator", &ParameterView::regulator)
+    .def("labelling", &ParameterView::labelling, py::call_guard<py::gil_scoped_release>())
+    .def("relabel", [](ParameterView const& p, std::vector<uint64_t> labelling, ParameterView const& previous) {
+      p . relabel ( labelling, previous );
+      return labelling;
+    }, py::call_guard<py::gil_scoped_release>())
+    .def("labelling_array", [](ParameterView const& p) {
+      std::vector<uint64_t> labelling;
+      {
+        py::gil_scoped_release release;
+        labelling = p . labelling ();
+      }
+      return dsgrn::numpy_array ( std::move ( labelling ) );
+    })
+    .def("parameter", &ParameterView::parameter)
+    .def("network", &ParameterView::network)
+    .def("__str__", [](ParameterView const& p){ std::stringstream ss; ss << p; return ss.str(); });
+}
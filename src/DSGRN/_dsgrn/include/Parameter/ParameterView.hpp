@@ -0,0 +1,190 @@
+/// ParameterView.hpp
+/// Shaun Harker
+/// 2018-11-21
+/// MIT LICENSE
+
+#pragma once
+
+#ifndef INLINE_IF_HEADER_ONLY
+#define INLINE_IF_HEADER_ONLY
+#endif
+
+#include "ParameterView.h"
+
+INLINE_IF_HEADER_ONLY ParameterView::
+ParameterView ( void ) {
+  // Default views share one empty parameter graph, so that
+  // constructing one does not allocate
+  static std::shared_ptr<ParameterGraph_ const> empty ( new ParameterGraph_ );
+  graph_ = empty;
+  index_ = 0;
+  dimension_ = 0;
+}
+
+INLINE_IF_HEADER_ONLY ParameterView::
+ParameterView ( ParameterGraph const& pg, uint64_t index ) {
+  assign ( pg, index );
+}
+
+INLINE_IF_HEADER_ONLY void ParameterView::
+assign ( ParameterGraph const& pg, uint64_t index ) {
+  if ( index >= pg . size () ) {
+    throw std::runtime_error ( "ParameterView::assign: Index out of bounds" );
+  }
+  uint64_t D = pg . data_ -> network_ . size ();
+  if ( D > dsgrn::max_dimension ) {
+    throw std::invalid_argument ( "ParameterView::assign: networks with more than " +
+                                  std::to_string ( dsgrn::max_dimension ) + " nodes are not supported" );
+  }
+  pg . _view_tables ();
+  graph_ = pg . data_;
+  index_ = index;
+  dimension_ = D;
+  logic_ . fill ( 0 );
+  order_ . fill ( 0 );
+  uint64_t logic_index = index % graph_ -> fixedordersize_;
+  uint64_t order_index = index / graph_ -> fixedordersize_;
+  for ( uint64_t d = 0; d < D; ++ d ) {
+    logic_[d] = logic_index % graph_ -> logic_place_bases_ [ d ];
+    logic_index /= graph_ -> logic_place_bases_ [ d ];
+    order_[d] = order_index % graph_ -> order_place_bases_ [ d ];
+    order_index /= graph_ -> order_place_bases_ [ d ];
+    uint64_t n = graph_ -> network_ . inputs ( d ) . size ();
+    uint64_t m = graph_ -> network_ . outputs ( d ) . size ();
+    bins_[d] = graph_ -> logic_bins_ [ d ] . data () + ( logic_[d] << n );
+    permutation_[d] = graph_ -> order_tables_ [ d ] . data () + 2 * m * order_[d];
+  }
+}
+
+INLINE_IF_HEADER_ONLY uint64_t ParameterView::
+index ( void ) const {
+  return index_;
+}
+
+INLINE_IF_HEADER_ONLY uint64_t ParameterView::
+logic ( uint64_t d ) const {
+  return logic_ . at ( d );
+}
+
+INLINE_IF_HEADER_ONLY uint64_t ParameterView::
+order ( uint64_t d ) const {
+  return order_ . at ( d );
+}
+
+INLINE_IF_HEADER_ONLY bool ParameterView::
+absorbing ( Domain const& dom, int collapse_dim, int direction ) const {
+  Network const& network = graph_ -> network_;
+  int thres = dom [ collapse_dim ];
+  if ( direction == -1 ) thres -= 1;
+  if ( thres < 0 ) return false;
+  if ( (uint64_t) thres == network . outputs ( collapse_dim ) . size () ) return false;
+  // Input combination, as in Parameter::combination
+  std::vector<uint64_t> const& inputs = network . inputs ( collapse_dim );
+  uint64_t in = 0;
+  for ( uint64_t k = 0; k < inputs . size (); ++ k ) {
+    uint64_t source = inputs [ k ];
+    bool activating = network . interaction ( source, collapse_dim );
+    if ( not ( dom [ source ] > _threshold ( network, source, collapse_dim ) ) ^ activating ) in |= 1LL << k;
+  }
+  // The flow crosses threshold "thres" to the right iff the
+  // target point lands in a higher bin
+  bool flow_direction = bins_ [ collapse_dim ] [ in ] > thres;
+  if ( direction == -1 ) {
+    return not flow_direction;
+  } else {
+    return flow_direction;
+  }
+}
+
+INLINE_IF_HEADER_ONLY uint64_t ParameterView::
+regulator ( uint64_t variable, uint64_t threshold ) const {
+  uint64_t inedge = permutation_ [ variable ] [ threshold ];
+  return graph_ -> network_ . outputs ( variable ) [ inedge ];
+}
+
+INLINE_IF_HEADER_ONLY std::vector<uint64_t> ParameterView::
+labelling ( void ) const {
+  Network const& network = graph_ -> network_;
+  uint64_t N = 1;
+  for ( uint64_t limit : network . domains () ) N *= limit;
+  std::vector<uint64_t> result ( N, 0 );
+  for ( uint64_t d = 0; d < dimension_; ++ d ) _labelling ( d, result );
+  return result;
+}
+
+INLINE_IF_HEADER_ONLY void ParameterView::
+relabel ( std::vector<uint64_t> & labelling, ParameterView const& previous ) const {
+  Network const& network = graph_ -> network_;
+  uint64_t D = dimension_;
+  // Bits for dimension d depend only on the logic of node d and on the
+  // output orders of the sources of d
+  std::array<bool, dsgrn::max_dimension> changed {};
+  for ( uint64_t d = 0; d < D; ++ d ) {
+    if ( logic_ [ d ] != previous . logic_ [ d ] ) changed [ d ] = true;
+    if ( order_ [ d ] != previous . order_ [ d ] ) {
+      for ( uint64_t target : network . outputs ( d ) ) changed [ target ] = true;
+    }
+  }
+  uint64_t mask = 0;
+  for ( uint64_t d = 0; d < D; ++ d ) {
+    if ( changed [ d ] ) mask |= ( 1LL << d ) | ( 1LL << (D+d) );
+  }
+  if ( mask == 0 ) return;
+  for ( uint64_t & label : labelling ) label &= ~mask;
+  for ( uint64_t d = 0; d < D; ++ d ) {
+    if ( changed [ d ] ) _labelling ( d, labelling );
+  }
+}
+
+INLINE_IF_HEADER_ONLY Parameter ParameterView::
+parameter ( void ) const {
+  Network const& network = graph_ -> network_;
+  std::vector<LogicParameter> logic;
+  std::vector<OrderParameter> order;
+  for ( uint64_t d = 0; d < dimension_; ++ d ) {
+    uint64_t n = network . inputs ( d ) . size ();
+    uint64_t m = network . outputs ( d ) . size ();
+    logic . push_back ( LogicParameter ( n, m, graph_ -> factors_ [ d ] [ logic_[d] ] ) );
+    order . push_back ( OrderParameter ( m, order_[d] ) );
+  }
+  Parameter result;
+  result . _assign ( logic, order, network, graph_ -> box_fill_ );
+  return result;
+}
+
+INLINE_IF_HEADER_ONLY Network const ParameterView::
+network ( void ) const {
+  return graph_ -> network_;
+}
+
+INLINE_IF_HEADER_ONLY uint64_t ParameterView::
+_threshold ( Network const& network, uint64_t source, uint64_t target ) const {
+  uint64_t m = network . outputs ( source ) . size ();
+  return permutation_ [ source ] [ m + network . order ( source, target ) ];
+}
+
+INLINE_IF_HEADER_ONLY void ParameterView::
+_labelling ( uint64_t d, std::vector<uint64_t> & result ) const {
+  Network const& network = graph_ -> network_;
+  uint8_t const* bins = bins_[d];
+  Parameter_detail::label_dimension ( network, d, graph_ -> box_fill_,
+    [&] ( uint64_t in ) { return (uint64_t) bins [ in ]; },
+    [&] ( uint64_t source, uint64_t outorder ) {
+      return (uint64_t) permutation_ [ source ] [ network . outputs ( source ) . size () + outorder ]; },
+    result );
+}
+
+INLINE_IF_HEADER_ONLY std::ostream& operator << ( std::ostream& stream, ParameterView const& p ) {
+  stream << "(ParameterView: index " << p . index_ << ", logic [";
+  for ( uint64_t d = 0; d < p . dimension_; ++ d ) {
+    if ( d > 0 ) stream << ",";
+    stream << p . logic_[d];
+  }
+  stream << "], order [";
+  for ( uint64_t d = 0; d < p . dimension_; ++ d ) {
+    if ( d > 0 ) stream << ",";
+    stream << p . order_[d];
+  }
+  stream << "])";
+  return stream;
+}
@@ -0,0 +1,175 @@
+/// Registry.h
+/// Shaun Harker
+/// 2018-11-19
+/// MIT LICENSE
+
+#pragma once
+
+#ifndef INLINE_IF_HEADER_ONLY
+#define INLINE_IF_HEADER_ONLY
+#endif
+
+#include "common.h"
+
+#include <list>
+#include <mutex>
+
+#include "Parameter/Network.h"
+#include "Parameter/ParameterGraph.h"
+#include "Parameter/Configuration.h"
+
+struct Registry_;
+struct RegistryEntry_;
+
+/// Registry
+///   Process-wide cache of networks and parameter graphs. Entries are
+///   keyed by the normalized network specification (quote marks and
+///   carriage returns removed, whitespace runs collapsed, blank lines
+///   dropped), so specifications differing only in layout share an
+///   entry. Parameter graphs are also keyed by the logic resource path
+///   of the global configuration. Returned objects share their data
+///   with the cache; networks and parameter graphs are not modified by
+///   any method, so this is safe. When more than "capacity" entries are
+///   held, the least recently used entry is evicted. All methods may be
+///   called from any thread.
+class Registry {
+public:
+  /// Registry
+  ///   Construct an empty registry of unbounded capacity
+  Registry ( void );
+
+  /// network
+  ///   Return the network with specification "s" (or, if "s" contains
+  ///   no colon, stored in the file "s"), parsing it only if no network
+  ///   with the same normalized specification is cached
+  Network
+  network ( std::string const& s );
+
+  /// parametergraph
+  ///   Return the parameter graph of a network, reading the logic
+  ///   resources only if no parameter graph of a network with the same
+  ///   normalized specification is cached
+  ParameterGraph
+  parametergraph ( Network const& network );
+
+  /// parametergraph
+  ///   Return the parameter graph of network(s)
+  ParameterGraph
+  parametergraph ( std::string const& s );
+
+  /// capacity
+  ///   Return the maximum number of cached entries (0 means unbounded)
+  uint64_t
+  capacity ( void ) const;
+
+  /// set_capacity
+  ///   Set the maximum number of cached entries (0 means unbounded),
+  ///   evicting least recently used entries as needed
+  void
+  set_capacity ( uint64_t capacity );
+
+  /// size
+  ///   Return the number of cached entries
+  uint64_t
+  size ( void ) const;
+
+  /// hits
+  ///   Return the number of lookups answered from the cache
+  uint64_t
+  hits ( void ) const;
+
+  /// misses
+  ///   Return the number of lookups which had to parse a specification
+  ///   or build a parameter graph
+  uint64_t
+  misses ( void ) const;
+
+  /// evictions
+  ///   Return the number of entries evicted to respect the capacity
+  uint64_t
+  evictions ( void ) const;
+
+  /// clear
+  ///   Remove all entries and reset the statistics
+  void
+  clear ( void );
+
+  /// normalize
+  ///   Return the normalized form of a network specification
+  static std::string
+  normalize ( std::string const& specification );
+
+  /// operator <<
+  ///   Stream out the statistics
+  friend std::ostream& operator << ( std::ostream& stream, Registry const& registry );
+
+private:
+  std::shared_ptr<Registry_> data_;
+
+  /// _entry
+  ///   Return the entry of a normalized specification, creating it if
+  ///   necessary and marking it most recently used. The caller holds
+  ///   the lock.
+  RegistryEntry_ &
+  _entry ( std::string const& key );
+
+  /// _evict
+  ///   Evict least recently used entries beyond capacity. The caller
+  ///   holds the lock.
+  void
+  _evict ( void );
+};
+
+struct RegistryEntry_ {
+  std::list<std::string>::iterator recency_;
+  bool has_network_ = false;
+  Network network_;
+  bool has_parametergraph_ = false;
+  // Logic resource path the parameter graph was built from
+  std::string path_;
+  ParameterGraph parametergraph_;
+};
+
+struct Registry_ {
+  mutable std::mutex mutex_;
+  uint64_t capacity_;
+  uint64_t hits_;
+  uint64_t misses_;
+  uint64_t evictions_;
+  // Normalized specifications, most recently used first
+  std::list<std::string> recency_;
+  std::unordered_map<std::string, RegistryEntry_> entries_;
+};
+
+/// registry
+///   Return the process-wide registry
+inline std::shared_ptr<Registry>
+registry ( void ) {
+  static std::shared_ptr<Registry> global_registry ( new Registry );
+  return global_registry;
+}
+
+/// Python Bindings
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+namespace py = pybind11;
+
+inline void
+RegistryBinding (py::module &m) {
+  py::class_<Registry, std::shared_ptr<Registry>>(m, "Registry")
+    .def(py::init<>())
+    .def("network", &Registry::network, py::call_guard<py::gil_scoped_release>())
+    .def("parametergraph", (ParameterGraph(Registry::*)(Network const&))&Registry::parametergraph, py::call_guard<py::gil_scoped_release>())
+    .def("parametergraph", (ParameterGraph(Registry::*)(std::string const&))&Registry::parametergraph, py::call_guard<py::gil_scoped_release>())
+    .def("capacity", &Registry::capacity)
+    .def("set_capacity", &Registry::set_capacity)
+    .def("size", &Registry::size)
+    .def("hits", &Registry::hits)
+    .def("misses", &Registry::misses)
+    .def("evictions", &Registry::evictions)
+    .def("clear", &Registry::clear)
+    .def_static("normalize", &Registry::normalize)
+    .def("__str__", [](Registry const& r){ std::stringstream ss; ss << r; return ss.str(); });
+  m.def("registry", &registry);
+}
@@ -0,0 +1,199 @@
+/// Registry.hpp
+/// Shaun Harker
+/// 2018-11-19
+/// MIT LICENSE
+
+#pragma once
+
+#ifndef INLINE_IF_HEADER_ONLY
+#define INLINE_IF_HEADER_ONLY
+#endif
+
+#include "Registry.h"
+
+INLINE_IF_HEADER_ONLY Registry::
+Registry ( void ) {
+  data_ . reset ( new Registry_ );
+  data_ -> capacity_ = 0;
+  data_ -> hits_ = 0;
+  data_ -> misses_ = 0;
+  data_ -> evictions_ = 0;
+}
+
+INLINE_IF_HEADER_ONLY Network Registry::
+network ( std::string const& s ) {
+  std::string specification = s;
+  if ( s . find ( ':' ) == std::string::npos ) {
+    // A filename: key by the contents, which may change
+    std::ifstream infile ( s );
+    if ( not infile . good () ) {
+      throw std::runtime_error ( "Problem loading network specification file " + s );
+    }
+    specification . clear ();
+    std::string line;
+    while ( std::getline ( infile, line ) ) specification += line + '\n';
+  }
+  std::string key = normalize ( specification );
+  {
+    std::lock_guard<std::mutex> lock ( data_ -> mutex_ );
+    auto it = data_ -> entries_ . find ( key );
+    if ( it != data_ -> entries_ . end () && it -> second . has_network_ ) {
+      ++ data_ -> hits_;
+      return _entry ( key ) . network_;
+    }
+  }
+  // Parse without holding the lock
+  Network result;
+  if ( not key . empty () ) result . assign ( specification );
+  std::lock_guard<std::mutex> lock ( data_ -> mutex_ );
+  ++ data_ -> misses_;
+  RegistryEntry_ & entry = _entry ( key );
+  if ( not entry . has_network_ ) {
+    entry . has_network_ = true;
+    entry . network_ = result;
+  }
+  Network cached = entry . network_;
+  _evict ();
+  return cached;
+}
+
+INLINE_IF_HEADER_ONLY ParameterGraph Registry::
+parametergraph ( Network const& network ) {
+  std::string key = normalize ( network . specification () );
+  std::string path = configuration () -> get_path ();
+  {
+    std::lock_guard<std::mutex> lock ( data_ -> mutex_ );
+    auto it = data_ -> entries_ . find ( key );
+    if ( it != data_ -> entries_ . end () && it -> second . has_parametergraph_ && it -> second . path_ == path ) {
+      ++ data_ -> hits_;
+      return _entry ( key ) . parametergraph_;
+    }
+  }
+  // Read the logic resources without holding the lock
+  ParameterGraph result ( network );
+  std::lock_guard<std::mutex> lock ( data_ -> mutex_ );
+  ++ data_ -> misses_;
+  RegistryEntry_ & entry = _entry ( key );
+  if ( not entry . has_network_ ) {
+    entry . has_network_ = true;
+    entry . network_ = network;
+  }
+  if ( not entry . has_parametergraph_ || entry . path_ != path ) {
+    entry . has_parametergraph_ = true;
+    entry . path_ = path;
+    entry . parametergraph_ = result;
+  }
+  ParameterGraph cached = entry . parametergraph_;
+  _evict ();
+  return cached;
+}
+
+INLINE_IF_HEADER_ONLY ParameterGraph Registry::
+parametergraph ( std::string const& s ) {
+  return parametergraph ( network ( s ) );
+}
+
+INLINE_IF_HEADER_ONLY uint64_t Registry::
+capacity ( void ) const {
+  std::lock_guard<std::mutex> lock ( data_ -> mutex_ );
+  return data_ -> capacity_;
+}
+
+INLINE_IF_HEADER_ONLY void Registry::
+set_capacity ( uint64_t capacity ) {
+  std::lock_guard<std::mutex> lock ( data_ -> mutex_ );
+  data_ -> capacity_ = capacity;
+  _evict ();
+}
+
+INLINE_IF_HEADER_ONLY uint64_t Registry::
+size ( void ) const {
+  std::lock_guard<std::mutex> lock ( data_ -> mutex_ );
+  return data_ -> entries_ . size ();
+}
+
+INLINE_IF_HEADER_ONLY uint64_t Registry::
+hits ( void ) const {
+  std::lock_guard<std::mutex> lock ( data_ -> mutex_ );
+  return data_ -> hits_;
+}
+
+INLINE_IF_HEADER_ONLY uint64_t Registry::
+misses ( void ) const {
+  std::lock_guard<std::mutex> lock ( data_ -> mutex_ );
+  return data_ -> misses_;
+}
+
+INLINE_IF_HEADER_ONLY uint64_t Registry::
+evictions ( void ) const {
+  std::lock_guard<std::mutex> lock ( data_ -> mutex_ );
+  return data_ -> evictions_;
+}
+
+INLINE_IF_HEADER_ONLY void Registry::
+clear ( void ) {
+  std::lock_guard<std::mutex> lock ( data_ -> mutex_ );
+  data_ -> entries_ . clear ();
+  data_ -> recency_ . clear ();
+  data_ -> hits_ = 0;
+  data_ -> misses_ = 0;
+  data_ -> evictions_ = 0;
+}
+
+INLINE_IF_HEADER_ONLY std::string Registry::
+normalize ( std::string const& specification ) {
+  std::string result;
+  std::string line;
+  bool space = false;
+  auto flush = [&] () {
+    if ( line . empty () ) return;
+    if ( not result . empty () ) result += '\n';
+    result += line;
+    line . clear ();
+    space = false;
+  };
+  for ( char c : specification ) {
+    if ( c == '\n' ) {
+      flush ();
+    } else if ( c == ' ' || c == '\t' || c == '\r' ) {
+      space = not line . empty ();
+    } else if ( c != '"' ) {
+      if ( space ) line += ' ';
+      space = false;
+      line += c;
+    }
+  }
+  flush ();
+  return result;
+}
+
+INLINE_IF_HEADER_ONLY std::ostream& operator << ( std::ostream& stream, Registry const& registry ) {
+  stream << "(Registry: " << registry.size() << " entries, "
+         << registry.hits() << " hits, " << registry.misses() << " misses, "
+         << registry.evictions() << " evictions)";
+  return stream;
+}
+
+INLINE_IF_HEADER_ONLY RegistryEntry_ & Registry::
+_entry ( std::string const& key ) {
+  auto it = data_ -> entries_ . find ( key );
+  if ( it == data_ -> entries_ . end () ) {
+    data_ -> recency_ . push_front ( key );
+    it = data_ -> entries_ . insert ( { key, RegistryEntry_ () } ) . first;
+  } else {
+    data_ -> recency_ . erase ( it -> second . recency_ );
+    data_ -> recency_ . push_front ( key );
+  }
+  it -> second . recency_ = data_ -> recency_ . begin ();
+  return it -> second;
+}
+
+INLINE_IF_HEADER_ONLY void Registry::
+_evict ( void ) {
+  if ( data_ -> capacity_ == 0 ) return;
+  while ( data_ -> entries_ . size () > data_ -> capacity_ ) {
+    data_ -> entries_ . erase ( data_ -> recency_ . back () );
+    data_ -> recency_ . pop_back ();
+    ++ data_ -> evictions_;
+  }
+}
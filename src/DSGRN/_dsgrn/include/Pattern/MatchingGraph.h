@@ -109,7 +109,7 @@ inline void
 MatchingGraphBinding (py::module &m) {
   py::class_<MatchingGraph, std::shared_ptr<MatchingGraph>>(m, "MatchingGraph")
     .def(py::init<>())
-    .def(py::init<SearchGraph const&,PatternGraph const&>())
+    .def(py::init<SearchGraph const&,PatternGraph const&>(), py::call_guard<py::gil_scoped_release>())
     .def("searchgraph", &MatchingGraph::searchgraph)
     .def("patterngraph", &MatchingGraph::patterngraph)
     .def("query", &MatchingGraph::query)
@@ -0,0 +1,189 @@
+/// PatternBuilder.h
+/// Shaun Harker
+/// 2018-11-05
+/// MIT LICENSE
+
+#pragma once
+
+#include "common.h"
+
+#include <deque>
+#include <limits>
+
+#include "Graph/Digraph.h"
+#include "Graph/Poset.h"
+#include "Pattern/Pattern.h"
+
+struct PatternBuilder_;
+
+/// class PatternBuilder
+///   Construct a Pattern directly from time series data.
+///   Samples are consumed one time point at a time, so the full
+///   time series never needs to be held in memory. Extrema are
+///   detected with a noise threshold: a maximum is only reported
+///   once the series has dropped more than the threshold below it
+///   (and similarly for minima). Each extremum is associated with
+///   the interval of times over which the series stays within the
+///   threshold of the extremal value; two events are ordered exactly
+///   when their intervals are disjoint. Extrema at the first sample
+///   are not reported.
+class PatternBuilder {
+public:
+  /// PatternBuilder
+  ///   Default constructor
+  PatternBuilder ( void );
+
+  /// PatternBuilder
+  ///   Construct a builder for "dimension" variables using the
+  ///   same noise threshold for every variable
+  PatternBuilder ( uint64_t dimension, double noise );
+
+  /// PatternBuilder
+  ///   Construct a builder with a noise threshold for each variable
+  PatternBuilder ( std::vector<double> const& noise );
+
+  /// assign
+  ///   Construct a builder for "dimension" variables using the
+  ///   same noise threshold for every variable
+  void
+  assign ( uint64_t dimension, double noise );
+
+  /// assign
+  ///   Construct a builder with a noise threshold for each variable
+  void
+  assign ( std::vector<double> const& noise );
+
+  /// push
+  ///   Consume the sample of all variables at time "time".
+  ///   Times must be nondecreasing.
+  void
+  push ( double time, std::vector<double> const& sample );
+
+  /// push
+  ///   Consume a sample stored in memory with the given stride
+  ///   (in units of doubles) between consecutive variables
+  void
+  push ( double time, double const* sample, int64_t stride = 1 );
+
+  /// load_csv
+  ///   Stream a CSV file. Each row holds a time followed by the
+  ///   value of each variable. A leading header row (e.g. the
+  ///   names of the variables) is skipped.
+  void
+  load_csv ( std::string const& filename );
+
+  /// load_binary
+  ///   Stream a binary file of native 64-bit doubles. Each row holds
+  ///   a time followed by the value of each variable.
+  void
+  load_binary ( std::string const& filename );
+
+  /// dimension
+  ///   Return number of variables
+  uint64_t
+  dimension ( void ) const;
+
+  /// size
+  ///   Return number of events detected so far
+  uint64_t
+  size ( void ) const;
+
+  /// pattern
+  ///   Return the pattern of the events detected so far.
+  ///   The poset vertices are sorted by the start of their
+  ///   time intervals. The final label records, for each variable,
+  ///   whether it is increasing or decreasing after its last event
+  ///   (or neither, if it never moved more than the noise threshold).
+  Pattern
+  pattern ( void ) const;
+
+private:
+  std::shared_ptr<PatternBuilder_> data_;
+};
+
+struct PatternBuilder_ {
+  /// Extremum event with its time interval
+  struct Event {
+    uint64_t variable;
+    bool minimum;
+    double start;
+    double end;
+  };
+  /// Sample kept for locating the left end of an event interval;
+  /// "next_time" is the time of the sample that follows it
+  struct Sample {
+    uint64_t pos;
+    double value;
+    double next_time;
+  };
+  /// Per-variable extremum detection state. The left end of the
+  /// interval of a maximum at position e is the sample after the last
+  /// sample before e lying more than the noise threshold below it.
+  /// Only samples not followed by a smaller or equal one can be that
+  /// sample, so "lows" keeps those (values increasing from front to
+  /// back), and "highs" likewise keeps the candidates for minima. While
+  /// a maximum is pending, samples in front of the one bounding the
+  /// interval of the current maximum can never bound a later one and
+  /// are dropped (and likewise for minima), so on monotone series the
+  /// stacks stay as short as the stretch of samples within the noise
+  /// threshold of the latest extremum.
+  struct Track {
+    int direction; // 0 undetermined, 1 increasing, -1 decreasing
+    double noise;
+    double max_value;
+    double min_value;
+    uint64_t max_pos;
+    uint64_t min_pos;
+    double max_time;
+    double min_time;
+    double start_time; // time of the first sample since the last extremum
+    std::deque<Sample> lows;
+    std::deque<Sample> highs;
+  };
+  uint64_t dimension_;
+  uint64_t count_;
+  double time_;
+  std::vector<Track> tracks_;
+  std::vector<Event> events_;
+};
+
+/// Python Bindings
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <pybind11/numpy.h>
+namespace py = pybind11;
+
+inline void
+PatternBuilderBinding (py::module &m) {
+  py::class_<PatternBuilder, std::shared_ptr<PatternBuilder>>(m, "PatternBuilder")
+    .def(py::init<>())
+    .def(py::init<uint64_t, double>())
+    .def(py::init<std::vector<double> const&>())
+    .def("push", (void (PatternBuilder::*)(double, std::vector<double> const&)) &PatternBuilder::push)
+    .def("push_array", [](PatternBuilder & builder, py::array_t<double> times, py::array_t<double> values) {
+      // Read the samples in place; "values" may be time-major or a
+      // transposed (variable-major) view, since strides are honored.
+      py::buffer_info t = times . request ();
+      py::buffer_info x = values . request ();
+      if ( t . ndim != 1 || x . ndim != 2 || x . shape[0] != t . shape[0] ) {
+        throw std::invalid_argument("PatternBuilder::push_array: expected times of shape (T,) and values of shape (T,D)");
+      }
+      if ( (uint64_t) x . shape[1] != builder . dimension () ) {
+        throw std::invalid_argument("PatternBuilder::push_array: values must have one column per variable");
+      }
+      double const* tptr = (double const*) t . ptr;
+      double const* xptr = (double const*) x . ptr;
+      int64_t tstride = t . strides[0] / sizeof(double);
+      int64_t xrow = x . strides[0] / sizeof(double);
+      int64_t xcol = x . strides[1] / sizeof(double);
+      for ( int64_t i = 0; i < (int64_t) t . shape[0]; ++ i ) {
+        builder . push ( tptr[i*tstride], xptr + i*xrow, xcol );
+      }
+    })
+    .def("load_csv", &PatternBuilder::load_csv)
+    .def("load_binary", &PatternBuilder::load_binary)
+    .def("dimension", &PatternBuilder::dimension)
+    .def("size", &PatternBuilder::size)
+    .def("pattern", &PatternBuilder::pattern);
+}
@@ -0,0 +1,329 @@
+/// PatternBuilder.hpp
+/// Shaun Harker
+/// 2018-11-05
+/// MIT LICENSE
+
+#pragma once
+
+#ifndef INLINE_IF_HEADER_ONLY
+#define INLINE_IF_HEADER_ONLY
+#endif
+
+#include "PatternBuilder.h"
+
+namespace PatternBuilder_detail {
+  typedef PatternBuilder_::Sample Sample;
+
+  /// bound
+  ///   Return the number of samples in "stack" before position e which
+  ///   lie beyond "threshold" (below it if "below", else above it). Both
+  ///   conditions hold on a prefix of the stack, positions increasing and
+  ///   values monotone, so the last such sample bounds the interval of
+  ///   an extremum at e.
+  inline uint64_t
+  bound ( std::deque<Sample> const& stack, uint64_t e, double threshold, bool below ) {
+    auto before = std::partition_point ( stack . begin (), stack . end (),
+      [&] ( Sample const& s ) { return s . pos < e; } );
+    auto beyond = std::partition_point ( stack . begin (), stack . end (),
+      [&] ( Sample const& s ) { return below ? s . value < threshold : s . value > threshold; } );
+    return std::min ( before - stack . begin (), beyond - stack . begin () );
+  }
+
+  /// left_end
+  ///   Return the time the interval of an extremum at position e starts
+  ///   (see PatternBuilder_::Track)
+  inline double
+  left_end ( std::deque<Sample> const& stack, uint64_t e, double threshold,
+             bool below, double start_time ) {
+    uint64_t k = bound ( stack, e, threshold, below );
+    return ( k == 0 ) ? start_time : stack [ k - 1 ] . next_time;
+  }
+
+  /// append
+  ///   Push a sample, removing the samples it makes irrelevant: those
+  ///   with value greater (if "lows") or less (if "highs") or equal
+  ///   (they are no longer the last sample beyond any threshold)
+  inline void
+  append ( std::deque<Sample> & stack, Sample const& sample, bool lows ) {
+    if ( not stack . empty () ) stack . back () . next_time = sample . next_time;
+    while ( not stack . empty () && ( lows ? stack . back () . value >= sample . value
+                                           : stack . back () . value <= sample . value ) ) {
+      stack . pop_back ();
+    }
+    stack . push_back ( sample );
+  }
+
+  /// prune
+  ///   Remove the samples in front of the one bounding the interval of
+  ///   an extremum at position e with the given threshold; later
+  ///   extrema lie further out, so they are bounded no earlier
+  inline void
+  prune ( std::deque<Sample> & stack, uint64_t e, double threshold, bool below ) {
+    uint64_t k = bound ( stack, e, threshold, below );
+    for ( uint64_t i = 1; i < k; ++ i ) stack . pop_front ();
+  }
+
+  /// restart
+  ///   Remove the samples before position e
+  inline void
+  restart ( std::deque<Sample> & stack, uint64_t e ) {
+    while ( not stack . empty () && stack . front () . pos < e ) stack . pop_front ();
+  }
+}
+
+INLINE_IF_HEADER_ONLY PatternBuilder::
+PatternBuilder ( void ) {
+  data_ . reset ( new PatternBuilder_ );
+  data_ -> dimension_ = 0;
+  data_ -> count_ = 0;
+  data_ -> time_ = 0.0;
+}
+
+INLINE_IF_HEADER_ONLY PatternBuilder::
+PatternBuilder ( uint64_t dimension, double noise ) {
+  assign ( dimension, noise );
+}
+
+INLINE_IF_HEADER_ONLY PatternBuilder::
+PatternBuilder ( std::vector<double> const& noise ) {
+  assign ( noise );
+}
+
+INLINE_IF_HEADER_ONLY void PatternBuilder::
+assign ( uint64_t dimension, double noise ) {
+  assign ( std::vector<double> ( dimension, noise ) );
+}
+
+INLINE_IF_HEADER_ONLY void PatternBuilder::
+assign ( std::vector<double> const& noise ) {
+  if ( noise . size () > 32 ) {
+    throw std::invalid_argument("PatternBuilder::assign: patterns are limited to 32 dimensions");
+  }
+  data_ . reset ( new PatternBuilder_ );
+  data_ -> dimension_ = noise . size ();
+  data_ -> count_ = 0;
+  data_ -> time_ = 0.0;
+  data_ -> tracks_ . resize ( noise . size () );
+  for ( uint64_t d = 0; d < noise . size (); ++ d ) {
+    if ( not ( noise[d] >= 0.0 ) ) {
+      throw std::invalid_argument("PatternBuilder::assign: noise threshold must be nonnegative");
+    }
+    auto & track = data_ -> tracks_ [ d ];
+    track . direction = 0;
+    track . noise = noise[d];
+    track . max_value = -std::numeric_limits<double>::infinity ();
+    track . min_value = std::numeric_limits<double>::infinity ();
+    track . max_pos = 0;
+    track . min_pos = 0;
+    track . max_time = 0.0;
+    track . min_time = 0.0;
+    track . start_time = 0.0;
+  }
+}
+
+INLINE_IF_HEADER_ONLY void PatternBuilder::
+push ( double time, std::vector<double> const& sample ) {
+  if ( sample . size () != dimension () ) {
+    throw std::invalid_argument("PatternBuilder::push: sample size does not match dimension");
+  }
+  push ( time, sample . data (), 1 );
+}
+
+INLINE_IF_HEADER_ONLY void PatternBuilder::
+push ( double time, double const* sample, int64_t stride ) {
+  uint64_t const pos = data_ -> count_;
+  if ( pos > 0 && time < data_ -> time_ ) {
+    throw std::invalid_argument("PatternBuilder::push: times must be nondecreasing");
+  }
+  // Report an extremum at position "extremum_pos". Its interval extends
+  // backward while the series stays within the noise threshold of the
+  // extremal value, and forward up to the sample before "pos". The
+  // samples before the extremum are then no longer needed.
+  auto report = [&] ( uint64_t d, PatternBuilder_::Track & track, bool minimum,
+                      uint64_t extremum_pos, double extremum_value ) {
+    PatternBuilder_::Event event;
+    event . variable = d;
+    event . minimum = minimum;
+    if ( minimum ) {
+      event . start = PatternBuilder_detail::left_end ( track . highs, extremum_pos,
+        extremum_value + track . noise, false, track . start_time );
+    } else {
+      event . start = PatternBuilder_detail::left_end ( track . lows, extremum_pos,
+        extremum_value - track . noise, true, track . start_time );
+    }
+    event . end = data_ -> time_;
+    data_ -> events_ . push_back ( event );
+  };
+  auto restart = [&] ( PatternBuilder_::Track & track, uint64_t extremum_pos, double extremum_time ) {
+    PatternBuilder_detail::restart ( track . lows, extremum_pos );
+    PatternBuilder_detail::restart ( track . highs, extremum_pos );
+    track . start_time = extremum_time;
+  };
+  for ( uint64_t d = 0; d < dimension (); ++ d ) {
+    double const value = sample [ d * stride ];
+    auto & track = data_ -> tracks_ [ d ];
+    if ( pos == 0 ) track . start_time = time;
+    if ( value > track . max_value ) {
+      track . max_value = value;
+      track . max_pos = pos;
+      track . max_time = time;
+    }
+    if ( value < track . min_value ) {
+      track . min_value = value;
+      track . min_pos = pos;
+      track . min_time = time;
+    }
+    // The current sample lies outside every interval reported below
+    if ( track . direction >= 0 && value < track . max_value - track . noise ) {
+      // Passed a maximum. An extremum at the first sample is a boundary
+      // effect and is not reported.
+      if ( track . direction == 1 || track . max_pos > 0 ) {
+        report ( d, track, false, track . max_pos, track . max_value );
+      }
+      restart ( track, track . max_pos, track . max_time );
+      track . direction = -1;
+      track . min_value = value;
+      track . min_pos = pos;
+      track . min_time = time;
+    } else if ( track . direction <= 0 && value > track . min_value + track . noise ) {
+      // Passed a minimum
+      if ( track . direction == -1 || track . min_pos > 0 ) {
+        report ( d, track, true, track . min_pos, track . min_value );
+      }
+      restart ( track, track . min_pos, track . min_time );
+      track . direction = 1;
+      track . max_value = value;
+      track . max_pos = pos;
+      track . max_time = time;
+    }
+    PatternBuilder_::Sample entry = { pos, value, time };
+    PatternBuilder_detail::append ( track . lows, entry, true );
+    PatternBuilder_detail::append ( track . highs, entry, false );
+    if ( track . direction >= 0 ) {
+      PatternBuilder_detail::prune ( track . lows, track . max_pos, track . max_value - track . noise, true );
+    }
+    if ( track . direction <= 0 ) {
+      PatternBuilder_detail::prune ( track . highs, track . min_pos, track . min_value + track . noise, false );
+    }
+  }
+  data_ -> time_ = time;
+  ++ data_ -> count_;
+}
+
+INLINE_IF_HEADER_ONLY void PatternBuilder::
+load_csv ( std::string const& filename ) {
+  std::ifstream infile ( filename );
+  if ( not infile . good () ) {
+    throw std::runtime_error ( "Problem loading time series file " + filename );
+  }
+  std::vector<double> row;
+  std::string line;
+  bool first_line = true;
+  while ( std::getline ( infile, line ) ) {
+    if ( line . empty () || line == "\r" ) continue;
+    row . clear ();
+    bool numeric = true;
+    char const* ptr = line . c_str ();
+    while ( true ) {
+      char * end;
+      double value = std::strtod ( ptr, &end );
+      if ( end == ptr ) { numeric = false; break; }
+      row . push_back ( value );
+      ptr = end;
+      while ( *ptr == ' ' || *ptr == '\t' || *ptr == '\r' ) ++ ptr;
+      if ( *ptr == '\0' ) break;
+      if ( *ptr != ',' ) { numeric = false; break; }
+      ++ ptr;
+    }
+    if ( not numeric ) {
+      if ( first_line ) { first_line = false; continue; }
+      throw std::runtime_error ( "PatternBuilder::load_csv: could not parse line \"" + line + "\"" );
+    }
+    first_line = false;
+    if ( row . size () != dimension () + 1 ) {
+      throw std::runtime_error ( "PatternBuilder::load_csv: expected time and " + std::to_string(dimension()) + " values per row" );
+    }
+    push ( row[0], row . data () + 1, 1 );
+  }
+}
+
+INLINE_IF_HEADER_ONLY void PatternBuilder::
+load_binary ( std::string const& filename ) {
+  std::ifstream infile ( filename, std::ios::binary );
+  if ( not infile . good () ) {
+    throw std::runtime_error ( "Problem loading time series file " + filename );
+  }
+  std::vector<double> row ( dimension () + 1 );
+  std::streamsize const row_bytes = row . size () * sizeof(double);
+  while ( infile . read ( (char *) row . data (), row_bytes ) ) {
+    push ( row[0], row . data () + 1, 1 );
+  }
+  if ( infile . gcount () != 0 ) {
+    throw std::runtime_error ( "PatternBuilder::load_binary: file ends with a partial row" );
+  }
+}
+
+INLINE_IF_HEADER_ONLY uint64_t PatternBuilder::
+dimension ( void ) const {
+  return data_ -> dimension_;
+}
+
+INLINE_IF_HEADER_ONLY uint64_t PatternBuilder::
+size ( void ) const {
+  return data_ -> events_ . size ();
+}
+
+INLINE_IF_HEADER_ONLY Pattern PatternBuilder::
+pattern ( void ) const {
+  auto const& events = data_ -> events_;
+  uint64_t N = events . size ();
+  uint64_t D = dimension ();
+  // Sort events by the start of their intervals
+  std::vector<uint64_t> order ( N );
+  for ( uint64_t i = 0; i < N; ++ i ) order[i] = i;
+  std::sort ( order . begin (), order . end (), [&](uint64_t a, uint64_t b) {
+    if ( events[a] . start != events[b] . start ) return events[a] . start < events[b] . start;
+    if ( events[a] . end != events[b] . end ) return events[a] . end < events[b] . end;
+    return a < b;
+  });
+  std::vector<uint64_t> rank ( N );
+  std::vector<double> start ( N );
+  std::vector<double> end ( N );
+  std::vector<uint64_t> variables ( N );
+  for ( uint64_t i = 0; i < N; ++ i ) {
+    rank [ order[i] ] = i;
+    start [ i ] = events [ order[i] ] . start;
+    end [ i ] = events [ order[i] ] . end;
+    variables [ i ] = events [ order[i] ] . variable;
+  }
+  // Event u precedes event v iff end(u) < start(v). The events covering u
+  // are those v with end(u) < start(v) <= m, where m is the least end of
+  // any event starting after end(u); in start order they form a range.
+  std::vector<double> suffix_min_end ( N + 1, std::numeric_limits<double>::infinity () );
+  for ( uint64_t i = N; i > 0; -- i ) {
+    suffix_min_end [ i - 1 ] = std::min ( end [ i - 1 ], suffix_min_end [ i ] );
+  }
+  Digraph digraph;
+  digraph . resize ( N );
+  for ( uint64_t u = 0; u < N; ++ u ) {
+    uint64_t first = std::upper_bound ( start . begin (), start . end (), end[u] ) - start . begin ();
+    if ( first == N ) continue;
+    uint64_t last = std::upper_bound ( start . begin (), start . end (), suffix_min_end[first] ) - start . begin ();
+    for ( uint64_t v = first; v < last; ++ v ) digraph . add_edge ( u, v );
+  }
+  // Successive events of the same variable are always ordered
+  std::vector<uint64_t> latest ( D, N );
+  for ( uint64_t i = 0; i < N; ++ i ) {
+    uint64_t d = events[i] . variable;
+    if ( latest[d] != N ) digraph . add_edge ( rank[latest[d]], rank[i] );
+    latest[d] = i;
+  }
+  digraph . finalize ();
+  uint64_t label = 0;
+  for ( uint64_t d = 0; d < D; ++ d ) {
+    int direction = data_ -> tracks_ [ d ] . direction;
+    if ( direction == 1 ) label |= (1LL << (d + D));
+    if ( direction == -1 ) label |= (1LL << d);
+  }
+  return Pattern ( Poset ( digraph ), variables, label, D );
+}
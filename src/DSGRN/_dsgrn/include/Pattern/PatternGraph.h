@@ -97,7 +97,7 @@ inline void
 PatternGraphBinding (py::module &m) {
   py::class_<PatternGraph, std::shared_ptr<PatternGraph>>(m, "PatternGraph")
     .def(py::init<>())
-    .def(py::init<Pattern const&>())
+    .def(py::init<Pattern const&>(), py::call_guard<py::gil_scoped_release>())
     .def("root", &PatternGraph::root)
     .def("leaf", &PatternGraph::leaf)
     .def("size", &PatternGraph::size)
@@ -71,9 +71,9 @@ namespace py = pybind11;
 
 inline
 void PatternMatchBinding(py::module &m) {
-  m.def("QueryCycleMatch", &QueryCycleMatch);
-  m.def("QueryPathMatch", &QueryPathMatch);
-  m.def("CycleMatch", &CycleMatch);
-  m.def("PathMatch", &PathMatch);
-  m.def("FindPath", &FindPath);
+  m.def("QueryCycleMatch", &QueryCycleMatch, py::call_guard<py::gil_scoped_release>());
+  m.def("QueryPathMatch", &QueryPathMatch, py::call_guard<py::gil_scoped_release>());
+  m.def("CycleMatch", &CycleMatch, py::call_guard<py::gil_scoped_release>());
+  m.def("PathMatch", &PathMatch, py::call_guard<py::gil_scoped_release>());
+  m.def("FindPath", &FindPath, py::call_guard<py::gil_scoped_release>());
 }
@@ -127,9 +127,9 @@ inline void
 SearchGraphBinding (py::module &m) {
   py::class_<SearchGraph, std::shared_ptr<SearchGraph>>(m, "SearchGraph")
     .def(py::init<>())
-    .def(py::init<DomainGraph const&>())
-    .def(py::init<DomainGraph const&, uint64_t>())
-    .def(py::init<std::vector<uint64_t> const&, uint64_t>())
+    .def(py::init<DomainGraph const&>(), py::call_guard<py::gil_scoped_release>())
+    .def(py::init<DomainGraph const&, uint64_t>(), py::call_guard<py::gil_scoped_release>())
+    .def(py::init<std::vector<uint64_t> const&, uint64_t>(), py::call_guard<py::gil_scoped_release>())
     .def("size", &SearchGraph::size)
     .def("dimension", &SearchGraph::dimension)
     .def("label", &SearchGraph::label)
@@ -6,6 +6,7 @@
 
 #include "common.h"
 #include "Parameter/Parameter.h"
+#include "Parameter/ParameterView.h"
 #include "Graph/Digraph.h"
 #include "Dynamics/Annotation.h"
 #include "Graph/Components.h"
@@ -29,8 +30,34 @@ public:
   void
   assign ( Parameter const& parameter );
 
+  /// assign
+  ///   Construct based on parameter and network, given the
+  ///   labelling of the parameter
+  ///   (This method is provided in case the labelling
+  ///    is already computed.)
+  void
+  assign ( Parameter const& parameter,
+           std::vector<uint64_t> const& labelling );
+
+  /// DomainGraph
+  ///   Construct based on a parameter view
+  DomainGraph ( ParameterView const& parameter );
+
+  /// assign
+  ///   Construct based on a parameter view
+  void
+  assign ( ParameterView const& parameter );
+
+  /// assign
+  ///   Construct based on a parameter view, given the
+  ///   labelling of the parameter
+  void
+  assign ( ParameterView const& parameter,
+           std::vector<uint64_t> const& labelling );
+
   /// parameter
-  ///   Return underlying parameter
+  ///   Return underlying parameter (for a domain graph
+  ///   constructed from a view, the parameter it views)
   Parameter const
   parameter ( void ) const;
 
@@ -52,6 +79,12 @@ public:
   std::vector<uint64_t>
   coordinates ( uint64_t domain ) const;
   
+  /// labelling
+  ///   Return the labels of all domains, indexed by domain
+  ///   (see Parameter::labelling)
+  std::vector<uint64_t> const&
+  labelling ( void ) const;
+
   /// label
   ///   Given a domain, return a 64-bit integer 
   ///   which indicates whether each wall is an entrance
@@ -108,12 +141,25 @@ public:
 
 private:
   std::shared_ptr<DomainGraph_> data_;
+
+  /// _assign
+  ///   Construct the digraph from the labelling, given a
+  ///   DomainGraph_ holding the network
+  void
+  _assign ( std::vector<uint64_t> const& labelling );
 };
 
 struct DomainGraph_ {
-  uint64_t dimension_;
+  DomainGraph_ ( void ) {}
+  DomainGraph_ ( Network const& network ) : network_(network) {}
+  uint64_t dimension_ = 0;
   Digraph digraph_;
-  Parameter parameter_;
+  Network network_;
+  // A domain graph constructed from a Parameter holds it in parameter_;
+  // one constructed from a view leaves parameter_ empty and holds the
+  // view, which does not allocate when default constructed
+  std::shared_ptr<Parameter const> parameter_;
+  ParameterView view_;
   std::vector<uint64_t> labelling_;
   std::unordered_map<uint64_t,uint64_t> direction_;
 };
@@ -122,18 +168,24 @@ struct DomainGraph_ {
 
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include "Tools/numpy.hpp"
 namespace py = pybind11;
 
 inline void
 DomainGraphBinding (py::module &m) {
   py::class_<DomainGraph, std::shared_ptr<DomainGraph>, TypedObject>(m, "DomainGraph")
     .def(py::init<>())
-    .def(py::init<Parameter const&>())
+    .def(py::init<Parameter const&>(), py::call_guard<py::gil_scoped_release>())
+    .def(py::init<ParameterView const&>(), py::call_guard<py::gil_scoped_release>())
     // TODO: increments
     .def("parameter", &DomainGraph::parameter)
     .def("digraph", &DomainGraph::digraph)
     .def("dimension", &DomainGraph::dimension)
     .def("coordinates", &DomainGraph::coordinates)
+    .def("labelling", &DomainGraph::labelling)
+    .def("labelling_array", [](DomainGraph const& dg) {
+      return dsgrn::numpy_view ( dg . labelling () . data (), dg . labelling () . size (), dg );
+    })
     .def("label", (uint64_t(DomainGraph::*)(uint64_t)const)&DomainGraph::label)
     .def("label", (uint64_t(DomainGraph::*)(uint64_t,uint64_t)const)&DomainGraph::label)
     .def("direction", &DomainGraph::direction)
@@ -10,6 +10,45 @@
 
 #include "DomainGraph.h"
 
+#include "Tools/dimension.hpp"
+
+namespace DomainGraph_detail {
+  /// Edges
+  ///   Add the edges of the domain graph with the given labelling to
+  ///   "digraph": a self-edge at each domain labelled 0, and an edge
+  ///   to the neighbor across each wall the label points out of (unless
+  ///   the neighbor points back). The edges of a domain are added in
+  ///   increasing order of target, since jump[0] < jump[1] < ...
+  template < uint64_t S >
+  struct Edges {
+    static void
+    run ( uint64_t dim, std::vector<uint64_t> const& jump,
+          std::vector<uint64_t> const& labelling, Digraph & digraph ) {
+      uint64_t const D = S ? S : dim;
+      dsgrn::DimensionArray<S> step;
+      for ( uint64_t d = 0; d < D; ++ d ) step[d] = jump[d];
+      uint64_t const N = labelling . size ();
+      uint64_t const* label = labelling . data ();
+      for ( uint64_t i = 0; i < N; ++ i ) {
+        uint64_t const x = label [ i ];
+        // Left neighbors, farthest first
+        for ( uint64_t k = D; k -- > 0; ) {
+          if ( ( x & ( 1LL << k ) ) && not ( label [ i - step[k] ] & ( 1LL << (D+k) ) ) ) {
+            digraph . add_edge ( i, i - step[k] );
+          }
+        }
+        if ( x == 0 ) digraph . add_edge ( i, i );
+        // Right neighbors, nearest first
+        for ( uint64_t k = 0; k < D; ++ k ) {
+          if ( ( x & ( 1LL << (D+k) ) ) && not ( label [ i + step[k] ] & ( 1LL << k ) ) ) {
+            digraph . add_edge ( i, i + step[k] );
+          }
+        }
+      }
+    }
+  };
+}
+
 INLINE_IF_HEADER_ONLY DomainGraph::
 DomainGraph ( void ) {
   data_ . reset ( new DomainGraph_ );
@@ -22,11 +61,41 @@ DomainGraph ( Parameter const& parameter ) {
 
 INLINE_IF_HEADER_ONLY void DomainGraph::
 assign ( Parameter const& parameter ) {
-  data_ . reset ( new DomainGraph_ );
-  data_ -> parameter_ = parameter;
-  uint64_t D = parameter . network () . size ();
+  assign ( parameter, parameter . labelling () );
+}
+
+INLINE_IF_HEADER_ONLY void DomainGraph::
+assign ( Parameter const& parameter,
+         std::vector<uint64_t> const& labelling ) {
+  data_ . reset ( new DomainGraph_ ( parameter . network () ) );
+  data_ -> parameter_ = std::make_shared<Parameter const> ( parameter );
+  _assign ( labelling );
+}
+
+INLINE_IF_HEADER_ONLY DomainGraph::
+DomainGraph ( ParameterView const& parameter ) {
+  assign ( parameter );
+}
+
+INLINE_IF_HEADER_ONLY void DomainGraph::
+assign ( ParameterView const& parameter ) {
+  assign ( parameter, parameter . labelling () );
+}
+
+INLINE_IF_HEADER_ONLY void DomainGraph::
+assign ( ParameterView const& parameter,
+         std::vector<uint64_t> const& labelling ) {
+  data_ . reset ( new DomainGraph_ ( parameter . network () ) );
+  data_ -> view_ = parameter;
+  _assign ( labelling );
+}
+
+INLINE_IF_HEADER_ONLY void DomainGraph::
+_assign ( std::vector<uint64_t> const& labelling ) {
+  Network const& network = data_ -> network_;
+  uint64_t D = network . size ();
   data_ -> dimension_ = D;
-  std::vector<uint64_t> limits = parameter . network() . domains ();
+  std::vector<uint64_t> limits = network . domains ();
   std::vector<uint64_t> jump ( D ); // index offset in each dim
   uint64_t N = 1;
   for ( uint64_t d = 0; d < D; ++ d ) {
@@ -34,38 +103,19 @@ assign ( Parameter const& parameter ) {
     N *=  limits [ d ];
     data_ -> direction_ [ jump[d] ] = d;
   }
-  data_ -> digraph_ = Digraph ();
   data_ -> digraph_ . resize ( N );
-  data_ -> labelling_ = parameter . labelling ();
-  Digraph & digraph = data_ -> digraph_;
-  std::vector<uint64_t> & labelling = data_ -> labelling_;
-  for ( uint64_t i = 0; i < N; ++ i ) {
-    if ( labelling [ i ] == 0 ) {
-      digraph . add_edge ( i, i );
-    }
-    uint64_t leftbit = 1;
-    uint64_t rightbit = (1LL << D);
-    for ( int d = 0; d < D; ++ d, leftbit <<= 1, rightbit <<= 1 ) {
-      if ( labelling [ i ] & rightbit ) {
-        uint64_t j = i + jump[d];
-        if ( not (labelling [ j ] & leftbit) ) {
-          digraph . add_edge ( i, j );
-        }
-      }
-      if ( labelling [ i ] & leftbit ) {
-        uint64_t j = i - jump[d];
-        if ( not (labelling [ j ] & rightbit) ) {
-          digraph . add_edge ( i, j );
-        }
-      }
-    }
+  if ( labelling . size () != N ) {
+    throw std::invalid_argument ( "DomainGraph::assign: labelling has the wrong size" );
   }
-  digraph . finalize ();
+  data_ -> labelling_ = labelling;
+  // The edges come out sorted, so the digraph needs no finalize
+  dsgrn::select_dimension<DomainGraph_detail::Edges> ( D ) ( D, jump, data_ -> labelling_, data_ -> digraph_ );
 }
 
 INLINE_IF_HEADER_ONLY Parameter const DomainGraph::
 parameter ( void ) const {
-  return data_ -> parameter_;
+  if ( data_ -> parameter_ ) return *data_ -> parameter_;
+  return data_ -> view_ . parameter ();
 }
 
 INLINE_IF_HEADER_ONLY Digraph const DomainGraph::
@@ -81,7 +131,7 @@ dimension ( void ) const {
 INLINE_IF_HEADER_ONLY std::vector<uint64_t> DomainGraph::
 coordinates ( uint64_t domain ) const {
   std::vector<uint64_t> result ( dimension () );
-  std::vector<uint64_t> limits = data_ -> parameter_ . network() . domains ();
+  std::vector<uint64_t> limits = data_ -> network_ . domains ();
   for ( int d = 0; d < dimension(); ++ d ) { 
     result[d] = domain % limits[d];
     domain = domain / limits[d];
@@ -89,6 +139,11 @@ coordinates ( uint64_t domain ) const {
   return result;
 }
 
+INLINE_IF_HEADER_ONLY std::vector<uint64_t> const& DomainGraph::
+labelling ( void ) const {
+  return data_ -> labelling_;
+}
+
 INLINE_IF_HEADER_ONLY uint64_t DomainGraph::
 label ( uint64_t domain ) const {
   return data_ -> labelling_ [ domain ];
@@ -100,7 +155,7 @@ label ( uint64_t source, uint64_t target ) const {
   uint64_t i = direction(source,target);
   uint64_t j = regulator(source,target);
   if ( i == j ) return 0;
-  return 1L << ( j + ( ((source < target) ^ parameter().network().interaction(i,j)) ? 0 : dimension() ) );
+  return 1L << ( j + ( ((source < target) ^ data_->network_.interaction(i,j)) ? 0 : dimension() ) );
 }
 
 INLINE_IF_HEADER_ONLY uint64_t DomainGraph::
@@ -112,18 +167,19 @@ direction ( uint64_t source, uint64_t target ) const {
 INLINE_IF_HEADER_ONLY uint64_t DomainGraph::
 regulator ( uint64_t source, uint64_t target ) const {
   if ( source == target ) return dimension ();
-  std::vector<uint64_t> limits = data_ -> parameter_ . network() . domains ();
+  std::vector<uint64_t> limits = data_ -> network_ . domains ();
   uint64_t variable = direction ( source, target );
   uint64_t domain = std::min(source,target);
   for ( int d = 0; d < variable; ++ d ) domain = domain / limits[d];
   uint64_t threshold = domain % limits[variable];
-  return data_ -> parameter_ . regulator ( variable, threshold );
+  if ( data_ -> parameter_ ) return data_ -> parameter_ -> regulator ( variable, threshold );
+  return data_ -> view_ . regulator ( variable, threshold );
 }
 
 INLINE_IF_HEADER_ONLY Annotation const DomainGraph::
 annotate ( Component const& vertices ) const {
-  uint64_t D = data_ ->parameter_ . network() . size ();
-  std::vector<uint64_t> limits = data_ -> parameter_ . network() . domains ();
+  uint64_t D = data_ -> network_ . size ();
+  std::vector<uint64_t> limits = data_ -> network_ . domains ();
   std::vector<uint64_t> domain_indices ( vertices.begin(), vertices.end() );
   std::vector<uint64_t> min_pos(D);
   std::vector<uint64_t> max_pos(D);
@@ -162,7 +218,7 @@ annotate ( Component const& vertices ) const {
     bool first_term = true;
     for ( uint64_t d : signature ) {
       if ( first_term ) first_term = false; else ss << ", ";
-      ss << data_ -> parameter_ . network() . name ( d );
+      ss << data_ -> network_ . name ( d );
     }
     ss << "}";
   }
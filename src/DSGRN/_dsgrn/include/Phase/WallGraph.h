@@ -7,6 +7,7 @@
 #include "common.h"
 
 #include "Parameter/Parameter.h"
+#include "Parameter/ParameterView.h"
 #include "Graph/Digraph.h"
 #include "Graph/Components.h"
 #include "Dynamics/Annotation.h"
@@ -30,6 +31,15 @@ public:
   void
   assign ( Parameter const parameter );
 
+  /// WallGraph
+  ///   Construct based on a parameter view
+  WallGraph ( ParameterView const& parameter );
+
+  /// assign
+  ///   Construct based on a parameter view
+  void
+  assign ( ParameterView const& parameter );
+
   /// digraph
   ///   Return underlying digraph
   Digraph const
@@ -45,11 +55,18 @@ public:
 
 private:
   std::shared_ptr<WallGraph_> data_;
+
+  /// _assign
+  ///   Construct the digraph from the network and the labelling
+  void
+  _assign ( Network const& network,
+            std::vector<uint64_t> const& labelling );
 };
 
 struct WallGraph_ {
+  WallGraph_ ( void ) {}
+  WallGraph_ ( Network const& network ) : network_(network) {}
   Digraph digraph_;
-  Parameter parameter_;
-  std::unordered_map<uint64_t, uint64_t> wall_index_to_vertex_;
+  Network network_;
   std::vector<uint64_t> vertex_to_dimension_;
 };
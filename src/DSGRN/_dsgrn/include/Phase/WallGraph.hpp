@@ -22,77 +22,104 @@ WallGraph ( Parameter const parameter ) {
 
 INLINE_IF_HEADER_ONLY void WallGraph::
 assign ( Parameter const parameter ) {
-  data_ . reset ( new WallGraph_ );
+  _assign ( parameter . network (), parameter . labelling () );
+}
 
-  data_ -> wall_index_to_vertex_ . clear ();
-  data_ -> vertex_to_dimension_ . clear ();
-  data_ -> parameter_ = parameter;
-  int D = parameter . network() . size ();
-  std::vector<uint64_t> limits = parameter . network() . domains ();
-  data_ -> digraph_ = Digraph ();
-  // Make wall indices
-  for ( Domain dom (limits); dom.isValid(); ++ dom ) {
-    for ( int d = 0; d < D; ++ d ) {
-      if ( not dom . isMin(d) ) {
-        Wall wall ( dom, d, -1 );
-        uint64_t v = data_ -> digraph_ . add_vertex ();
-        data_ -> wall_index_to_vertex_ [ wall.index() ] = v;
-        //std::cout << "Created wall with index " << wall.index() << " = vertex " << v << "\n";
-        data_ -> vertex_to_dimension_ . push_back ( d );
-      }
-    }
+INLINE_IF_HEADER_ONLY WallGraph::
+WallGraph ( ParameterView const& parameter ) {
+  assign ( parameter );
+}
+
+INLINE_IF_HEADER_ONLY void WallGraph::
+assign ( ParameterView const& parameter ) {
+  _assign ( parameter . network (), parameter . labelling () );
+}
+
+INLINE_IF_HEADER_ONLY void WallGraph::
+_assign ( Network const& network,
+          std::vector<uint64_t> const& labelling ) {
+  data_ . reset ( new WallGraph_ ( network ) );
+  uint64_t D = network . size ();
+  std::vector<uint64_t> limits = network . domains ();
+  std::vector<uint64_t> jump ( D ); // index offset in each dim
+  uint64_t N = 1;
+  for ( uint64_t d = 0; d < D; ++ d ) {
+    jump[d] = N;
+    N *= limits [ d ];
   }
-  // Determine dynamics
-  for ( Domain dom (limits); dom.isValid(); ++ dom ) {
-    std::vector<Wall> entrance;
-    std::vector<Wall> absorbing;
-    for ( int d = 0; d < D; ++ d ) {
-      if ( not dom . isMin(d) ) {
-        Wall wall ( dom, d, -1 );
-        //std::cout << "Wallcheck. Left wall (dim " << d << ") of domain "
-        //          << dom.index() << " is wall " << wall.index() << "\n";
-        if ( parameter . absorbing ( dom, d, -1 ) ) {
-          absorbing . push_back ( wall );
-        } else {
-          entrance . push_back ( wall );
-        }
+  // The labelling has bit d set if the left wall of a domain in dimension d
+  // is absorbing and bit D+d set if the right wall is; a domain with no
+  // absorbing walls (labelling 0) gets a vertex of its own with a self-edge.
+  // Vertices are the walls, in order of (domain index, dimension) where each
+  // domain numbers the walls on its left, followed by the attracting domains
+  // in order of domain index.
+  // first_wall(i) is the number of walls to the left of the domains with
+  // index less than i. Of these domains, those with coordinate 0 in
+  // dimension d (which have no wall on their left in dimension d) number
+  //   (i / (jump[d]*limits[d])) * jump[d] + min(i % (jump[d]*limits[d]), jump[d])
+  auto first_wall = [&] ( uint64_t i ) {
+    uint64_t result = 0;
+    for ( uint64_t d = 0; d < D; ++ d ) {
+      uint64_t period = jump[d] * limits[d];
+      result += i - ( i / period ) * jump[d] - std::min ( i % period, jump[d] );
+    }
+    return result;
+  };
+  uint64_t num_walls = first_wall ( N );
+  uint64_t num_attractors = std::count ( labelling . begin (), labelling . end (), 0 );
+  Digraph & digraph = data_ -> digraph_;
+  digraph = Digraph ();
+  digraph . resize ( num_walls + num_attractors );
+  data_ -> vertex_to_dimension_ . resize ( num_walls + num_attractors );
+  std::vector<uint64_t> coordinates ( D, 0 );
+  std::vector<uint64_t> entrance;
+  std::vector<uint64_t> absorbing;
+  uint64_t wall = 0;
+  uint64_t attractor = num_walls;
+  for ( uint64_t i = 0; i < N; ++ i ) {
+    uint64_t label = labelling [ i ];
+    entrance . clear ();
+    absorbing . clear ();
+    uint64_t leftbit = 1;
+    uint64_t rightbit = (1LL << D);
+    for ( uint64_t d = 0; d < D; ++ d, leftbit <<= 1, rightbit <<= 1 ) {
+      if ( coordinates[d] > 0 ) {
+        data_ -> vertex_to_dimension_ [ wall ] = d;
+        if ( label & leftbit ) absorbing . push_back ( wall ); else entrance . push_back ( wall );
+        ++ wall;
       }
-      if ( not dom . isMax(d) ) {
-        Wall wall ( dom, d, 1 );
-        //std::cout << "Wallcheck. Right wall (dim " << d << ") of domain "
-        //          << dom.index() << " is wall " << wall.index() << "\n";
-        if ( parameter . absorbing ( dom, d, 1 ) ) {
-          absorbing . push_back ( wall );
-        } else {
-          entrance . push_back ( wall );
+      if ( coordinates[d] + 1 < limits[d] ) {
+        // The right wall in dimension d is the left wall of domain j
+        uint64_t j = i + jump[d];
+        uint64_t v = first_wall ( j );
+        for ( uint64_t k = 0; k < d; ++ k ) {
+          if ( ( j / jump[k] ) % limits[k] > 0 ) ++ v;
         }
+        if ( label & rightbit ) absorbing . push_back ( v ); else entrance . push_back ( v );
       }
     }
-    for ( Wall const& x : entrance ) {
-      for ( Wall const& y : absorbing ) {
-        uint64_t i = data_ -> wall_index_to_vertex_ [ x.index() ];
-        uint64_t j = data_ -> wall_index_to_vertex_ [ y.index() ];
-        //std::cout << "Adding wall-wall edge " << i << " -> " << j << "\n";
-        data_ -> digraph_ . add_edge ( i, j );
-      }
+    for ( uint64_t x : entrance ) {
+      for ( uint64_t y : absorbing ) digraph . add_edge ( x, y );
     }
-    if ( absorbing . empty () ) {
-      uint64_t attract = data_ -> digraph_ . add_vertex ();
-      data_ -> digraph_ . add_edge ( attract, attract );
-      data_ -> vertex_to_dimension_ . push_back ( D );
+    if ( label == 0 ) {
+      digraph . add_edge ( attractor, attractor );
       // (annotations wants to know how many variables pass 1st threshold
       // for domains)
-      for ( int d = 0; d < D; ++ d ) {
-        if ( dom [ d ] > 0 ) ++ data_ -> vertex_to_dimension_ [ attract ];
-      }
-      for ( Wall const& x : entrance ) {
-        uint64_t i = data_ -> wall_index_to_vertex_ [ x.index() ];
-        //std::cout << "Adding wall-domain edge " << i << " -> " << attract << "\n";
-        data_ -> digraph_ . add_edge ( i, attract );
+      uint64_t & dimension = data_ -> vertex_to_dimension_ [ attractor ];
+      dimension = D;
+      for ( uint64_t d = 0; d < D; ++ d ) {
+        if ( coordinates [ d ] > 0 ) ++ dimension;
       }
+      for ( uint64_t x : entrance ) digraph . add_edge ( x, attractor );
+      ++ attractor;
+    }
+    // next domain
+    for ( uint64_t d = 0; d < D; ++ d ) {
+      if ( ++ coordinates[d] < limits[d] ) break;
+      coordinates[d] = 0;
     }
   }
-  data_ -> digraph_ . finalize ();
+  digraph . finalize ();
 }
 
 INLINE_IF_HEADER_ONLY Digraph const WallGraph::
@@ -102,7 +129,7 @@ digraph ( void ) const {
 
 INLINE_IF_HEADER_ONLY Annotation const WallGraph::
 annotate ( Component const& vertices ) const {
-  uint64_t D = data_ -> parameter_ . network() . size ();
+  uint64_t D = data_ -> network_ . size ();
   std::set<uint64_t> signature;
   // bool all_on = true;
   // bool all_off = true;
@@ -118,7 +145,7 @@ annotate ( Component const& vertices ) const {
     ss << "FP { ";
 
     // Because signature . size () == 0, we just need to retreive min_pos
-    std::vector<uint64_t> limits = data_ -> parameter_ . network() . domains ();
+    std::vector<uint64_t> limits = data_ -> network_ . domains ();
     std::vector<uint64_t> domain_indices ( vertices.begin(), vertices.end() );
     std::vector<uint64_t> min_pos(D);
     std::vector<uint64_t> max_pos(D);
@@ -151,7 +178,7 @@ annotate ( Component const& vertices ) const {
     bool first_term = true;
     for ( uint64_t d : signature ) {
       if ( first_term ) first_term = false; else ss << ", ";
-      ss << data_ ->parameter_ . network() . name ( d );
+      ss << data_ -> network_ . name ( d );
     }
     ss << "}";
   }
@@ -9,7 +9,10 @@
 
 #include "Parameter/Network.h"
 #include "Parameter/ParameterGraph.h"
+#include "Parameter/Registry.h"
 #include "Query/NFA.h"
+#include "Query/DFA.h"
+#include "Tools/parallel.hpp"
 
 struct ComputeSingleGeneQuery_ {
   Network network;
@@ -42,6 +45,10 @@ class ComputeSingleGeneQuery {
 public:
   ComputeSingleGeneQuery(Network network, std::string const& gene, std::function<char(uint64_t)> labeller);
 
+  /// ComputeSingleGeneQuery
+  ///   Construct without a labeller, for use with "matches" only
+  ComputeSingleGeneQuery(Network network, std::string const& gene);
+
   /// operator ()
   ///   The query returns a NFA which recognizes paths through the Hasse diagram of the poset of gene parameter indices 
   ///   corresponding to adjusting the parameter by changing the logic parameter associated 
@@ -80,6 +87,47 @@ public:
   uint64_t
   number_of_reduced_parameters(void) const;
 
+  /// matches
+  ///   Evaluate the query for every reduced parameter index at once, without
+  ///   building NFAs or calling the labeller. The label of a parameter index pi
+  ///   is labels[signatures[pi]], i.e. "signatures" maps parameter indices to
+  ///   Morse graph indices and "labels" maps Morse graph indices to labels.
+  ///   A reduced parameter index matches if some path of the graph returned by
+  ///   operator() spells a word accepted by "dfa"; the number of such paths
+  ///   (saturating at 2^64-1) is also computed. Reduced parameter indices are
+  ///   processed in parallel by "num_threads" threads (0 means one per
+  ///   hardware thread).
+  ///   Returns the sorted list of (rpi, number of matching paths) for all
+  ///   matching reduced parameter indices.
+  std::vector<std::pair<uint64_t,uint64_t>>
+  matches ( DFA const& dfa,
+            char const* labels, uint64_t num_labels,
+            uint64_t const* signatures, uint64_t num_signatures,
+            uint64_t num_threads = 0 ) const;
+
+  /// matches
+  ///   Compile "regex" and evaluate it for every reduced parameter index
+  std::vector<std::pair<uint64_t,uint64_t>>
+  matches ( std::string const& regex,
+            std::string const& labels,
+            std::vector<uint64_t> const& signatures,
+            uint64_t num_threads = 0 ) const;
+
+  /// inducibility
+  ///   Evaluate an inducibility query for every reduced parameter index at once.
+  ///   "flags" maps Morse graph indices to bit flags and "signatures" maps
+  ///   parameter indices to Morse graph indices. Writing F(gpi) for the flags of
+  ///   the Morse graph at (rpi, gpi) and M for the largest gene parameter index,
+  ///   entry rpi of the result has
+  ///     bit 1 set iff F(0) has bit 1 set,
+  ///     bit 2 set iff F(M) has bit 2 set,
+  ///     bit 4 set iff F(gpi) has bit 4 set for some 0 < gpi < M.
+  ///   Reduced parameter indices are processed by "num_threads" threads.
+  std::vector<uint8_t>
+  inducibility ( uint8_t const* flags, uint64_t num_flags,
+                 uint64_t const* signatures, uint64_t num_signatures,
+                 uint64_t num_threads = 0 ) const;
+
 private:
   ComputeSingleGeneQuery_ self;
 };
@@ -89,6 +137,7 @@ private:
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/functional.h>
+#include <pybind11/numpy.h>
 
 namespace py = pybind11;
 
@@ -96,10 +145,54 @@ inline void
 ComputeSingleGeneQueryBinding (py::module &m) {
   py::class_<ComputeSingleGeneQuery, std::shared_ptr<ComputeSingleGeneQuery>>(m, "NewComputeSingleGeneQuery")
     .def(py::init<Network, std::string const&, std::function<char(uint64_t)>>())
+    .def(py::init<Network, std::string const&>())
     .def("__call__", &ComputeSingleGeneQuery::operator())
     .def("full_parameter_index",&ComputeSingleGeneQuery::full_parameter_index)
     .def("reduced_parameter_index",&ComputeSingleGeneQuery::reduced_parameter_index)
     .def("number_of_gene_parameters", &ComputeSingleGeneQuery::number_of_gene_parameters)
-    .def("number_of_reduced_parameters", &ComputeSingleGeneQuery::number_of_reduced_parameters);
+    .def("number_of_reduced_parameters", &ComputeSingleGeneQuery::number_of_reduced_parameters)
+    .def("matches", [](ComputeSingleGeneQuery const& query, std::string const& regex,
+                       py::array_t<uint8_t, py::array::c_style | py::array::forcecast> labels,
+                       py::array_t<uint64_t, py::array::c_style | py::array::forcecast> signatures,
+                       bool counts, uint64_t num_threads) -> py::object {
+      // "labels" holds one character code per Morse graph index, e.g.
+      // numpy.frombuffer(b"QqBpPO", dtype=numpy.uint8); "signatures" holds
+      // the Morse graph index of each parameter index. Both are read in
+      // place, after conversion to contiguous arrays if needed.
+      py::buffer_info l = labels . request ();
+      py::buffer_info s = signatures . request ();
+      if ( l . ndim != 1 || s . ndim != 1 ) {
+        throw std::invalid_argument("ComputeSingleGeneQuery::matches: expected one-dimensional label and signature arrays");
+      }
+      std::vector<std::pair<uint64_t,uint64_t>> result;
+      {
+        py::gil_scoped_release release;
+        result = query . matches ( CompileRegexToDFA(regex), (char const*) l . ptr, l . shape[0],
+                                   (uint64_t const*) s . ptr, s . shape[0], num_threads );
+      }
+      if ( counts ) return py::cast(result);
+      std::vector<uint64_t> rpis;
+      for ( auto const& match : result ) rpis . push_back ( match . first );
+      return py::cast(rpis);
+    }, py::arg("regex"), py::arg("labels"), py::arg("signatures"), py::arg("counts") = false, py::arg("num_threads") = 0)
+    .def("inducibility", [](ComputeSingleGeneQuery const& query,
+                            py::array_t<uint8_t, py::array::c_style | py::array::forcecast> flags,
+                            py::array_t<uint64_t, py::array::c_style | py::array::forcecast> signatures,
+                            uint64_t num_threads) {
+      py::buffer_info f = flags . request ();
+      py::buffer_info s = signatures . request ();
+      if ( f . ndim != 1 || s . ndim != 1 ) {
+        throw std::invalid_argument("ComputeSingleGeneQuery::inducibility: expected one-dimensional flag and signature arrays");
+      }
+      std::vector<uint8_t> bits;
+      {
+        py::gil_scoped_release release;
+        bits = query . inducibility ( (uint8_t const*) f . ptr, f . shape[0],
+                                      (uint64_t const*) s . ptr, s . shape[0], num_threads );
+      }
+      py::array_t<uint8_t> result ( bits . size () );
+      std::copy ( bits . begin (), bits . end (), result . mutable_data () );
+      return result;
+    }, py::arg("flags"), py::arg("signatures"), py::arg("num_threads") = 0);
 }
 
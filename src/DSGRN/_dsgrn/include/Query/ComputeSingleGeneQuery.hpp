@@ -5,17 +5,11 @@
 
 #include "ComputeSingleGeneQuery.h"
 
-namespace ComputeSingleGeneQuery_detail_ {
-  inline bool isPowerOfTwo(uint64_t x) { return x && (!(x & (x - 1)));}
-  inline bool HammingDistanceOne(uint64_t x, uint64_t y) {return isPowerOfTwo(x ^ y);}
-}
-
 inline ComputeSingleGeneQuery::
 ComputeSingleGeneQuery(Network network, std::string const& gene, std::function<char(uint64_t)> labeller) {
-  using namespace ComputeSingleGeneQuery_detail_;
   self.network = network;
   self.gene = gene;
-  self.parametergraph = ParameterGraph(self.network);
+  self.parametergraph = registry()->parametergraph(self.network);
   self.D = self.parametergraph.dimension();
   //self.names = [ self.network.name(i) for i in range(0, self.D)]
 
@@ -52,9 +46,6 @@ ComputeSingleGeneQuery(Network network, std::string const& gene, std::function<c
   self.num_reduced_param = self.parametergraph.size() / self.num_gene_param;
 
   // Create factor graph
-  // TODO: The following algorithm for creating a factor graph takes O(NM^2) time, where N is length of hexcodes and M is size of factorgraph.
-  //       An O(NM) algorithm is possible (based on looping through codewords and trying out each promotion, using a hash table)
-  //       Implement this.
   self.hexcodes = self.parametergraph.factorgraph(self.gene_index);
   self.labeller = labeller;
 
@@ -64,20 +55,18 @@ ComputeSingleGeneQuery(Network network, std::string const& gene, std::function<c
   for ( uint64_t i = 0; i < n; ++ i ) self.vertices[i] = i;
 
   // Set of edges
-  for ( auto gpi1 : self.vertices ) {
-    auto x = stoull(self.hexcodes[gpi1], 0, 16 );
-    for ( auto gpi2 : self.vertices ) {
-      auto y = stoull(self.hexcodes[gpi2], 0, 16 );
-      if ( x < y && HammingDistanceOne(x,y)) {
-        self.edges.push_back({gpi1, gpi2});
-      }
-    }
-  }
+  self.edges = self.parametergraph.factorgraph_edges(self.gene_index);
   // Add leaf node by convention (we match on edges, not nodes, so edge to leaf will have label to match last node)
   self.vertices.push_back(n);
   self.edges.push_back({n-1,n});
 }
 
+inline ComputeSingleGeneQuery::
+ComputeSingleGeneQuery(Network network, std::string const& gene) :
+  ComputeSingleGeneQuery(network, gene, [](uint64_t) -> char {
+    throw std::logic_error("ComputeSingleGeneQuery: no labeller was provided");
+  }) {}
+
 inline uint64_t ComputeSingleGeneQuery::
 full_parameter_index(uint64_t rpi, uint64_t gpi) const { 
   return rpi % self.indexing_place_values[self.gene_index] + gpi * self.indexing_place_values[self.gene_index] + 
@@ -123,6 +112,7 @@ operator () (uint64_t reduced_parameter_index) const {
   }
   result.set_initial(0);
   result.set_final(self.vertices.size()-1);
+  result.finalize();
   return result;
 }
 
@@ -142,3 +132,115 @@ inline uint64_t ComputeSingleGeneQuery::
 number_of_reduced_parameters(void) const {
   return self.num_reduced_param;
 }
+
+inline std::vector<std::pair<uint64_t,uint64_t>> ComputeSingleGeneQuery::
+matches ( DFA const& dfa,
+          char const* labels, uint64_t num_labels,
+          uint64_t const* signatures, uint64_t num_signatures,
+          uint64_t num_threads ) const {
+  if ( num_signatures != self.parametergraph.size() ) {
+    throw std::invalid_argument("ComputeSingleGeneQuery::matches: expected one signature per parameter index");
+  }
+  uint64_t const saturated = std::numeric_limits<uint64_t>::max ();
+  // Vertices 0 ... n-1 are gene parameter indices, vertex n is the leaf.
+  // Every out-edge of u carries the label of u.
+  uint64_t const n = self.vertices.size() - 1;
+  std::vector<uint64_t> offsets ( n + 2, 0 );
+  for ( auto const& e : self.edges ) ++ offsets[e.first+1];
+  for ( uint64_t v = 0; v <= n; ++ v ) offsets[v+1] += offsets[v];
+  std::vector<uint64_t> targets ( self.edges.size() );
+  std::vector<uint64_t> fill ( offsets.begin(), offsets.end() - 1 );
+  for ( auto const& e : self.edges ) targets[fill[e.first]++] = e.second;
+  // Topological order of the factor graph (edges go from lower to higher
+  // hex codes, so it is acyclic)
+  std::vector<uint64_t> indegree ( n + 1, 0 );
+  for ( auto const& e : self.edges ) ++ indegree[e.second];
+  std::vector<uint64_t> order;
+  for ( uint64_t v = 0; v <= n; ++ v ) if ( indegree[v] == 0 ) order.push_back(v);
+  for ( uint64_t i = 0; i < order.size(); ++ i ) {
+    uint64_t u = order[i];
+    for ( uint64_t k = offsets[u]; k < offsets[u+1]; ++ k ) {
+      if ( -- indegree[targets[k]] == 0 ) order.push_back(targets[k]);
+    }
+  }
+  // Transition table of the DFA indexed by (state, character)
+  uint64_t const S = dfa.num_states();
+  std::vector<int64_t> next ( S * 256 );
+  for ( uint64_t s = 0; s < S; ++ s ) {
+    for ( uint64_t c = 0; c < 256; ++ c ) next[s*256+c] = dfa.transition(s, (char) c);
+  }
+  uint64_t const T = ( num_threads == 0 ) ? dsgrn::hardware_threads () : num_threads;
+  // Per-thread scratch space and results
+  std::vector<std::vector<uint64_t>> paths ( T, std::vector<uint64_t> ( (n + 1) * S ) );
+  std::vector<std::vector<std::pair<uint64_t,uint64_t>>> results ( T );
+  dsgrn::parallel_for ( 0, self.num_reduced_param, T, 64, [&](uint64_t thread, uint64_t rpi) {
+    // paths[v*S+s] is the number of paths from vertex 0 to v driving the DFA to state s
+    auto & count = paths[thread];
+    std::fill(count.begin(), count.end(), 0);
+    count[dfa.initial()] = 1;
+    for ( auto u : order ) {
+      if ( u == n ) break;
+      uint64_t mgi = signatures[full_parameter_index(rpi, u)];
+      if ( mgi >= num_labels ) {
+        throw std::invalid_argument("ComputeSingleGeneQuery::matches: Morse graph index has no label");
+      }
+      unsigned char label = labels[mgi];
+      for ( uint64_t s = 0; s < S; ++ s ) {
+        uint64_t c = count[u*S+s];
+        if ( c == 0 ) continue;
+        int64_t t = next[s*256+label];
+        if ( t == -1 ) continue;
+        for ( uint64_t k = offsets[u]; k < offsets[u+1]; ++ k ) {
+          uint64_t & x = count[targets[k]*S+t];
+          x = ( x > saturated - c ) ? saturated : x + c;
+        }
+      }
+    }
+    uint64_t total = 0;
+    for ( uint64_t s = 0; s < S; ++ s ) {
+      if ( not dfa.accepting(s) ) continue;
+      uint64_t c = count[n*S+s];
+      total = ( total > saturated - c ) ? saturated : total + c;
+    }
+    if ( total > 0 ) results[thread].push_back({rpi, total});
+  });
+  std::vector<std::pair<uint64_t,uint64_t>> result;
+  for ( auto const& r : results ) result.insert(result.end(), r.begin(), r.end());
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+inline std::vector<std::pair<uint64_t,uint64_t>> ComputeSingleGeneQuery::
+matches ( std::string const& regex,
+          std::string const& labels,
+          std::vector<uint64_t> const& signatures,
+          uint64_t num_threads ) const {
+  return matches ( CompileRegexToDFA(regex), labels.data(), labels.size(),
+                   signatures.data(), signatures.size(), num_threads );
+}
+
+inline std::vector<uint8_t> ComputeSingleGeneQuery::
+inducibility ( uint8_t const* flags, uint64_t num_flags,
+               uint64_t const* signatures, uint64_t num_signatures,
+               uint64_t num_threads ) const {
+  if ( num_signatures != self.parametergraph.size() ) {
+    throw std::invalid_argument("ComputeSingleGeneQuery::inducibility: expected one signature per parameter index");
+  }
+  uint64_t const M = self.num_gene_param - 1;
+  std::vector<uint8_t> result ( self.num_reduced_param, 0 );
+  dsgrn::parallel_for ( 0, self.num_reduced_param, num_threads, 1024, [&](uint64_t, uint64_t rpi) {
+    auto flag = [&](uint64_t gpi) {
+      uint64_t mgi = signatures[full_parameter_index(rpi, gpi)];
+      if ( mgi >= num_flags ) {
+        throw std::invalid_argument("ComputeSingleGeneQuery::inducibility: Morse graph index has no flags");
+      }
+      return flags[mgi];
+    };
+    uint8_t bits = ( flag(0) & 1 ) | ( flag(M) & 2 );
+    for ( uint64_t gpi = 1; gpi < M; ++ gpi ) {
+      if ( flag(gpi) & 4 ) { bits |= 4; break; }
+    }
+    result[rpi] = bits;
+  });
+  return result;
+}
@@ -0,0 +1,124 @@
+/// DFA.h
+/// Shaun Harker
+/// 2018-11-07
+/// MIT LICENSE
+
+#pragma once
+
+#include "common.h"
+#include "Graph/LabelledMultidigraph.h"
+#include "Query/NFA.h"
+
+/// DFA
+///   deterministic finite automata with a partial transition function
+///   (missing transitions lead to rejection)
+///   A DFA is only modified by construction and assign, so it may be
+///   shared between threads once built.
+class DFA {
+public:
+  typedef char LabelType;
+
+  /// DFA
+  DFA ( void );
+
+  /// DFA
+  ///   Construct from an NFA via subset construction followed by
+  ///   Hopcroft minimization. Epsilon transitions (' ') are eliminated.
+  DFA ( NFA const& nfa );
+
+  /// assign
+  ///   Construct from an NFA via subset construction followed by
+  ///   Hopcroft minimization
+  void
+  assign ( NFA const& nfa );
+
+  /// num_states
+  uint64_t
+  num_states ( void ) const;
+
+  /// alphabet
+  ///   Return the labels which have transitions, in sorted order
+  std::string
+  alphabet ( void ) const;
+
+  /// initial
+  ///   Return start state
+  uint64_t
+  initial ( void ) const;
+
+  /// accepting
+  ///   Return true if state is accepting
+  bool
+  accepting ( uint64_t state ) const;
+
+  /// transition
+  ///   Return state reached from "state" on "label", or -1 if none
+  int64_t
+  transition ( uint64_t state, LabelType label ) const;
+
+  /// accepts
+  ///   Return true if the word is in the language of the automaton
+  bool
+  accepts ( std::string const& word ) const;
+
+  /// accepts
+  ///   Return true if some path in "graph" from its initial vertex to its
+  ///   final vertex is labelled with a word in the language. Epsilon (' ')
+  ///   edges of the graph are free moves, as they are in the NFA the DFA
+  ///   was built from, so this agrees with NFA::intersects(nfa, graph).
+  ///   The set of DFA states reachable at each vertex is kept as a bitset
+  ///   and propagated in one pass in topological order when the graph
+  ///   (apart from epsilon self-loops) is acyclic, and by iterating to a
+  ///   fixed point otherwise.
+  bool
+  accepts ( LabelledMultidigraph const& graph, uint64_t initial, uint64_t final ) const;
+
+  /// accepts
+  ///   Return true if some path from initial to final in "graph" is
+  ///   labelled with a word in the language
+  bool
+  accepts ( NFA const& graph ) const;
+
+  /// graphviz
+  std::string
+  graphviz ( void ) const;
+
+private:
+  uint64_t num_states_;
+  uint64_t initial_;
+  std::vector<bool> accepting_;
+  std::string alphabet_;
+  // symbol_[c] is the position of c in alphabet_, or -1
+  std::vector<int64_t> symbol_;
+  // transitions_[s*|alphabet|+k] is the target of state s on alphabet_[k], or -1
+  std::vector<int64_t> transitions_;
+};
+
+/// CompileRegexToDFA
+///   Compile a regular expression (as accepted by CompileRegexToNFA)
+///   to a minimal DFA
+DFA
+CompileRegexToDFA (std::string const& regex);
+
+/// Python Bindings
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+namespace py = pybind11;
+
+inline void
+DFABinding (py::module &m) {
+  py::class_<DFA, std::shared_ptr<DFA>>(m, "DFA")
+    .def(py::init<>())
+    .def(py::init<NFA const&>(), py::call_guard<py::gil_scoped_release>())
+    .def("num_states", &DFA::num_states)
+    .def("alphabet", &DFA::alphabet)
+    .def("initial", &DFA::initial)
+    .def("accepting", &DFA::accepting)
+    .def("transition", &DFA::transition)
+    .def("accepts", (bool (DFA::*)(std::string const&) const) &DFA::accepts)
+    .def("accepts", (bool (DFA::*)(NFA const&) const) &DFA::accepts, py::call_guard<py::gil_scoped_release>())
+    .def("accepts", (bool (DFA::*)(LabelledMultidigraph const&, uint64_t, uint64_t) const) &DFA::accepts, py::call_guard<py::gil_scoped_release>())
+    .def("graphviz", &DFA::graphviz);
+  m.def("CompileRegexToDFA", &CompileRegexToDFA);
+}
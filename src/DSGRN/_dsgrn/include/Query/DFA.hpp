@@ -0,0 +1,337 @@
+/// DFA.hpp
+/// Shaun Harker
+/// 2018-11-07
+/// MIT LICENSE
+
+#include "DFA.h"
+#include "Query/ThompsonsConstruction.h"
+
+inline DFA::DFA ( void ) : num_states_(1), initial_(0), accepting_(1, false), symbol_(256, -1) {}
+
+inline DFA::DFA ( NFA const& nfa ) {
+  assign ( nfa );
+}
+
+inline void DFA::
+assign ( NFA const& nfa ) {
+  // Collect alphabet
+  symbol_ . assign ( 256, -1 );
+  std::set<LabelType> labels;
+  for ( uint64_t v = 0; v < nfa.num_vertices(); ++ v ) {
+    for ( auto const& e : nfa.edges(v) ) if ( e.first != ' ' ) labels.insert(e.first);
+  }
+  alphabet_ = std::string(labels.begin(), labels.end());
+  for ( uint64_t k = 0; k < alphabet_.size(); ++ k ) symbol_[(unsigned char)alphabet_[k]] = k;
+  uint64_t const K = alphabet_.size();
+
+  // Subset construction. Subsets are sorted vectors of NFA vertices,
+  // closed under epsilon transitions.
+  typedef std::vector<uint64_t> Subset;
+  auto closure = [&](Subset subset) {
+    std::vector<bool> member ( nfa.num_vertices(), false );
+    for ( auto v : subset ) member[v] = true;
+    std::vector<uint64_t> work_stack ( subset );
+    while ( not work_stack.empty() ) {
+      auto v = work_stack.back();
+      work_stack.pop_back();
+      for ( auto const& e : nfa.edges(v, ' ') ) {
+        if ( member[e.second] ) continue;
+        member[e.second] = true;
+        subset.push_back(e.second);
+        work_stack.push_back(e.second);
+      }
+    }
+    std::sort(subset.begin(), subset.end());
+    return subset;
+  };
+  std::map<Subset, uint64_t> subset_index;
+  std::vector<Subset> subsets;
+  std::vector<int64_t> delta;
+  auto index = [&](Subset const& subset) {
+    auto it = subset_index.find(subset);
+    if ( it != subset_index.end() ) return it -> second;
+    uint64_t i = subsets.size();
+    subset_index[subset] = i;
+    subsets.push_back(subset);
+    delta.resize(delta.size() + K, -1);
+    return i;
+  };
+  if ( nfa.initial() < nfa.num_vertices() ) index(closure({nfa.initial()}));
+  for ( uint64_t i = 0; i < subsets.size(); ++ i ) {
+    for ( uint64_t k = 0; k < K; ++ k ) {
+      Subset next;
+      for ( auto v : subsets[i] ) {
+        for ( auto const& e : nfa.edges(v, alphabet_[k]) ) next.push_back(e.second);
+      }
+      if ( next.empty() ) continue;
+      std::sort(next.begin(), next.end());
+      next.erase(std::unique(next.begin(), next.end()), next.end());
+      delta[i*K+k] = index(closure(next));
+    }
+  }
+
+  // Complete the automaton with a dead state, numbered Q-1
+  uint64_t const Q = subsets.size() + 1;
+  uint64_t const dead = Q - 1;
+  std::vector<uint64_t> complete ( Q * K, dead );
+  std::vector<bool> is_final ( Q, false );
+  for ( uint64_t i = 0; i + 1 < Q; ++ i ) {
+    for ( uint64_t k = 0; k < K; ++ k ) if ( delta[i*K+k] != -1 ) complete[i*K+k] = delta[i*K+k];
+    is_final[i] = std::binary_search(subsets[i].begin(), subsets[i].end(), nfa.final());
+  }
+
+  // Hopcroft minimization by partition refinement
+  std::vector<std::vector<uint64_t>> inverse ( Q * K );
+  for ( uint64_t q = 0; q < Q; ++ q ) {
+    for ( uint64_t k = 0; k < K; ++ k ) inverse[complete[q*K+k]*K+k].push_back(q);
+  }
+  std::vector<std::vector<uint64_t>> blocks;
+  std::vector<uint64_t> block_of ( Q );
+  std::vector<bool> in_worklist;
+  std::vector<uint64_t> worklist;
+  for ( int accepting_block = 1; accepting_block >= 0; -- accepting_block ) {
+    std::vector<uint64_t> members;
+    for ( uint64_t q = 0; q < Q; ++ q ) if ( is_final[q] == (accepting_block == 1) ) members.push_back(q);
+    if ( members.empty() ) continue;
+    for ( auto q : members ) block_of[q] = blocks.size();
+    worklist.push_back(blocks.size());
+    in_worklist.push_back(true);
+    blocks.push_back(members);
+  }
+  std::vector<bool> marked ( Q, false );
+  std::vector<uint64_t> touched_count;
+  while ( not worklist.empty() ) {
+    uint64_t A = worklist.back();
+    worklist.pop_back();
+    in_worklist[A] = false;
+    std::vector<uint64_t> splitter = blocks[A];
+    for ( uint64_t k = 0; k < K; ++ k ) {
+      // X is the set of states entering the splitter on label k
+      std::vector<uint64_t> X;
+      for ( auto a : splitter ) X.insert(X.end(), inverse[a*K+k].begin(), inverse[a*K+k].end());
+      if ( X.empty() ) continue;
+      touched_count.assign(blocks.size(), 0);
+      std::vector<uint64_t> touched;
+      for ( auto q : X ) {
+        marked[q] = true;
+        if ( touched_count[block_of[q]] ++ == 0 ) touched.push_back(block_of[q]);
+      }
+      for ( auto Y : touched ) {
+        if ( touched_count[Y] == blocks[Y].size() ) continue;
+        std::vector<uint64_t> inside, outside;
+        for ( auto q : blocks[Y] ) ( marked[q] ? inside : outside ).push_back(q);
+        uint64_t Z = blocks.size();
+        for ( auto q : inside ) block_of[q] = Z;
+        blocks[Y] = outside;
+        blocks.push_back(inside);
+        in_worklist.push_back(false);
+        if ( in_worklist[Y] ) {
+          worklist.push_back(Z);
+          in_worklist[Z] = true;
+        } else {
+          uint64_t smaller = ( blocks[Y].size() <= blocks[Z].size() ) ? Y : Z;
+          worklist.push_back(smaller);
+          in_worklist[smaller] = true;
+        }
+      }
+      for ( auto q : X ) marked[q] = false;
+    }
+  }
+
+  // Build the minimal automaton, numbering states in breadth-first order
+  // from the initial state. The block of the dead state contains exactly
+  // the states which cannot reach an accepting state; it is dropped.
+  uint64_t const dead_block = block_of[dead];
+  uint64_t const start_block = ( Q > 1 ) ? block_of[0] : dead_block;
+  std::vector<int64_t> state_of_block ( blocks.size(), -1 );
+  std::vector<uint64_t> block_of_state;
+  num_states_ = 0;
+  transitions_ . clear ();
+  accepting_ . clear ();
+  if ( start_block == dead_block ) {
+    num_states_ = 1;
+    initial_ = 0;
+    accepting_ . assign ( 1, false );
+    transitions_ . assign ( K, -1 );
+    return;
+  }
+  state_of_block[start_block] = num_states_ ++;
+  block_of_state . push_back ( start_block );
+  for ( uint64_t s = 0; s < block_of_state.size(); ++ s ) {
+    uint64_t representative = blocks[block_of_state[s]][0];
+    accepting_ . push_back ( is_final[representative] );
+    for ( uint64_t k = 0; k < K; ++ k ) {
+      uint64_t target_block = block_of[complete[representative*K+k]];
+      if ( target_block == dead_block ) {
+        transitions_ . push_back ( -1 );
+        continue;
+      }
+      if ( state_of_block[target_block] == -1 ) {
+        state_of_block[target_block] = num_states_ ++;
+        block_of_state . push_back ( target_block );
+      }
+      transitions_ . push_back ( state_of_block[target_block] );
+    }
+  }
+  initial_ = 0;
+}
+
+inline uint64_t DFA::
+num_states ( void ) const {
+  return num_states_;
+}
+
+inline std::string DFA::
+alphabet ( void ) const {
+  return alphabet_;
+}
+
+inline uint64_t DFA::
+initial ( void ) const {
+  return initial_;
+}
+
+inline bool DFA::
+accepting ( uint64_t state ) const {
+  if ( state >= num_states_ ) throw std::invalid_argument("DFA::accepting: state out of range");
+  return accepting_[state];
+}
+
+inline int64_t DFA::
+transition ( uint64_t state, LabelType label ) const {
+  if ( state >= num_states_ ) throw std::invalid_argument("DFA::transition: state out of range");
+  int64_t k = symbol_[(unsigned char)label];
+  if ( k == -1 ) return -1;
+  return transitions_[state*alphabet_.size()+k];
+}
+
+inline bool DFA::
+accepts ( std::string const& word ) const {
+  int64_t state = initial_;
+  for ( auto label : word ) {
+    state = transition(state, label);
+    if ( state == -1 ) return false;
+  }
+  return accepting_[state];
+}
+
+inline bool DFA::
+accepts ( LabelledMultidigraph const& graph, uint64_t initial, uint64_t final ) const {
+  uint64_t const N = graph.num_vertices();
+  if ( initial >= N || final >= N ) return false;
+  uint64_t const K = alphabet_.size();
+  uint64_t const W = (num_states_ + 63) / 64;
+  // states[v*W .. v*W+W) is the bitset of DFA states reachable at vertex v
+  std::vector<uint64_t> states ( N * W, 0 );
+  states[initial*W + (initial_ >> 6)] |= (1ULL << (initial_ & 63));
+  auto is_self_epsilon = [](uint64_t u, LabelType label, uint64_t v) {
+    return label == ' ' && u == v;
+  };
+  // Propagate the states of u along its out-edges. Calls
+  // on_change(v) for each vertex v whose state set grew.
+  auto propagate = [&](uint64_t u, std::function<void(uint64_t)> const& on_change) {
+    uint64_t const* source = &states[u*W];
+    for ( auto const& e : graph.edges(u) ) {
+      uint64_t v = e.second;
+      if ( is_self_epsilon(u, e.first, v) ) continue;
+      uint64_t * target = &states[v*W];
+      bool changed = false;
+      if ( e.first == ' ' ) {
+        for ( uint64_t w = 0; w < W; ++ w ) {
+          uint64_t bits = source[w] & ~target[w];
+          if ( bits ) { target[w] |= bits; changed = true; }
+        }
+      } else {
+        int64_t k = symbol_[(unsigned char)e.first];
+        if ( k == -1 ) continue;
+        for ( uint64_t w = 0; w < W; ++ w ) {
+          uint64_t bits = source[w];
+          while ( bits ) {
+            uint64_t s = (w << 6) + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            int64_t t = transitions_[s*K+k];
+            if ( t == -1 ) continue;
+            uint64_t bit = 1ULL << (t & 63);
+            if ( target[t >> 6] & bit ) continue;
+            target[t >> 6] |= bit;
+            changed = true;
+          }
+        }
+      }
+      if ( changed ) on_change(v);
+    }
+  };
+  auto accepted = [&]() {
+    for ( uint64_t s = 0; s < num_states_; ++ s ) {
+      if ( accepting_[s] && ( states[final*W + (s >> 6)] & (1ULL << (s & 63)) ) ) return true;
+    }
+    return false;
+  };
+  // Topologically sort, ignoring epsilon self-loops
+  std::vector<uint64_t> indegree ( N, 0 );
+  for ( uint64_t u = 0; u < N; ++ u ) {
+    for ( auto const& e : graph.edges(u) ) if ( not is_self_epsilon(u, e.first, e.second) ) ++ indegree[e.second];
+  }
+  std::vector<uint64_t> order;
+  order.reserve(N);
+  for ( uint64_t v = 0; v < N; ++ v ) if ( indegree[v] == 0 ) order.push_back(v);
+  for ( uint64_t i = 0; i < order.size(); ++ i ) {
+    uint64_t u = order[i];
+    for ( auto const& e : graph.edges(u) ) {
+      if ( is_self_epsilon(u, e.first, e.second) ) continue;
+      if ( -- indegree[e.second] == 0 ) order.push_back(e.second);
+    }
+  }
+  auto no_op = [](uint64_t) {};
+  if ( order.size() == N ) {
+    // Acyclic: a single pass in topological order suffices
+    for ( auto u : order ) {
+      if ( u == final ) return accepted();
+      propagate(u, no_op);
+    }
+    return accepted();
+  }
+  // Cyclic: iterate to a fixed point with a worklist
+  std::vector<bool> queued ( N, false );
+  std::vector<uint64_t> worklist;
+  worklist.push_back(initial);
+  queued[initial] = true;
+  while ( not worklist.empty() ) {
+    uint64_t u = worklist.back();
+    worklist.pop_back();
+    queued[u] = false;
+    propagate(u, [&](uint64_t v) {
+      if ( not queued[v] ) { queued[v] = true; worklist.push_back(v); }
+    });
+  }
+  return accepted();
+}
+
+inline bool DFA::
+accepts ( NFA const& graph ) const {
+  return accepts ( graph, graph.initial(), graph.final() );
+}
+
+inline std::string DFA::
+graphviz ( void ) const {
+  std::stringstream ss;
+  ss << "digraph G {\n";
+  for ( uint64_t s = 0; s < num_states_; ++ s ) {
+    ss << s << " [label=\"" << s << ((s == initial_) ? "(initial)" : "")
+       << "\"" << (accepting_[s] ? " shape=doublecircle" : "") << "];\n";
+  }
+  for ( uint64_t s = 0; s < num_states_; ++ s ) {
+    for ( uint64_t k = 0; k < alphabet_.size(); ++ k ) {
+      int64_t t = transitions_[s*alphabet_.size()+k];
+      if ( t != -1 ) ss << s << " -> " << t << "[label=\"" << alphabet_[k] << "\"]\n";
+    }
+  }
+  ss << "}\n";
+  return ss.str();
+}
+
+inline
+DFA
+CompileRegexToDFA (std::string const& regex) {
+  return DFA ( CompileRegexToNFA ( regex ) );
+}
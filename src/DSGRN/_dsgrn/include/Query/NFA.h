@@ -6,6 +6,8 @@
 #pragma once
 
 #include "common.h"
+#include <limits>
+
 #include "Graph/LabelledMultidigraph.h"
 
 namespace NFA_detail {
@@ -16,6 +18,10 @@ namespace NFA_detail {
 /// NFA
 ///   nondeterministic finite automata with epsilon transitions
 ///   note: epsilon transitions have ' ' character
+///   note: intersect, intersects, witness and count_paths read the
+///         compact edge array, which the first read after an edit
+///         builds. They only read, and release the GIL in Python; an
+///         automaton must not be edited while another thread reads it.
 class NFA : public LabelledMultidigraph {
 public:
   typedef NFA_detail::LabelType LabelType;
@@ -42,16 +48,42 @@ public:
   final ( void ) const;
   
   /// intersect
-  ///   Return {nfa, \pi }, where pi[v] is the pair of vertices used in the product construction
+  ///   Return {nfa, \pi }, where pi[v] is the pair of vertices used in the product construction.
+  ///   Epsilon edges are paired like edges with any other label.
   static std::pair<NFA, std::vector<std::pair<uint64_t,uint64_t>>>
   intersect ( NFA const& lhs, NFA const& rhs );
 
+  /// intersects
+  ///   Return true if lhs and rhs accept a common word, where an epsilon
+  ///   edge moves one automaton alone (as in DFA) and an edge with any
+  ///   other label moves both together. This is reachability of the
+  ///   final pair in the product built by "intersect" once an epsilon
+  ///   self-loop is added at every vertex of both automata, as the
+  ///   automata built by CompileRegexToNFA and ComputeSingleGeneQuery
+  ///   have. The product is explored lazily and the search stops as soon
+  ///   as the final pair is discovered; it is never materialized.
+  static bool
+  intersects ( NFA const& lhs, NFA const& rhs );
+
+  /// witness
+  ///   Return a path of vertex pairs (a,b), a in lhs and b in rhs, from the
+  ///   initial pair to the final pair of the product automaton, explored as
+  ///   in "intersects". Returns an empty vector if no such path exists.
+  static std::vector<std::pair<uint64_t,uint64_t>>
+  witness ( NFA const& lhs, NFA const& rhs );
+
   /// graphviz (override)
   std::string 
   graphviz ( void ) const;
 
   /// count_paths
-  ///    Return number of accepting paths (if finite)
+  ///    Return number of accepting paths, i.e. sequences of labelled
+  ///    edges from initial to final in which each edge starts in the
+  ///    epsilon closure of the target of the previous one. Epsilon edges
+  ///    are free moves and are not counted: paths which differ only in
+  ///    their epsilon edges are the same path. If the count is infinite
+  ///    (a cycle with a labelled edge lies on an accepting path) or does
+  ///    not fit in 64 bits, the result saturates at 2^64-1.
   uint64_t
   count_paths ( void ) const;
 
@@ -73,13 +105,21 @@ NFABinding (py::module &m) {
     .def(py::init<>())
     .def("add_vertex", &NFA::add_vertex)
     .def("add_edge", &NFA::add_edge)
+    .def("finalize", &NFA::finalize)
+    .def("finalized", &NFA::finalized)
     .def("num_vertices", &NFA::num_vertices)
+    .def("num_edges", &NFA::num_edges)
+    .def("edges", (LabelledMultidigraph::EdgeRange (LabelledMultidigraph::*)(uint64_t) const) &NFA::edges, py::keep_alive<0,1>())
+    .def("edges", (LabelledMultidigraph::EdgeRange (LabelledMultidigraph::*)(uint64_t, NFA::LabelType) const) &NFA::edges, py::keep_alive<0,1>())
     .def("adjacencies", &NFA::adjacencies)
     .def("unlabelled_adjacencies", &NFA::unlabelled_adjacencies)
     .def("set_initial", &NFA::set_initial)
     .def("set_final", &NFA::set_final)
     .def("initial", &NFA::initial)
     .def("final", &NFA::final)
-    .def_static("intersect", &NFA::intersect)
+    .def_static("intersect", &NFA::intersect, py::call_guard<py::gil_scoped_release>())
+    .def_static("intersects", &NFA::intersects, py::call_guard<py::gil_scoped_release>())
+    .def_static("witness", &NFA::witness, py::call_guard<py::gil_scoped_release>())
+    .def("count_paths", &NFA::count_paths, py::call_guard<py::gil_scoped_release>())
     .def("graphviz", &NFA::graphviz);
 }
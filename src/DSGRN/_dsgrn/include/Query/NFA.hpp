@@ -19,6 +19,36 @@ initial ( void ) const { return initial_idx_; }
 inline uint64_t NFA::
 final ( void ) const { return final_idx_; }
 
+namespace NFA_detail {
+  /// for_each_common_label
+  ///   Call f(label, a, b) for each pair of edges (label, a) in lhs and
+  ///   (label, b) in rhs. Both ranges are sorted by label, so matching
+  ///   labels are found by a merge.
+  template < class F > inline void
+  for_each_common_label ( LabelledMultidigraph::EdgeRange const& lhs,
+                          LabelledMultidigraph::EdgeRange const& rhs,
+                          F const& f ) {
+    auto l = lhs.begin();
+    auto r = rhs.begin();
+    while ( l != lhs.end() && r != rhs.end() ) {
+      if ( l -> first < r -> first ) { ++ l; continue; }
+      if ( r -> first < l -> first ) { ++ r; continue; }
+      auto label = l -> first;
+      auto l_end = l;
+      auto r_end = r;
+      while ( l_end != lhs.end() && l_end -> first == label ) ++ l_end;
+      while ( r_end != rhs.end() && r_end -> first == label ) ++ r_end;
+      for ( auto a = l; a != l_end; ++ a ) {
+        for ( auto b = r; b != r_end; ++ b ) {
+          f(label, a -> second, b -> second);
+        }
+      }
+      l = l_end;
+      r = r_end;
+    }
+  }
+}
+
 inline std::pair<NFA, std::vector<std::pair<uint64_t,uint64_t>>> NFA::
 intersect ( NFA const& lhs, NFA const& rhs ) {
   NFA nfa;
@@ -46,28 +76,190 @@ intersect ( NFA const& lhs, NFA const& rhs ) {
     auto node = work_stack.top();
     work_stack.pop();
     auto i = nodes[node];
-    auto L_adj = lhs.adjacencies(node.first); // type std::map<LabelledMultidigraph::LabelType, std::unordered_set<uint64_t>>
-    auto R_adj = rhs.adjacencies(node.second);
+    NFA_detail::for_each_common_label(lhs.edges(node.first), rhs.edges(node.second),
+      [&](LabelType label, uint64_t lchild, uint64_t rchild) {
+        auto j = vertex_index({lchild, rchild});
+        nfa.add_edge(i,j,label);
+      });
+  }
+  nfa.finalize();
+  return {nfa,node_by_index};
+}
 
-    for ( auto const& label_children : L_adj) {
-      auto label = label_children.first;
-      if ( not R_adj.count(label) ) continue;
-      auto const& Lchildren = label_children.second;
-      auto const& Rchildren = R_adj.find(label) -> second;
-      for ( auto const& lchild : Lchildren ) {
-        for ( auto const& rchild : Rchildren ) {
-          auto j = vertex_index({lchild, rchild});
-          nfa.add_edge(i,j,label);
-        }
-      }
+namespace NFA_detail {
+  /// product_search
+  ///   Depth-first search of the product of lhs and rhs from the initial
+  ///   pair, stopping when the final pair is discovered. An epsilon edge
+  ///   of either automaton moves that automaton alone; edges with any
+  ///   other label move both automata together. Pair (a,b) is
+  ///   numbered a*|rhs|+b and marked in a dense visited bitmap. If "parent"
+  ///   is non-null it records the discovering pair of each visited pair.
+  ///   Returns true if the final pair is reachable.
+  inline bool
+  product_search ( NFA const& lhs, NFA const& rhs,
+                   std::unordered_map<uint64_t,uint64_t> * parent ) {
+    uint64_t const L = lhs.num_vertices();
+    uint64_t const R = rhs.num_vertices();
+    if ( lhs.initial() >= L || rhs.initial() >= R ) return false;
+    if ( lhs.final() >= L || rhs.final() >= R ) return false;
+    uint64_t const start = lhs.initial() * R + rhs.initial();
+    uint64_t const stop = lhs.final() * R + rhs.final();
+    if ( start == stop ) return true;
+    std::vector<uint64_t> visited ( (L*R + 63) / 64, 0 );
+    visited[start >> 6] |= (1ULL << (start & 63));
+    std::vector<uint64_t> work_stack;
+    work_stack.push_back(start);
+    while ( not work_stack.empty() ) {
+      uint64_t node = work_stack.back();
+      work_stack.pop_back();
+      uint64_t const a = node / R;
+      uint64_t const b = node % R;
+      bool found = false;
+      auto visit = [&](uint64_t lchild, uint64_t rchild) {
+        uint64_t child = lchild * R + rchild;
+        uint64_t & word = visited[child >> 6];
+        uint64_t bit = 1ULL << (child & 63);
+        if ( word & bit ) return;
+        word |= bit;
+        if ( parent ) (*parent)[child] = node;
+        if ( child == stop ) found = true;
+        work_stack.push_back(child);
+      };
+      // Epsilon edges move one side alone, other labels move both
+      for ( auto const& e : lhs.edges(a, ' ') ) visit(e.second, b);
+      for ( auto const& e : rhs.edges(b, ' ') ) visit(a, e.second);
+      for_each_common_label(lhs.edges(a), rhs.edges(b),
+        [&](LabelType label, uint64_t lchild, uint64_t rchild) {
+          if ( label != ' ' ) visit(lchild, rchild);
+        });
+      if ( found ) return true;
     }
+    return false;
   }
-  return {nfa,node_by_index};
+}
+
+inline bool NFA::
+intersects ( NFA const& lhs, NFA const& rhs ) {
+  return NFA_detail::product_search(lhs, rhs, nullptr);
+}
+
+inline std::vector<std::pair<uint64_t,uint64_t>> NFA::
+witness ( NFA const& lhs, NFA const& rhs ) {
+  std::vector<std::pair<uint64_t,uint64_t>> result;
+  std::unordered_map<uint64_t,uint64_t> parent;
+  if ( not NFA_detail::product_search(lhs, rhs, &parent) ) return result;
+  uint64_t const R = rhs.num_vertices();
+  uint64_t node = lhs.final() * R + rhs.final();
+  uint64_t const start = lhs.initial() * R + rhs.initial();
+  while ( true ) {
+    result.push_back({node / R, node % R});
+    if ( node == start ) break;
+    node = parent[node];
+  }
+  std::reverse(result.begin(), result.end());
+  return result;
 }
 
 inline uint64_t NFA::
 count_paths ( void ) const {
-  return -1;
+  uint64_t const saturated = std::numeric_limits<uint64_t>::max ();
+  uint64_t N = num_vertices ();
+  if ( initial() >= N || final() >= N ) return 0;
+  // An accepting path is a sequence of labelled edges e1 ... ek where e1
+  // starts in the epsilon closure of the initial vertex, each e(i+1) in
+  // the closure of the target of e(i), and the final vertex lies in the
+  // closure of the target of ek. So the paths are those of the graph
+  // "step" with an edge v -> x for each labelled edge w -> x with w in
+  // the closure of v; "accepting[v]" holds if the final vertex is in the
+  // closure of v.
+  std::vector<std::vector<uint64_t>> step ( N );
+  std::vector<bool> accepting ( N, false );
+  std::vector<uint64_t> mark ( N, N );
+  std::stack<uint64_t> work_stack;
+  for ( uint64_t v = 0; v < N; ++ v ) {
+    mark[v] = v;
+    work_stack.push(v);
+    while ( not work_stack.empty() ) {
+      uint64_t w = work_stack.top();
+      work_stack.pop();
+      if ( w == final() ) accepting[v] = true;
+      for ( auto const& e : edges(w) ) {
+        if ( e.first != ' ' ) {
+          step[v].push_back(e.second);
+        } else if ( mark[e.second] != v ) {
+          mark[e.second] = v;
+          work_stack.push(e.second);
+        }
+      }
+    }
+  }
+  // Restrict to vertices which are both reachable from the initial vertex
+  // and coreachable to an accepting vertex; only these lie on accepting paths.
+  std::vector<std::vector<uint64_t>> transpose ( N );
+  for ( uint64_t u = 0; u < N; ++ u ) {
+    for ( auto v : step[u] ) transpose[v].push_back(u);
+  }
+  std::vector<bool> reachable ( N, false );
+  std::vector<bool> coreachable ( N, false );
+  reachable[initial()] = true;
+  work_stack.push(initial());
+  while ( not work_stack.empty() ) {
+    uint64_t u = work_stack.top();
+    work_stack.pop();
+    for ( auto v : step[u] ) {
+      if ( reachable[v] ) continue;
+      reachable[v] = true;
+      work_stack.push(v);
+    }
+  }
+  for ( uint64_t v = 0; v < N; ++ v ) {
+    if ( reachable[v] && accepting[v] ) {
+      coreachable[v] = true;
+      work_stack.push(v);
+    }
+  }
+  if ( work_stack.empty() ) return 0;
+  while ( not work_stack.empty() ) {
+    uint64_t v = work_stack.top();
+    work_stack.pop();
+    for ( auto u : transpose[v] ) {
+      if ( coreachable[u] || not reachable[u] ) continue;
+      coreachable[u] = true;
+      work_stack.push(u);
+    }
+  }
+  // Topologically sort the relevant subgraph (Kahn's algorithm) while
+  // accumulating path counts. Edges are counted with multiplicity, so
+  // parallel edges with distinct labels give distinct paths, while
+  // epsilon edges only move within a closure and are never counted.
+  std::vector<uint64_t> indegree ( N, 0 );
+  for ( uint64_t v = 0; v < N; ++ v ) {
+    if ( not coreachable[v] ) continue;
+    for ( auto u : transpose[v] ) if ( coreachable[u] ) ++ indegree[v];
+  }
+  std::vector<uint64_t> count ( N, 0 );
+  count[initial()] = 1;
+  uint64_t num_relevant = 0;
+  uint64_t num_sorted = 0;
+  uint64_t total = 0;
+  for ( uint64_t v = 0; v < N; ++ v ) if ( coreachable[v] ) ++ num_relevant;
+  if ( indegree[initial()] != 0 ) return saturated;
+  work_stack.push(initial());
+  while ( not work_stack.empty() ) {
+    uint64_t u = work_stack.top();
+    work_stack.pop();
+    ++ num_sorted;
+    if ( accepting[u] ) total = ( total > saturated - count[u] ) ? saturated : total + count[u];
+    for ( auto v : step[u] ) {
+      if ( not coreachable[v] ) continue;
+      count[v] = ( count[v] > saturated - count[u] ) ? saturated : count[v] + count[u];
+      if ( -- indegree[v] == 0 ) work_stack.push(v);
+    }
+  }
+  // Leftover vertices lie on a cycle with a labelled edge, so there are
+  // infinitely many paths
+  if ( num_sorted != num_relevant ) return saturated;
+  return total;
 }
 
 inline std::string 
@@ -80,17 +272,10 @@ NFA::graphviz ( void ) const {
        << ((i == initial()) ? "(initial)" : "") << ((i == final()) ? "(final)" : "") << "\"];\n";
   }
 
-  // Queue the remaining children.
-  for ( uint64_t i = 0; i < num_vertices(); ++ i ) {
-    for ( auto label_set : adjacencies(i) ) {
-      auto label = label_set.first;
-      auto set = label_set.second;
-      for ( auto j : set ) { 
-        if ( label == ' ' && i == j) continue;
-        ss << i << " -> " << j << "[label=\"" << label << "\"]\n";
-      }
-    }
-  }
+  for_each_edge([&](uint64_t i, Edge const& e) {
+    if ( e.first == ' ' && i == e.second ) return;
+    ss << i << " -> " << e.second << "[label=\"" << e.first << "\"]\n";
+  });
   ss << "}\n";
   return ss.str();
 }
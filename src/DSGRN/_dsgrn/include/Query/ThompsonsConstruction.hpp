@@ -681,5 +681,6 @@ CompileRegexToNFA (std::string const& regex) {
   nfa.set_initial(node_index[result.initial()]);
   nfa.set_final(node_index[result.final()]);
   for ( auto n : result.nodes () ) delete n;
+  nfa.finalize();
   return nfa;
 }
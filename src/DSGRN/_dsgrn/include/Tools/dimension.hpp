@@ -0,0 +1,110 @@
+/// dimension.hpp
+/// Shaun Harker
+/// 2018-11-20
+/// MIT LICENSE
+
+/// Dispatch of kernels specialized on the dimension of phase space
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace dsgrn {
+
+  /// max_dimension
+  ///   Labels hold two bits per dimension in 64 bits
+  static const uint64_t max_dimension = 32;
+
+  /// max_specialized_dimension
+  ///   Kernels are instantiated for each dimension 1, ..., 16, which
+  ///   covers the networks used in practice. Other dimensions use the
+  ///   instantiation for 0, which reads the dimension at run time.
+  static const uint64_t max_specialized_dimension = 16;
+
+  /// DimensionArray
+  ///   Fixed-size array for per-dimension data of a kernel instantiated
+  ///   for dimension S (or for any dimension, if S is 0)
+  template < uint64_t S >
+  using DimensionArray = std::array<uint64_t, S ? S : max_dimension>;
+
+  /// DimensionKernel
+  ///   Type of a pointer to Kernel<S>::run, which must be the same for
+  ///   every S
+  template < template < uint64_t > class Kernel >
+  using DimensionKernel = decltype ( &Kernel<0>::run );
+
+  template < template < uint64_t > class Kernel, uint64_t S >
+  struct DimensionTable_ {
+    static void
+    fill ( std::array<DimensionKernel<Kernel>, max_dimension + 1> & table ) {
+      table [ S ] = &Kernel<S>::run;
+      DimensionTable_<Kernel, S - 1>::fill ( table );
+    }
+  };
+
+  template < template < uint64_t > class Kernel >
+  struct DimensionTable_<Kernel, 0> {
+    static void
+    fill ( std::array<DimensionKernel<Kernel>, max_dimension + 1> & ) {}
+  };
+
+  template < template < uint64_t > class Kernel >
+  struct DimensionKernels_ {
+    std::array<DimensionKernel<Kernel>, max_dimension + 1> table;
+    DimensionKernels_ ( void ) {
+      table . fill ( &Kernel<0>::run );
+      DimensionTable_<Kernel, max_specialized_dimension>::fill ( table );
+    }
+  };
+
+  /// check_dimension
+  ///   Throw std::invalid_argument, naming "caller", if D exceeds
+  ///   max_dimension
+  inline void
+  check_dimension ( uint64_t D, std::string const& caller ) {
+    if ( D > max_dimension ) {
+      throw std::invalid_argument ( caller + ": dimension " + std::to_string ( D ) +
+                                    " exceeds " + std::to_string ( max_dimension ) );
+    }
+  }
+
+  /// select_dimension
+  ///   Return Kernel<D>::run when 1 <= D <= 16, and Kernel<0>::run
+  ///   otherwise, to be called as kernel(D, args...). A kernel reads its
+  ///   dimension as "S ? S : D", which is a compile-time constant in
+  ///   the specialized instantiations, so loops over dimensions unroll.
+  ///   The instantiations are tabulated on first use, so selecting is
+  ///   one lookup; callers running a kernel many times select it once
+  ///   and pass it down.
+  template < template < uint64_t > class Kernel > DimensionKernel<Kernel>
+  select_dimension ( uint64_t D ) {
+    check_dimension ( D, "select_dimension" );
+    static DimensionKernels_<Kernel> const kernels;
+    return kernels . table [ D ];
+  }
+
+  template < class Signature >
+  struct UnsupportedDimension_;
+
+  template < class Result, class... Args >
+  struct UnsupportedDimension_<Result(*)(uint64_t, Args...)> {
+    static Result
+    run ( uint64_t D, Args... ) {
+      check_dimension ( D, "select_dimension" );
+      throw std::logic_error ( "select_dimension: unsupported kernel called" );
+    }
+  };
+
+  /// select_dimension_deferred
+  ///   As select_dimension, but when D exceeds max_dimension return a
+  ///   kernel which throws when called. Objects storing a kernel (such
+  ///   as ParameterGraph) can then be built for networks of any size.
+  template < template < uint64_t > class Kernel > DimensionKernel<Kernel>
+  select_dimension_deferred ( uint64_t D ) {
+    if ( D > max_dimension ) return &UnsupportedDimension_<DimensionKernel<Kernel>>::run;
+    return select_dimension<Kernel> ( D );
+  }
+}
@@ -0,0 +1,48 @@
+/// numpy.hpp
+/// Shaun Harker
+/// 2018-11-17
+/// MIT LICENSE
+
+/// Expose C++ arrays to Python as numpy arrays without converting
+/// them element by element
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cstdint>
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+
+namespace dsgrn {
+
+  /// numpy_view
+  ///   Return a read-only numpy array viewing the "size" elements at
+  ///   "data". The array holds a copy of "owner" (typically a class
+  ///   sharing the data through a shared_ptr), which keeps the data
+  ///   alive for as long as the array exists. The view is invalidated
+  ///   if the owner's data is modified. The copy is held through a
+  ///   shared_ptr, which deletes it as an Owner even if Owner has
+  ///   virtual methods but no virtual destructor.
+  template < class T, class Owner > pybind11::array_t<T>
+  numpy_view ( T const* data, uint64_t size, Owner const& owner ) {
+    typedef std::shared_ptr<Owner const> Holder;
+    pybind11::capsule base ( new Holder ( std::make_shared<Owner> ( owner ) ),
+                             [] ( void * p ) { delete (Holder *) p; } );
+    pybind11::array_t<T> result ( { (ssize_t) size }, { (ssize_t) sizeof(T) }, data, base );
+    result . attr ( "setflags" ) ( pybind11::arg("write") = false );
+    return result;
+  }
+
+  /// numpy_array
+  ///   Return a numpy array which takes ownership of the contents of
+  ///   "vector" (moved, not copied)
+  template < class T > pybind11::array_t<T>
+  numpy_array ( std::vector<T> && vector ) {
+    std::vector<T> * owner = new std::vector<T> ( std::move ( vector ) );
+    pybind11::capsule base ( owner, [] ( void * p ) { delete (std::vector<T> *) p; } );
+    return pybind11::array_t<T> ( { (ssize_t) owner -> size () }, { (ssize_t) sizeof(T) }, owner -> data (), base );
+  }
+}
@@ -0,0 +1,64 @@
+/// parallel.hpp
+/// Shaun Harker
+/// 2018-11-08
+/// MIT LICENSE
+
+/// Simple thread-parallel loop
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <exception>
+#include <algorithm>
+
+namespace dsgrn {
+
+  /// hardware_threads
+  ///   Return the number of threads to use when the caller asks for 0
+  inline uint64_t
+  hardware_threads ( void ) {
+    uint64_t n = std::thread::hardware_concurrency ();
+    return n ? n : 1;
+  }
+
+  /// parallel_for
+  ///   Call f(thread, i) for each i in [begin, end) using "num_threads"
+  ///   threads (0 means one per hardware thread). Indices are handed out
+  ///   in chunks of "grain" from a shared counter, so the assignment of
+  ///   indices to threads is not deterministic; "thread" lies in
+  ///   [0, num_threads) and may be used to index per-thread scratch space.
+  ///   The first exception thrown by f is rethrown after all threads join.
+  template < class F > void
+  parallel_for ( uint64_t begin, uint64_t end, uint64_t num_threads, uint64_t grain, F const& f ) {
+    if ( num_threads == 0 ) num_threads = hardware_threads ();
+    if ( grain == 0 ) grain = 1;
+    if ( end <= begin ) return;
+    num_threads = std::min<uint64_t> ( num_threads, (end - begin + grain - 1) / grain );
+    if ( num_threads <= 1 ) {
+      for ( uint64_t i = begin; i < end; ++ i ) f ( 0, i );
+      return;
+    }
+    std::atomic<uint64_t> next ( begin );
+    std::atomic<bool> failed ( false );
+    std::exception_ptr error;
+    auto work = [&] ( uint64_t thread ) {
+      try {
+        while ( not failed ) {
+          uint64_t chunk = next.fetch_add ( grain );
+          if ( chunk >= end ) break;
+          uint64_t chunk_end = std::min ( end, chunk + grain );
+          for ( uint64_t i = chunk; i < chunk_end; ++ i ) f ( thread, i );
+        }
+      } catch ( ... ) {
+        if ( not failed.exchange ( true ) ) error = std::current_exception ();
+      }
+    };
+    std::vector<std::thread> threads;
+    for ( uint64_t t = 1; t < num_threads; ++ t ) threads . emplace_back ( work, t );
+    work ( 0 );
+    for ( auto & thread : threads ) thread . join ();
+    if ( error ) std::rethrow_exception ( error );
+  }
+}
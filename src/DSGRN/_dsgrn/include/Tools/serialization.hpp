@@ -0,0 +1,132 @@
+/// serialization.hpp
+/// Shaun Harker
+/// 2018-11-18
+/// MIT LICENSE
+
+/// Compact binary encoding used by the "serialize" and "deserialize"
+/// methods (and hence by pickling) of the core classes
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+
+namespace dsgrn {
+
+  /// serialization_version
+  ///   Version of the encoding. Bump it whenever any class changes the
+  ///   layout of its encoding; readers reject other versions.
+  static const uint64_t serialization_version = 1;
+
+  /// BinaryWriter
+  ///   Append unsigned integers (as little-endian base-128 varints, so
+  ///   small values take one byte), strings and integer lists to a byte
+  ///   string. Each encoding starts with "DSGRN", a one-character tag
+  ///   naming the class, and the version.
+  class BinaryWriter {
+  public:
+    BinaryWriter ( char tag ) {
+      bytes_ = "DSGRN";
+      bytes_ . push_back ( tag );
+      integer ( serialization_version );
+    }
+
+    void
+    integer ( uint64_t value ) {
+      while ( value >= 0x80 ) {
+        bytes_ . push_back ( (char) ( ( value & 0x7F ) | 0x80 ) );
+        value >>= 7;
+      }
+      bytes_ . push_back ( (char) value );
+    }
+
+    void
+    string ( std::string const& value ) {
+      integer ( value . size () );
+      bytes_ . append ( value );
+    }
+
+    void
+    integers ( std::vector<uint64_t> const& values ) {
+      integer ( values . size () );
+      for ( uint64_t value : values ) integer ( value );
+    }
+
+    std::string const&
+    bytes ( void ) const {
+      return bytes_;
+    }
+
+  private:
+    std::string bytes_;
+  };
+
+  /// BinaryReader
+  ///   Read back what a BinaryWriter wrote. The constructor checks the
+  ///   header; every read checks for truncation. Errors throw
+  ///   std::runtime_error prefixed by "where".
+  class BinaryReader {
+  public:
+    BinaryReader ( std::string const& bytes, char tag, std::string const& where )
+      : bytes_ ( bytes ), position_ ( 0 ), where_ ( where ) {
+      if ( bytes . size () < 6 || bytes . compare ( 0, 5, "DSGRN" ) != 0 || bytes[5] != tag ) {
+        throw std::runtime_error ( where_ + ": not a serialized object of this type" );
+      }
+      position_ = 6;
+      if ( integer () != serialization_version ) {
+        throw std::runtime_error ( where_ + ": unsupported serialization version" );
+      }
+    }
+
+    uint64_t
+    integer ( void ) {
+      uint64_t value = 0;
+      for ( uint64_t shift = 0; shift < 64; shift += 7 ) {
+        if ( position_ >= bytes_ . size () ) _truncated ();
+        uint8_t byte = (uint8_t) bytes_ [ position_ ++ ];
+        value |= (uint64_t) ( byte & 0x7F ) << shift;
+        if ( not ( byte & 0x80 ) ) return value;
+      }
+      throw std::runtime_error ( where_ + ": malformed integer" );
+    }
+
+    std::string
+    string ( void ) {
+      uint64_t size = integer ();
+      if ( size > bytes_ . size () - position_ ) _truncated ();
+      position_ += size;
+      return bytes_ . substr ( position_ - size, size );
+    }
+
+    std::vector<uint64_t>
+    integers ( void ) {
+      uint64_t size = integer ();
+      // Each integer takes at least one byte
+      if ( size > bytes_ . size () - position_ ) _truncated ();
+      std::vector<uint64_t> values ( size );
+      for ( uint64_t & value : values ) value = integer ();
+      return values;
+    }
+
+    /// finish
+    ///   Check that every byte was read
+    void
+    finish ( void ) const {
+      if ( position_ != bytes_ . size () ) {
+        throw std::runtime_error ( where_ + ": trailing bytes" );
+      }
+    }
+
+  private:
+    std::string const& bytes_;
+    uint64_t position_;
+    std::string where_;
+
+    void
+    _truncated ( void ) const {
+      throw std::runtime_error ( where_ + ": truncated data" );
+    }
+  };
+}
@@ -0,0 +1,57 @@
+/// TestAttractors.cpp
+/// Shaun Harker
+/// 2018-11-20
+/// MIT LICENSE
+
+#include "common.h"
+#include "DSGRN.h"
+
+int main ( int argc, char * argv [] ) {
+  try {
+    auto fail = [] ( std::string const& message ) {
+      throw std::runtime_error ( "Attractors: " + message );
+    };
+    // Compare against the minimal vertices of the full Morse graph
+    for ( std::string filename : { "networks/network2.txt", "networks/network3.txt", "networks/network9.txt" } ) {
+      Network network ( filename );
+      ParameterGraph pg ( network );
+      uint64_t step = std::max<uint64_t> ( 1, pg . size () / 500 );
+      uint64_t num_monostable = 0;
+      for ( uint64_t pi = 0; pi < pg . size (); pi += step ) {
+        DomainGraph dg ( pg . parameter ( pi ) );
+        Components components = StrongComponents ( dg . digraph () );
+        MorseDecomposition md ( dg . digraph (), components );
+        MorseGraph mg ( dg, md );
+        Attractors attractors ( dg, components );
+        std::multiset<std::string> A, B;
+        std::set<std::vector<uint64_t>> X, Y;
+        for ( uint64_t v = 0; v < mg . poset () . size (); ++ v ) {
+          if ( not mg . poset () . children ( v ) . empty () ) continue;
+          A . insert ( mg . annotation ( v ) . stringify () );
+        }
+        for ( uint64_t v = 0; v < md . poset () . size (); ++ v ) {
+          if ( not md . poset () . children ( v ) . empty () ) continue;
+          std::vector<uint64_t> domains = md . morseset ( v );
+          std::sort ( domains . begin (), domains . end () );
+          X . insert ( domains );
+        }
+        for ( uint64_t i = 0; i < attractors . size (); ++ i ) {
+          B . insert ( attractors . annotation ( i ) . stringify () );
+          Y . insert ( attractors . morseset ( i ) );
+          if ( i > 0 && attractors . annotation ( i - 1 ) . stringify () > attractors . annotation ( i ) . stringify () ) fail ( "not ordered by annotation" );
+        }
+        if ( A != B ) fail ( "annotations differ from the Morse graph at parameter " + std::to_string ( pi ) );
+        if ( X != Y ) fail ( "Morse sets differ from the Morse decomposition at parameter " + std::to_string ( pi ) );
+        num_monostable += ( attractors . size () == 1 );
+        if ( Attractors ( dg ) . stringify () != attractors . stringify () ) fail ( "assign" );
+      }
+      std::cout << filename << ": " << num_monostable << " monostable parameters\n";
+    }
+    Network network ( "networks/network2.txt" );
+    std::cout << Attractors ( DomainGraph ( ParameterGraph ( network ) . parameter ( 0 ) ) ) << "\n";
+  } catch ( std::exception & e ) {
+    std::cout << e . what () << "\n";
+    return 1;
+  }
+  return 0;
+}
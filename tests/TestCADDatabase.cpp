@@ -0,0 +1,68 @@
+/// TestCADDatabase.cpp
+/// Shaun Harker
+/// 2018-11-12
+/// MIT LICENSE
+
+#include "common.h"
+#include "DSGRN.h"
+
+int main ( int argc, char * argv [] ) {
+  try {
+    auto fail = []( std::string const& s) { throw std::logic_error ( s ); };
+    std::string path = "../src/DSGRN/Resources/CAD/2_2_1_1";
+    CADDatabase json_cad ( path + ".json" );
+    CADDatabase binary_cad ( path + ".cad" );
+    std::cout << json_cad << "\n";
+    if ( json_cad . inputs () != 2 || json_cad . outputs () != 2 ) fail ( "CADDatabase inputs/outputs failed" );
+    if ( json_cad . size () != binary_cad . size () ) fail ( "CADDatabase::size mismatch" );
+    uint64_t V = json_cad . variables () . size ();
+    if ( V != 6 ) fail ( "CADDatabase::variables failed" );
+    for ( uint64_t i = 0; i < json_cad . size (); ++ i ) {
+      std::string hex = json_cad . hex ( i );
+      if ( binary_cad . hex ( i ) != hex ) fail ( "CADDatabase::hex mismatch" );
+      if ( binary_cad . index ( hex ) != i ) fail ( "CADDatabase::index failed" );
+      for ( uint64_t k = 0; k < V; ++ k ) {
+        if ( json_cad . instance ( i ) [ k ] != binary_cad . instance ( i ) [ k ] ) {
+          fail ( "CADDatabase::instance mismatch" );
+        }
+      }
+    }
+    // Hex codes are in logic .dat file order
+    std::ifstream logic ( "../src/DSGRN/Resources/logic/2_2_1_1.dat" );
+    std::string hex;
+    for ( uint64_t i = 0; logic >> hex; ++ i ) {
+      if ( json_cad . index ( hex ) != i ) fail ( "CADDatabase logic index failed" );
+    }
+    // Round trip
+    json_cad . save ( "TestCADDatabase.cad" );
+    CADDatabase reloaded ( "TestCADDatabase.cad" );
+    if ( reloaded . hex ( 3 ) != json_cad . hex ( 3 ) ) fail ( "CADDatabase::save failed" );
+    bool caught = false;
+    try { reloaded . index ( "ZZ" ); } catch ( std::out_of_range & ) { caught = true; }
+    if ( not caught ) fail ( "CADDatabase::index did not throw" );
+    std::remove ( "TestCADDatabase.cad" );
+    // A binary file in the other byte order is rejected, and
+    // LoadCADDatabase falls back to the JSON file next to it
+    {
+      std::ifstream binary ( path + ".cad", std::ios::binary );
+      std::string bytes ( ( std::istreambuf_iterator<char> ( binary ) ), std::istreambuf_iterator<char> () );
+      std::reverse ( bytes . begin () + 8, bytes . begin () + 16 );
+      std::ofstream ( "TestCADDatabaseSwapped.cad", std::ios::binary ) << bytes;
+      std::ifstream json ( path + ".json" );
+      std::ofstream ( "TestCADDatabaseSwapped.json" ) << json . rdbuf ();
+    }
+    caught = false;
+    try { CADDatabase swapped ( "TestCADDatabaseSwapped.cad" ); } catch ( std::runtime_error & ) { caught = true; }
+    if ( not caught ) fail ( "CADDatabase accepted a file in the other byte order" );
+    CADDatabase fallback = LoadCADDatabase ( "TestCADDatabaseSwapped" );
+    if ( fallback . size () != json_cad . size () || fallback . hex ( 3 ) != json_cad . hex ( 3 ) ) {
+      fail ( "LoadCADDatabase did not fall back to JSON" );
+    }
+    std::remove ( "TestCADDatabaseSwapped.cad" );
+    std::remove ( "TestCADDatabaseSwapped.json" );
+  } catch ( std::exception & e ) {
+    std::cout << e . what () << "\n";
+    return 1;
+  }
+  return 0;
+}
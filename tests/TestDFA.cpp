@@ -0,0 +1,134 @@
+/// TestDFA.cpp
+/// Shaun Harker
+/// 2018-11-07
+/// MIT LICENSE
+
+#include "common.h"
+#include "DSGRN.h"
+
+int main ( int argc, char * argv [] ) {
+  try {
+    auto fail = [] ( std::string const& message ) {
+      throw std::runtime_error ( "DFA: " + message );
+    };
+    DFA hysteresis = CompileRegexToDFA ( "Q(Q|q)*B+(p|P)*P" );
+    for ( std::string word : { "QBP", "QqQBBpP", "QBBPpP" } ) {
+      if ( not hysteresis . accepts ( word ) ) fail ( "rejected " + word );
+    }
+    for ( std::string word : { "", "QP", "BP", "QBp", "qBP", "QBPq" } ) {
+      if ( hysteresis . accepts ( word ) ) fail ( "accepted " + word );
+    }
+    // Minimization merges the redundant states left by Thompson's and the
+    // subset construction: compare with the minimal state counts and with
+    // the language of the unminimized subset automaton
+    auto closure = [] ( NFA const& nfa, std::set<uint64_t> states ) {
+      std::vector<uint64_t> stack ( states . begin (), states . end () );
+      while ( not stack . empty () ) {
+        uint64_t u = stack . back ();
+        stack . pop_back ();
+        for ( auto const& e : nfa . edges ( u, ' ' ) ) {
+          if ( states . insert ( e . second ) . second ) stack . push_back ( e . second );
+        }
+      }
+      return states;
+    };
+    std::vector<std::pair<std::string,uint64_t>> minimal = {
+      { "a*", 1 }, { "(a|b)*", 1 }, { "a|b", 2 }, { "aa*|a", 2 },
+      { "(ab|ab)(ab)*", 3 }, { "(a|b)*abb", 4 }, { "Q(Q|q)*B+(p|P)*P", 5 } };
+    uint64_t num_merged = 0;
+    for ( auto const& regex_count : minimal ) {
+      std::string regex = regex_count . first;
+      NFA nfa = CompileRegexToNFA ( regex );
+      DFA dfa ( nfa );
+      if ( dfa . num_states () != regex_count . second ) {
+        fail ( regex + " has " + std::to_string ( dfa . num_states () ) + " states, not " + std::to_string ( regex_count . second ) );
+      }
+      std::string alphabet;
+      for ( char c : regex ) if ( std::isalpha ( c ) && alphabet . find ( c ) == std::string::npos ) alphabet . push_back ( c );
+      // Subset construction without minimization
+      std::map<std::set<uint64_t>, uint64_t> subsets;
+      std::vector<std::set<uint64_t>> queue = { closure ( nfa, { nfa . initial () } ) };
+      subsets [ queue [ 0 ] ] = 0;
+      std::vector<std::map<char, uint64_t>> step ( 1 );
+      for ( uint64_t i = 0; i < queue . size (); ++ i ) {
+        for ( char c : alphabet ) {
+          std::set<uint64_t> next;
+          for ( uint64_t u : queue [ i ] ) for ( auto const& e : nfa . edges ( u, c ) ) next . insert ( e . second );
+          if ( next . empty () ) continue;
+          next = closure ( nfa, next );
+          if ( not subsets . count ( next ) ) {
+            subsets [ next ] = queue . size ();
+            queue . push_back ( next );
+            step . emplace_back ();
+          }
+          step [ i ] [ c ] = subsets [ next ];
+        }
+      }
+      if ( queue . size () < dfa . num_states () ) fail ( regex + " has more states than its subset automaton" );
+      if ( queue . size () > dfa . num_states () ) ++ num_merged;
+      // Same language on all words of length at most 6
+      std::vector<std::string> words = { "" };
+      for ( uint64_t i = 0; i < words . size (); ++ i ) {
+        std::string const word = words [ i ];
+        int64_t state = 0;
+        for ( char c : word ) {
+          if ( state == -1 ) break;
+          state = step [ state ] . count ( c ) ? step [ state ] [ c ] : -1;
+        }
+        bool expected = state != -1 && queue [ state ] . count ( nfa . final () );
+        if ( dfa . accepts ( word ) != expected ) fail ( regex + " differs from its subset automaton on \"" + word + "\"" );
+        if ( word . size () < 6 ) for ( char c : alphabet ) words . push_back ( word + c );
+      }
+    }
+    if ( num_merged == 0 ) fail ( "no subset automaton had redundant states" );
+    // Compare DFA acceptance with NFA::intersects on random automata and
+    // graphs over {a,b,' '}, with epsilon edges anywhere
+    std::mt19937_64 rng ( 23 );
+    auto random_nfa = [&] ( uint64_t max_vertices ) {
+      NFA result;
+      uint64_t N = 1 + rng () % max_vertices;
+      for ( uint64_t v = 0; v < N; ++ v ) result . add_vertex ();
+      uint64_t E = rng () % ( 2 * N + 1 );
+      for ( uint64_t e = 0; e < E; ++ e ) {
+        result . add_edge ( rng () % N, rng () % N, "ab "[rng () % 3] );
+      }
+      result . set_initial ( rng () % N );
+      result . set_final ( rng () % N );
+      result . finalize ();
+      return result;
+    };
+    uint64_t num_accepted = 0;
+    for ( int trial = 0; trial < 2000; ++ trial ) {
+      NFA nfa = random_nfa ( 5 );
+      DFA dfa ( nfa );
+      std::string where = " in trial " + std::to_string ( trial );
+      for ( int k = 0; k < 5; ++ k ) {
+        NFA graph = random_nfa ( 6 );
+        bool expected = NFA::intersects ( nfa, graph );
+        if ( dfa . accepts ( graph ) != expected ) fail ( "accepts(graph) differs from NFA::intersects" + where );
+        if ( expected ) ++ num_accepted;
+      }
+      // Words are paths without epsilon edges
+      for ( int k = 0; k < 5; ++ k ) {
+        std::string word;
+        uint64_t length = rng () % 5;
+        for ( uint64_t i = 0; i < length; ++ i ) word . push_back ( "ab"[rng () % 2] );
+        NFA path;
+        path . add_vertex ();
+        for ( uint64_t i = 0; i < length; ++ i ) {
+          path . add_vertex ();
+          path . add_edge ( i, i + 1, word [ i ] );
+        }
+        path . set_initial ( 0 );
+        path . set_final ( length );
+        path . finalize ();
+        if ( dfa . accepts ( word ) != NFA::intersects ( nfa, path ) ) fail ( "accepts(\"" + word + "\") differs from NFA::intersects" + where );
+      }
+    }
+    if ( num_accepted == 0 ) fail ( "no accepted graphs were generated" );
+  } catch ( std::exception & e ) {
+    std::cout << e . what () << "\n";
+    return 1;
+  }
+  return 0;
+}
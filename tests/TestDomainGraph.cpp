@@ -25,6 +25,61 @@ int main ( int argc, char * argv [] ) {
     std::cout << "Construct domain graph.\n";
     DomainGraph dg ( param );
 
+    // The domain graph of a view equals that of the parameter it views
+    for ( uint64_t pi = 0; pi < N; ++ pi ) {
+      Parameter p = pg . parameter ( pi );
+      DomainGraph pdg ( p );
+      DomainGraph view_dg ( ParameterView ( pg, pi ) );
+      std::string where = " at parameter " + std::to_string ( pi );
+      auto fail = [&] ( std::string const& message ) {
+        throw std::runtime_error ( "DomainGraph of a view: " + message + where );
+      };
+      if ( view_dg . digraph () . size () != pdg . digraph () . size () ) fail ( "size differs" );
+      if ( view_dg . labelling () != pdg . labelling () ) fail ( "labelling differs" );
+      if ( view_dg . parameter () . stringify () != p . stringify () ) fail ( "parameter differs" );
+      for ( uint64_t u = 0; u < pdg . digraph () . size (); ++ u ) {
+        if ( view_dg . digraph () . adjacencies ( u ) != pdg . digraph () . adjacencies ( u ) ) fail ( "edges differ" );
+        for ( uint64_t v : pdg . digraph () . adjacencies ( u ) ) {
+          if ( view_dg . regulator ( u, v ) != pdg . regulator ( u, v ) ||
+               view_dg . label ( u, v ) != pdg . label ( u, v ) ) fail ( "edge label differs" );
+        }
+      }
+      Components components = StrongComponents ( pdg . digraph () );
+      for ( uint64_t i = 0; i < components . size (); ++ i ) {
+        if ( view_dg . annotate ( components [ i ] ) . stringify () != pdg . annotate ( components [ i ] ) . stringify () ) {
+          fail ( "annotation differs" );
+        }
+      }
+    }
+
+    // A domain graph built from a labelling kept up to date by relabel
+    // along the Gray code equals the one built from the parameter
+    Parameter previous = pg . parameter ( pg . gray_code ( 0 ) );
+    std::vector<uint64_t> labelling = previous . labelling ();
+    for ( uint64_t k = 0; k < N; ++ k ) {
+      Parameter p = pg . parameter ( pg . gray_code ( k ) );
+      p . relabel ( labelling, previous );
+      previous = p;
+      DomainGraph reused;
+      reused . assign ( p, labelling );
+      DomainGraph direct ( p );
+      if ( reused . labelling () != direct . labelling () || reused . digraph () . size () != direct . digraph () . size () ) {
+        throw std::runtime_error ( "DomainGraph::assign with a labelling differs" );
+      }
+      for ( uint64_t u = 0; u < direct . digraph () . size (); ++ u ) {
+        if ( reused . digraph () . adjacencies ( u ) != direct . digraph () . adjacencies ( u ) ) {
+          throw std::runtime_error ( "DomainGraph::assign with a labelling differs" );
+        }
+      }
+    }
+    bool caught = false;
+    try {
+      DomainGraph () . assign ( param, std::vector<uint64_t> ( 1 ) );
+    } catch ( std::invalid_argument & e ) {
+      caught = true;
+    }
+    if ( not caught ) throw std::runtime_error ( "DomainGraph::assign accepted a labelling of the wrong size" );
+
     // Default constructor
     DomainGraph dg0;
 
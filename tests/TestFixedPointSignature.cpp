@@ -0,0 +1,70 @@
+/// TestFixedPointSignature.cpp
+/// Shaun Harker
+/// 2018-11-20
+/// MIT LICENSE
+
+#include "common.h"
+#include "DSGRN.h"
+
+int main ( int argc, char * argv [] ) {
+  try {
+    auto fail = [] ( std::string const& message ) {
+      throw std::runtime_error ( "FixedPointSignature: " + message );
+    };
+    // Compare against the minimal Morse sets of the full Morse graph
+    for ( std::string filename : { "networks/network2.txt", "networks/network9.txt" } ) {
+      Network network ( filename );
+      ParameterGraph pg ( network );
+      uint64_t step = std::max<uint64_t> ( 1, pg . size () / 500 );
+      uint64_t num_complete = 0;
+      for ( uint64_t pi = 0; pi < pg . size (); pi += step ) {
+        Parameter p = pg . parameter ( pi );
+        FixedPointSignature fp ( p );
+        DomainGraph dg ( p );
+        MorseGraph mg ( dg, MorseDecomposition ( dg . digraph () ) );
+        std::set<std::string> A, B;
+        bool only_fixed_points = true;
+        for ( uint64_t v = 0; v < mg . poset () . size (); ++ v ) {
+          std::string label = mg . annotation ( v ) [ 0 ];
+          bool is_fixed_point = label . substr ( 0, 2 ) == "FP";
+          if ( is_fixed_point ) A . insert ( label );
+          if ( is_fixed_point && not mg . poset () . children ( v ) . empty () ) fail ( "fixed point is not minimal" );
+          if ( mg . poset () . children ( v ) . empty () && not is_fixed_point ) only_fixed_points = false;
+        }
+        for ( uint64_t i = 0; i < fp . size (); ++ i ) {
+          B . insert ( fp . annotation ( i ) [ 0 ] );
+          if ( dg . digraph () . adjacencies ( fp . domains () [ i ] ) != std::vector<uint64_t> { fp . domains () [ i ] } ) fail ( "not a fixed point domain" );
+        }
+        if ( A != B || fp . size () != A . size () ) fail ( "fixed points differ from the Morse graph at parameter " + std::to_string ( pi ) );
+        if ( fp . complete () != only_fixed_points ) fail ( "completeness differs from the Morse graph at parameter " + std::to_string ( pi ) );
+        num_complete += fp . complete ();
+        // A view of the parameter gives the same signature
+        FixedPointSignature view_fp ( ParameterView ( pg, pi ) );
+        if ( view_fp . stringify () != fp . stringify () || view_fp . complete () != fp . complete () ) {
+          fail ( "signature of the view differs at parameter " + std::to_string ( pi ) );
+        }
+      }
+      std::cout << filename << ": " << num_complete << " parameters with only fixed point attractors\n";
+    }
+    Network network ( "networks/network2.txt" );
+    Parameter p = ParameterGraph ( network ) . parameter ( 0 );
+    FixedPointSignature fp;
+    fp . assign ( p, p . labelling () );
+    std::cout << fp << "\n";
+    // Skipping the completeness check finds the same fixed points
+    FixedPointSignature unchecked;
+    unchecked . assign ( p, p . labelling (), false );
+    if ( unchecked . stringify () != fp . stringify () ) fail ( "fixed points differ without the completeness check" );
+    bool caught = false;
+    try {
+      unchecked . complete ();
+    } catch ( std::logic_error & e ) {
+      caught = true;
+    }
+    if ( not caught ) fail ( "complete answered without the completeness check" );
+  } catch ( std::exception & e ) {
+    std::cout << e . what () << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,82 @@
+/// TestLabelledMultidigraph.cpp
+/// Shaun Harker
+/// 2018-11-06
+/// MIT LICENSE
+
+#include "common.h"
+#include "DSGRN.h"
+
+int main ( int argc, char * argv [] ) {
+  try {
+    auto fail = [] ( std::string const& message ) {
+      throw std::runtime_error ( "LabelledMultidigraph: " + message );
+    };
+    LabelledMultidigraph graph;
+    for ( int i = 0; i < 4; ++ i ) graph . add_vertex ();
+    graph . add_edge ( 0, 3, 'b' );
+    graph . add_edge ( 0, 1, 'b' );
+    graph . add_edge ( 0, 2, 'a' );
+    graph . add_edge ( 0, 1, 'b' );  // duplicate
+    graph . add_edge ( 0, 0, ' ' );
+    graph . add_edge ( 2, 1, 'a' );
+    if ( graph . finalized () ) fail ( "finalized before finalize" );
+    // Reads finalize the graph first, and a copy reads the same edges
+    LabelledMultidigraph copy ( graph );
+    if ( not graph . finalized () || not copy . finalized () ) fail ( "copy did not finalize" );
+    LabelledMultidigraph unread;
+    for ( int i = 0; i < 4; ++ i ) unread . add_vertex ();
+    unread . add_edge ( 0, 1, 'b' );
+    unread . add_edge ( 0, 1, 'b' );  // duplicate
+    if ( unread . num_edges () != 1 ) fail ( "num_edges does not count distinct edges" );
+    if ( not unread . finalized () ) fail ( "num_edges did not finalize" );
+    std::map<char, std::unordered_set<uint64_t>> adjacencies = { {' ', {0}}, {'a', {2}}, {'b', {1, 3}} };
+    std::string dot = graph . graphviz ();
+    if ( std::count ( dot . begin (), dot . end (), '>' ) != 5 ) fail ( "graphviz failed" );
+    graph . finalize ();
+    if ( not graph . finalized () ) fail ( "finalize failed" );
+    if ( graph . num_edges () != 5 || copy . num_edges () != 5 ) fail ( "num_edges failed" );
+    if ( copy . adjacencies ( 0 ) != adjacencies ) fail ( "adjacencies of a copy failed" );
+    // Out-edges are contiguous and sorted by (label, target)
+    std::vector<LabelledMultidigraph::Edge> expected = { {' ', 0}, {'a', 2}, {'b', 1}, {'b', 3} };
+    auto range = graph . edges ( 0 );
+    if ( range . size () != expected . size () ) fail ( "EdgeRange size failed" );
+    if ( not std::equal ( range . begin (), range . end (), expected . begin () ) ) fail ( "edge order failed" );
+    if ( graph . edges ( 2 ) . begin () != range . end () ) fail ( "edge array is not contiguous" );
+    if ( not graph . edges ( 1 ) . empty () || not graph . edges ( 3 ) . empty () ) fail ( "EdgeRange empty failed" );
+    auto b = graph . edges ( 0, 'b' );
+    if ( b . size () != 2 || b . begin () [ 0 ] . second != 1 || b . begin () [ 1 ] . second != 3 ) fail ( "edges by label failed" );
+    if ( not graph . edges ( 0, 'c' ) . empty () ) fail ( "edges by missing label failed" );
+    if ( graph . edges ( 2, 'a' ) . size () != 1 ) fail ( "edges of last vertex failed" );
+    if ( graph . adjacencies ( 0 ) != adjacencies ) fail ( "adjacencies failed" );
+    if ( graph . unlabelled_adjacencies ( 0 ) != std::unordered_set<uint64_t> ( { 0, 1, 2, 3 } ) ) fail ( "unlabelled_adjacencies failed" );
+    // Modifying the graph finalizes it again on the next read, which may
+    // come from several threads at once
+    uint64_t v = graph . add_vertex ();
+    graph . add_edge ( 1, v, 'c' );
+    graph . add_edge ( 0, 3, 'b' );  // already in the edge array
+    if ( graph . finalized () ) fail ( "add_edge did not invalidate finalize" );
+    std::vector<uint64_t> sizes ( 8 );
+    std::vector<std::thread> threads;
+    for ( uint64_t t = 0; t < sizes . size (); ++ t ) {
+      threads . emplace_back ( [&, t] () { sizes [ t ] = graph . edges ( 0 ) . size () + graph . edges ( 1 ) . size (); } );
+    }
+    for ( auto & thread : threads ) thread . join ();
+    if ( std::count ( sizes . begin (), sizes . end (), 5 ) != (int64_t) sizes . size () ) fail ( "concurrent finalize failed" );
+    if ( graph . num_edges () != 6 ) fail ( "num_edges after add_edge failed" );
+    if ( graph . adjacencies ( 0 ) != adjacencies ) fail ( "adjacencies after add_edge failed" );
+    dot = graph . graphviz ();
+    if ( std::count ( dot . begin (), dot . end (), '>' ) != 6 ) fail ( "graphviz after add_edge failed" );
+    if ( copy . num_edges () != 5 ) fail ( "copy shares edges with the graph" );
+    bool caught = false;
+    try {
+      graph . add_edge ( 0, 10, 'a' );
+    } catch ( std::invalid_argument & e ) {
+      caught = true;
+    }
+    if ( not caught ) fail ( "vertex out of range not detected" );
+  } catch ( std::exception & e ) {
+    std::cout << e . what () << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -63,6 +63,13 @@ int main ( int argc, char * argv [] ) {
     std::cout << "Reinputting the output:\n";
     std::cout << mg2 . stringify () << "\n";
 
+    // Binary round trip
+    MorseGraph mg3;
+    mg3 . deserialize ( mg . serialize () );
+    if ( mg3 . stringify () != mg . stringify () || mg3 . serialize () != mg . serialize () ) {
+      throw std::runtime_error ( "MorseGraph::serialize bug" );
+    }
+
     boost::archive::text_oarchive oa(std::cout);
     oa << mg;
   } catch ( std::exception & e ) {
@@ -0,0 +1,215 @@
+/// TestNFA.cpp
+/// Shaun Harker
+/// 2018-11-06
+/// MIT LICENSE
+
+#include "common.h"
+#include "DSGRN.h"
+
+int main ( int argc, char * argv [] ) {
+  try {
+    auto fail = [] ( std::string const& message ) {
+      throw std::runtime_error ( "NFA: " + message );
+    };
+    uint64_t const saturated = std::numeric_limits<uint64_t>::max ();
+    // Diamond 0 -> {1,2} -> 3 with two parallel edges 0 -> 1 and an epsilon
+    // self-loop on every vertex. The accepting paths are 0a1c3, 0x1c3, 0b2c3.
+    // Vertex 4 is reachable but cannot reach the final vertex, so its
+    // cycle does not make the count infinite.
+    NFA nfa;
+    for ( int i = 0; i < 5; ++ i ) nfa . add_vertex ();
+    for ( int i = 0; i < 5; ++ i ) nfa . add_edge ( i, i, ' ' );
+    nfa . add_edge ( 0, 1, 'a' );
+    nfa . add_edge ( 0, 1, 'x' );
+    nfa . add_edge ( 0, 2, 'b' );
+    nfa . add_edge ( 1, 3, 'c' );
+    nfa . add_edge ( 2, 3, 'c' );
+    nfa . add_edge ( 2, 4, 'd' );
+    nfa . add_edge ( 4, 4, 'd' );
+    nfa . set_initial ( 0 );
+    nfa . set_final ( 3 );
+    nfa . finalize ();
+    if ( nfa . count_paths () != 3 ) fail ( "count_paths on diamond failed" );
+    // Final vertex not reachable
+    NFA disconnected;
+    disconnected . add_vertex ();
+    disconnected . add_vertex ();
+    disconnected . add_edge ( 1, 0, 'a' );
+    disconnected . set_initial ( 0 );
+    disconnected . set_final ( 1 );
+    disconnected . finalize ();
+    if ( disconnected . count_paths () != 0 ) fail ( "count_paths on disconnected graph failed" );
+    // A cycle on an accepting path gives infinitely many paths
+    NFA cyclic;
+    for ( int i = 0; i < 3; ++ i ) cyclic . add_vertex ();
+    cyclic . add_edge ( 0, 1, 'a' );
+    cyclic . add_edge ( 1, 0, 'b' );
+    cyclic . add_edge ( 1, 2, 'c' );
+    cyclic . set_initial ( 0 );
+    cyclic . set_final ( 2 );
+    cyclic . finalize ();
+    if ( cyclic . count_paths () != saturated ) fail ( "count_paths on cycle failed" );
+    // A chain of 70 doubled edges has 2^70 paths, which saturates
+    NFA chain;
+    for ( int i = 0; i <= 70; ++ i ) chain . add_vertex ();
+    for ( int i = 0; i < 70; ++ i ) {
+      chain . add_edge ( i, i + 1, 'a' );
+      chain . add_edge ( i, i + 1, 'b' );
+    }
+    chain . set_initial ( 0 );
+    chain . set_final ( 63 );
+    chain . finalize ();
+    if ( chain . count_paths () != ( 1ULL << 63 ) ) fail ( "count_paths on chain failed" );
+    chain . set_final ( 70 );
+    if ( chain . count_paths () != saturated ) fail ( "count_paths overflow failed" );
+    // Only labelled edges are counted: epsilon chains, parallel epsilon
+    // routes and epsilon cycles do not change the count, so automata of
+    // one set of labelled paths agree however they are compiled
+    NFA direct;
+    for ( int i = 0; i < 2; ++ i ) direct . add_vertex ();
+    direct . add_edge ( 0, 1, 'a' );
+    direct . set_initial ( 0 );
+    direct . set_final ( 1 );
+    NFA routed;
+    for ( int i = 0; i < 5; ++ i ) routed . add_vertex ();
+    routed . add_edge ( 0, 1, ' ' );
+    routed . add_edge ( 1, 2, ' ' );
+    routed . add_edge ( 0, 2, ' ' );
+    routed . add_edge ( 2, 0, ' ' );
+    routed . add_edge ( 2, 3, 'a' );
+    routed . add_edge ( 3, 4, ' ' );
+    routed . add_edge ( 4, 3, ' ' );
+    routed . set_initial ( 0 );
+    routed . set_final ( 4 );
+    if ( direct . count_paths () != 1 || routed . count_paths () != 1 ) fail ( "count_paths counted epsilon edges" );
+    if ( CompileRegexToNFA ( "a" ) . count_paths () != 1 ) fail ( "count_paths on a failed" );
+    if ( CompileRegexToNFA ( "a(b|c)" ) . count_paths () != 2 || CompileRegexToNFA ( "(ab|ac)" ) . count_paths () != 2 ) fail ( "count_paths on a(b|c) failed" );
+    if ( CompileRegexToNFA ( "(a|b)(c|d)" ) . count_paths () != 4 ) fail ( "count_paths on (a|b)(c|d) failed" );
+    if ( CompileRegexToNFA ( "ab*" ) . count_paths () != saturated ) fail ( "count_paths on ab* failed" );
+    // The empty word is one path when the final vertex is in the closure
+    // of the initial vertex
+    routed . set_final ( 2 );
+    if ( routed . count_paths () != 1 ) fail ( "count_paths of the empty word failed" );
+    // Epsilon edges are free moves of one automaton
+    NFA lhs_epsilon;
+    for ( int i = 0; i < 3; ++ i ) lhs_epsilon . add_vertex ();
+    lhs_epsilon . add_edge ( 0, 1, ' ' );
+    lhs_epsilon . add_edge ( 1, 2, 'a' );
+    lhs_epsilon . set_initial ( 0 );
+    lhs_epsilon . set_final ( 2 );
+    lhs_epsilon . finalize ();
+    NFA rhs_epsilon;
+    for ( int i = 0; i < 2; ++ i ) rhs_epsilon . add_vertex ();
+    rhs_epsilon . add_edge ( 0, 1, 'a' );
+    rhs_epsilon . set_initial ( 0 );
+    rhs_epsilon . set_final ( 1 );
+    rhs_epsilon . finalize ();
+    if ( not NFA::intersects ( lhs_epsilon, rhs_epsilon ) ) fail ( "intersects with epsilon edge failed" );
+    if ( NFA::witness ( rhs_epsilon, lhs_epsilon ) . size () != 3 ) fail ( "witness with epsilon edge failed" );
+    // NFA::intersect pairs the epsilon edge 0 -> 1 of lhs_epsilon with an
+    // epsilon edge of rhs_epsilon, which has none, so its product does not
+    // reach the final pair; with an epsilon self-loop on every vertex of
+    // both automata it is the product intersects explores
+    auto product_reaches_final = [] ( NFA const& product ) -> bool {
+      std::vector<bool> reached ( product . num_vertices (), false );
+      std::vector<uint64_t> stack { product . initial () };
+      reached [ product . initial () ] = true;
+      while ( not stack . empty () ) {
+        uint64_t u = stack . back ();
+        stack . pop_back ();
+        for ( auto const& e : product . edges ( u ) ) {
+          if ( reached [ e . second ] ) continue;
+          reached [ e . second ] = true;
+          stack . push_back ( e . second );
+        }
+      }
+      return reached [ product . final () ];
+    };
+    if ( product_reaches_final ( NFA::intersect ( lhs_epsilon, rhs_epsilon ) . first ) ) {
+      fail ( "intersect followed an unpaired epsilon edge" );
+    }
+    auto looped = [] ( NFA nfa ) {
+      for ( uint64_t v = 0; v < nfa . num_vertices (); ++ v ) nfa . add_edge ( v, v, ' ' );
+      nfa . finalize ();
+      return nfa;
+    };
+    NFA lhs_looped = looped ( lhs_epsilon );
+    NFA rhs_looped = looped ( rhs_epsilon );
+    if ( not product_reaches_final ( NFA::intersect ( lhs_looped, rhs_looped ) . first ) ||
+         not NFA::intersects ( lhs_looped, rhs_looped ) ) fail ( "intersect with epsilon self-loops failed" );
+    // Compare intersects and witness against reachability in the product
+    // automaton built by NFA::intersect from the looped automata, on
+    // random automata over {a,b,' '} with epsilon edges anywhere
+    std::mt19937_64 rng ( 17 );
+    auto random_nfa = [&] ( ) {
+      NFA result;
+      uint64_t N = 1 + rng () % 6;
+      for ( uint64_t v = 0; v < N; ++ v ) result . add_vertex ();
+      uint64_t E = rng () % ( 2 * N + 1 );
+      for ( uint64_t e = 0; e < E; ++ e ) {
+        uint64_t u = rng () % N;
+        uint64_t v = rng () % N;
+        char label = "ab "[rng () % 3];
+        result . add_edge ( u, v, label );
+      }
+      result . set_initial ( rng () % N );
+      result . set_final ( rng () % N );
+      result . finalize ();
+      return result;
+    };
+    auto has_edge = [] ( NFA const& g, uint64_t u, uint64_t v, char label ) {
+      for ( auto const& e : g . edges ( u ) ) {
+        if ( e . first == label && e . second == v ) return true;
+      }
+      return false;
+    };
+    uint64_t num_intersecting = 0;
+    uint64_t num_epsilon_moves = 0;
+    for ( int trial = 0; trial < 2000; ++ trial ) {
+      NFA lhs = random_nfa ();
+      NFA rhs = random_nfa ();
+      bool expected = product_reaches_final ( NFA::intersect ( looped ( lhs ), looped ( rhs ) ) . first );
+      std::string where = " in trial " + std::to_string ( trial );
+      if ( NFA::intersects ( lhs, rhs ) != expected ) fail ( "intersects differs from intersect" + where );
+      auto path = NFA::witness ( lhs, rhs );
+      if ( path . empty () != not expected ) fail ( "witness differs from intersect" + where );
+      if ( not expected ) continue;
+      ++ num_intersecting;
+      // Trials needing a non-self-loop epsilon edge moving one side alone
+      if ( not product_reaches_final ( NFA::intersect ( lhs, rhs ) . first ) ) ++ num_epsilon_moves;
+      if ( path . front () != std::make_pair ( lhs . initial (), rhs . initial () ) ) fail ( "witness start failed" + where );
+      if ( path . back () != std::make_pair ( lhs . final (), rhs . final () ) ) fail ( "witness end failed" + where );
+      for ( uint64_t i = 1; i < path . size (); ++ i ) {
+        auto const& a = path[i-1];
+        auto const& b = path[i];
+        bool step = ( a . second == b . second && has_edge ( lhs, a . first, b . first, ' ' ) ) ||
+                    ( a . first == b . first && has_edge ( rhs, a . second, b . second, ' ' ) );
+        for ( char label : { 'a', 'b' } ) {
+          if ( has_edge ( lhs, a . first, b . first, label ) &&
+               has_edge ( rhs, a . second, b . second, label ) ) step = true;
+        }
+        if ( not step ) fail ( "witness step failed" + where );
+      }
+    }
+    if ( num_intersecting == 0 ) fail ( "no intersecting automata were generated" );
+    if ( num_epsilon_moves == 0 ) fail ( "no intersections through unpaired epsilon edges were generated" );
+    // An automaton edited after its construction is finalized by the
+    // first read, which sees the edges added since
+    auto reopened = [&] ( ) {
+      NFA open_lhs = lhs_epsilon;
+      open_lhs . add_edge ( 1, 2, 'a' );  // already an edge
+      if ( open_lhs . finalized () ) fail ( "add_edge did not unfinalize" );
+      return open_lhs;
+    };
+    if ( NFA::intersects ( reopened (), rhs_epsilon ) != NFA::intersects ( lhs_epsilon, rhs_epsilon ) ) fail ( "intersects before finalize failed" );
+    if ( NFA::intersect ( rhs_epsilon, reopened () ) . first . num_edges () != NFA::intersect ( rhs_epsilon, lhs_epsilon ) . first . num_edges () ) fail ( "intersect before finalize failed" );
+    if ( reopened () . count_paths () != lhs_epsilon . count_paths () ) fail ( "count_paths before finalize failed" );
+    if ( DFA ( reopened () ) . num_states () != DFA ( lhs_epsilon ) . num_states () ) fail ( "DFA before finalize failed" );
+    if ( reopened () . num_edges () != lhs_epsilon . num_edges () ) fail ( "num_edges before finalize failed" );
+    if ( reopened () . graphviz () != lhs_epsilon . graphviz () ) fail ( "graphviz before finalize failed" );
+  } catch ( std::exception & e ) {
+    std::cout << e . what () << "\n";
+    return 1;
+  }
+  return 0;
+}
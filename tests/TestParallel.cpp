@@ -0,0 +1,54 @@
+/// TestParallel.cpp
+/// Shaun Harker
+/// 2018-11-08
+/// MIT LICENSE
+
+#include "common.h"
+#include "DSGRN.h"
+
+int main ( int argc, char * argv [] ) {
+  try {
+    auto fail = [] ( std::string const& message ) {
+      throw std::runtime_error ( "parallel_for: " + message );
+    };
+    if ( dsgrn::hardware_threads () == 0 ) fail ( "hardware_threads failed" );
+    // Every index is visited exactly once, by a thread in range
+    for ( uint64_t num_threads : { 0, 1, 3, 8 } ) {
+      for ( uint64_t grain : { 0, 1, 7, 1000 } ) {
+        uint64_t const begin = 5;
+        uint64_t const end = 5000;
+        uint64_t const T = num_threads ? num_threads : dsgrn::hardware_threads ();
+        std::vector<std::atomic<uint64_t>> visits ( end );
+        for ( auto & v : visits ) v = 0;
+        std::atomic<bool> bad_thread ( false );
+        dsgrn::parallel_for ( begin, end, num_threads, grain, [&] ( uint64_t thread, uint64_t i ) {
+          if ( thread >= T ) bad_thread = true;
+          ++ visits [ i ];
+        });
+        if ( bad_thread ) fail ( "thread index out of range" );
+        for ( uint64_t i = 0; i < end; ++ i ) {
+          if ( visits [ i ] != ( i >= begin ? 1 : 0 ) ) fail ( "index " + std::to_string ( i ) + " not visited once" );
+        }
+      }
+    }
+    // Empty range
+    bool called = false;
+    dsgrn::parallel_for ( 10, 10, 4, 1, [&] ( uint64_t, uint64_t ) { called = true; } );
+    dsgrn::parallel_for ( 10, 5, 4, 1, [&] ( uint64_t, uint64_t ) { called = true; } );
+    if ( called ) fail ( "empty range failed" );
+    // Exceptions thrown by workers are rethrown after the threads join
+    bool caught = false;
+    try {
+      dsgrn::parallel_for ( 0, 100000, 4, 1, [&] ( uint64_t, uint64_t i ) {
+        if ( i == 500 ) throw std::invalid_argument ( "expected" );
+      });
+    } catch ( std::invalid_argument & e ) {
+      caught = std::string ( e . what () ) == "expected";
+    }
+    if ( not caught ) fail ( "exception not rethrown" );
+  } catch ( std::exception & e ) {
+    std::cout << e . what () << "\n";
+    return 1;
+  }
+  return 0;
+}
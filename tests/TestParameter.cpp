@@ -17,6 +17,37 @@ int main ( int argc, char * argv [] ) {
     q . parse ( p . stringify () );
     std::cout << q << "\n";
     std::cout << q . network () << "\n";
+    Parameter r;
+    r . deserialize ( p . serialize () );
+    if ( r . stringify () != p . stringify () || pg . index ( r ) != 43 ) {
+      throw std::runtime_error ( "Parameter::serialize bug" );
+    }
+    // Cached labellings equal labellings computed directly, for networks
+    // whose domains span several words of the bit planes, and for
+    // networks with the same specification (which do not share planes).
+    // The direct computation uses the BoxFill instantiation which reads
+    // the dimension at run time, so it also checks the specialized one.
+    std::string spec = "X : X + Y + Z \n Y : X + Y + Z \n Z : X + Y + Z \n W : X + W \n";
+    std::mt19937_64 rng ( 3 );
+    for ( int copy = 0; copy < 2; ++ copy ) {
+      Network big ( spec );
+      ParameterGraph big_pg ( big );
+      for ( int trial = 0; trial < 50; ++ trial ) {
+        Parameter s = big_pg . parameter ( rng () % big_pg . size () );
+        uint64_t N = 1;
+        for ( uint64_t limit : big . domains () ) N *= limit;
+        std::vector<uint64_t> expected ( N, 0 );
+        for ( uint64_t d = 0; d < big . size (); ++ d ) {
+          Parameter_detail::label_dimension ( big, d, &Parameter_detail::BoxFill<0>::run,
+            [&] ( uint64_t in ) { return s . logic () [ d ] . bin ( in ); },
+            [&] ( uint64_t source, uint64_t outorder ) { return s . order () [ source ] . inverse ( outorder ); },
+            expected );
+        }
+        if ( s . labelling () != expected || s . cached_labelling () != expected ) {
+          throw std::runtime_error ( "Parameter::labelling cache bug" );
+        }
+      }
+    }
     boost::archive::text_oarchive oa(std::cout);
     oa << p;
   } catch ( std::exception & e ) {
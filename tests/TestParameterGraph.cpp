@@ -47,12 +47,147 @@ int main ( int argc, char * argv [] ) {
       std::cout << pg. parameter (j) . stringify () << "\n";
     }
 
+    // Test ParameterGraph::gray_code and Parameter::relabel
+    std::vector<bool> visited ( N, false );
+    Parameter previous = pg . parameter ( pg . gray_code ( 0 ) );
+    std::vector<uint64_t> labelling = previous . labelling ();
+    for ( uint64_t k = 0; k < N; ++ k ) {
+      uint64_t i = pg . gray_code ( k );
+      if ( visited [ i ] ) throw std::runtime_error ( "ParameterGraph::gray_code bug");
+      visited [ i ] = true;
+      Parameter p = pg . parameter ( i );
+      p . relabel ( labelling, previous );
+      if ( labelling != p . labelling () ) throw std::runtime_error ( "Parameter::relabel bug");
+      previous = p;
+    }
+
+    // Test Parameter::cached_labelling, with and without the plane caches
+    for ( uint64_t bytes : { (uint64_t) 1 << 26, (uint64_t) 0 } ) {
+      configuration () -> set_labelling_cache_bytes ( bytes );
+      configuration () -> set_labelling_front_cache_bytes ( bytes );
+      for ( uint64_t i = 0; i < N; ++ i ) {
+        Parameter p = pg . parameter ( i );
+        if ( p . cached_labelling () != p . labelling () ) throw std::runtime_error ( "Parameter::cached_labelling bug");
+      }
+    }
+    configuration () -> set_labelling_cache_bytes ( (uint64_t) 1 << 26 );
+    configuration () -> set_labelling_front_cache_bytes ( (uint64_t) 1 << 22 );
+
+    // Test binary serialization (the factor graphs travel with it, but
+    // not the machine-local paths of the logic resources)
+    std::string bytes = pg . serialize ();
+    std::string path = configuration () -> get_path ();
+    if ( bytes . find ( path ) != std::string::npos ) throw std::runtime_error ( "ParameterGraph::serialize stored a path");
+    configuration () -> set_path ( "/nonexistent" );
+    ParameterGraph pg2;
+    pg2 . deserialize ( bytes );
+    configuration () -> set_path ( path );
+    if ( pg2 . size () != N ) throw std::runtime_error ( "ParameterGraph::serialize bug");
+    for ( uint64_t i = 0; i < N; ++ i ) {
+      if ( pg2 . parameter ( i ) . stringify () != pg . parameter ( i ) . stringify () ) {
+        throw std::runtime_error ( "ParameterGraph::serialize bug");
+      }
+    }
+
+    // Test factor graph edges: hex codes differing by setting one bit, the
+    // same for a deserialized graph and for another network whose node
+    // has the same logic shape
+    Network same_shape;
+    same_shape . assign ( network . specification () );
+    ParameterGraph pg3 ( same_shape );
+    // A graph on the same network whose factor tables list the hex codes
+    // in reverse (as if loaded from other logic files) has its own edges
+    auto reversed_bytes = [&] ( bool wrong_shape ) {
+      dsgrn::BinaryWriter writer ( 'G' );
+      writer . string ( network . specification () );
+      writer . integer ( network . size () );
+      for ( uint64_t d = 0; d < network . size (); ++ d ) {
+        std::vector<std::string> reversed ( pg . factorgraph ( d ) . rbegin (), pg . factorgraph ( d ) . rend () );
+        writer . string ( ParameterGraph_detail::logic_shape ( network, d ) + ( wrong_shape ? "_E" : "" ) );
+        ParameterGraph_detail::pack_hexcodes ( writer, reversed );
+      }
+      return writer . bytes ();
+    };
+    ParameterGraph pg4;
+    pg4 . deserialize ( reversed_bytes ( false ) );
+    bool caught = false;
+    try {
+      ParameterGraph ( ) . deserialize ( reversed_bytes ( true ) );
+    } catch ( std::exception & e ) {
+      caught = true;
+    }
+    if ( not caught ) throw std::runtime_error ( "ParameterGraph::deserialize accepted a wrong logic shape");
+    auto expected_edges = [] ( std::vector<std::string> const& hexcodes ) {
+      std::set<std::pair<uint64_t,uint64_t>> expected;
+      for ( uint64_t a = 0; a < hexcodes . size (); ++ a ) {
+        for ( uint64_t b = 0; b < hexcodes . size (); ++ b ) {
+          uint64_t x = std::stoull ( hexcodes [ a ], nullptr, 16 );
+          uint64_t y = std::stoull ( hexcodes [ b ], nullptr, 16 );
+          uint64_t bit = x ^ y;
+          if ( ( y & bit ) == bit && bit != 0 && ( bit & ( bit - 1 ) ) == 0 ) expected . insert ( { a, b } );
+        }
+      }
+      return expected;
+    };
+    for ( uint64_t d = 0; d < network . size (); ++ d ) {
+      auto const& edges = pg . factorgraph_edges ( d );
+      if ( std::set<std::pair<uint64_t,uint64_t>> ( edges . begin (), edges . end () ) != expected_edges ( pg . factorgraph ( d ) ) ) {
+        throw std::runtime_error ( "ParameterGraph::factorgraph_edges bug");
+      }
+      if ( pg2 . factorgraph_edges ( d ) != edges || pg3 . factorgraph_edges ( d ) != edges ) {
+        throw std::runtime_error ( "ParameterGraph::factorgraph_edges copy bug");
+      }
+      auto const& reversed_edges = pg4 . factorgraph_edges ( d );
+      if ( std::set<std::pair<uint64_t,uint64_t>> ( reversed_edges . begin (), reversed_edges . end () ) != expected_edges ( pg4 . factorgraph ( d ) ) ) {
+        throw std::runtime_error ( "ParameterGraph::factorgraph_edges bug for other factor tables");
+      }
+      // Graphs built separately share the edges of equal factor graphs
+      if ( &ParameterGraph ( Network ( filename ) ) . factorgraph_edges ( d ) != &edges ) {
+        throw std::runtime_error ( "ParameterGraph::factorgraph_edges sharing bug");
+      }
+      if ( pg4 . factorgraph ( d ) != pg . factorgraph ( d ) && &reversed_edges == &edges ) {
+        throw std::runtime_error ( "ParameterGraph::factorgraph_edges shared between other factor tables");
+      }
+    }
+
     // Test loading an unsupported network (should throw)
     try {
       Network net ( "networks/network4.txt" );
       ParameterGraph pg1 ( net );
     } catch ( ... ) {}
 
+    // Test a network with more nodes than labels have room for: the graph
+    // and its parameters work, and only labelling is unsupported
+    std::string cycle;
+    for ( uint64_t d = 0; d < 33; ++ d ) {
+      cycle += "x" + std::to_string ( d ) + " : x" + std::to_string ( ( d + 32 ) % 33 ) + "\n";
+    }
+    Network large;
+    large . assign ( cycle );
+    ParameterGraph pg_large ( large );
+    uint64_t large_size = 1;
+    for ( uint64_t d = 0; d < 33; ++ d ) large_size *= 3;
+    if ( pg_large . size () != large_size ) throw std::runtime_error ( "ParameterGraph::size bug for 33 nodes");
+    Parameter p_large = pg_large . parameter ( large_size - 1 );
+    if ( pg_large . index ( p_large ) != large_size - 1 ) throw std::runtime_error ( "ParameterGraph::index bug for 33 nodes");
+    Parameter q_large ( large );
+    q_large . parse ( p_large . stringify () );
+    if ( q_large . stringify () != p_large . stringify () ) throw std::runtime_error ( "Parameter::parse bug for 33 nodes");
+    caught = false;
+    try {
+      p_large . labelling ();
+    } catch ( std::invalid_argument & e ) {
+      caught = true;
+    }
+    if ( not caught ) throw std::runtime_error ( "Parameter::labelling accepted 33 nodes");
+    caught = false;
+    try {
+      ParameterView ( pg_large, 0 );
+    } catch ( std::invalid_argument & e ) {
+      caught = true;
+    }
+    if ( not caught ) throw std::runtime_error ( "ParameterView accepted 33 nodes");
+
     // Test serialization
     boost::archive::text_oarchive oa(std::cout);
     oa << pg;
@@ -0,0 +1,126 @@
+/// TestParameterSampler.cpp
+/// Shaun Harker
+/// 2018-11-13
+/// MIT LICENSE
+
+#include "common.h"
+#include "DSGRN.h"
+
+int main ( int argc, char * argv [] ) {
+  try {
+    auto fail = [] ( std::string const& message ) {
+      throw std::runtime_error ( "ParameterSampler: " + message );
+    };
+    Network network;
+    network . assign ( "X : (X)(Y + ~Z) \n"
+                       "Y : X           \n"
+                       "Z : X + Y       \n" );
+    ParameterGraph pg ( network );
+    ParameterSampler sampler ( network );
+    // check
+    //   Throw unless the named values lie in the region of parameter p:
+    //   thresholds are increasing and each L/U formula of each node lies
+    //   between the thresholds of its bin
+    auto check = [&] ( Parameter const& p, std::map<std::string, double> const& values ) {
+      for ( uint64_t d = 0; d < network . size (); ++ d ) {
+        std::string const& name = network . name ( d );
+        std::vector<uint64_t> const& inputs = network . inputs ( d );
+        std::vector<uint64_t> const& outputs = network . outputs ( d );
+        uint64_t n = inputs . size ();
+        uint64_t m = outputs . size ();
+        std::vector<double> T;
+        for ( uint64_t r = 0; r < m; ++ r ) {
+          T . push_back ( values . at ( "T[" + name + ", " + network . name ( outputs [ p . order () [ d ] ( r ) ] ) + "]" ) );
+          if ( r > 0 && not ( T [ r - 1 ] < T [ r ] ) ) fail ( "thresholds out of order" );
+        }
+        for ( uint64_t j = 0; j < ( 1ULL << n ); ++ j ) {
+          double product = 1.0;
+          uint64_t i = 0;
+          for ( auto const& factor : network . logic ( d ) ) {
+            double sum = 0.0;
+            for ( uint64_t t = 0; t < factor . size (); ++ t, ++ i ) {
+              std::string const& input_name = network . name ( inputs [ i ] );
+              double L = values . at ( "L[" + input_name + ", " + name + "]" );
+              double U = values . at ( "U[" + input_name + ", " + name + "]" );
+              if ( not ( 0 < L && L < U ) ) fail ( "L/U out of order" );
+              sum += ( j & ( 1LL << i ) ) ? U : L;
+            }
+            product *= sum;
+          }
+          uint64_t bin = p . logic () [ d ] . bin ( j );
+          if ( ( bin > 0 && not ( T [ bin - 1 ] < product ) ) || ( bin < m && not ( product < T [ bin ] ) ) ) {
+            fail ( "sample outside the region of " + p . stringify () );
+          }
+        }
+      }
+    };
+    auto parse = [] ( std::string const& sample ) {
+      std::map<std::string, double> result;
+      json J = json::parse ( sample ) [ "Parameter" ];
+      for ( auto it = J . begin (); it != J . end (); ++ it ) result [ it . key () ] = it . value ();
+      return result;
+    };
+    std::mt19937_64 rng ( 11 );
+    std::vector<Parameter> parameters;
+    for ( int k = 0; k < 20; ++ k ) parameters . push_back ( pg . parameter ( rng () % pg . size () ) );
+    for ( auto const& p : parameters ) {
+      check ( p, parse ( sampler . sample ( p ) ) );
+      for ( auto const& s : sampler . sample ( p, 7 ) ) check ( p, parse ( s ) );
+    }
+    // Concurrent calls on one sampler (each call has its own tableau)
+    std::vector<std::vector<std::string>> samples ( 4 );
+    {
+      std::vector<std::thread> threads;
+      for ( uint64_t t = 0; t < samples . size (); ++ t ) {
+        threads . push_back ( std::thread ( [&, t] () {
+          for ( auto const& p : parameters ) {
+            for ( auto const& s : sampler . sample ( p, 3 ) ) samples [ t ] . push_back ( s );
+          }
+        }));
+      }
+      for ( auto & thread : threads ) thread . join ();
+    }
+    for ( auto const& thread_samples : samples ) {
+      if ( thread_samples . size () != 3 * parameters . size () ) fail ( "concurrent sample lost samples" );
+      for ( uint64_t k = 0; k < thread_samples . size (); ++ k ) {
+        check ( parameters [ k / 3 ], parse ( thread_samples [ k ] ) );
+      }
+    }
+    // sample_many has the columns of variables (), which are the names
+    // sample uses, and its rows lie in the regions of their parameters
+    std::vector<std::string> names = sampler . variables ();
+    std::map<std::string, double> named = parse ( sampler . sample ( parameters [ 0 ] ) );
+    if ( names . size () != named . size () ) fail ( "variables differ from the names of sample" );
+    for ( auto const& name : names ) {
+      if ( named . count ( name ) == 0 ) fail ( "variables differ from the names of sample" );
+    }
+    std::vector<uint64_t> indices;
+    for ( auto const& p : parameters ) indices . push_back ( pg . index ( p ) );
+    uint64_t const B = 5;
+    uint64_t const C = names . size ();
+    std::vector<double> rows = sampler . sample_many ( indices, B, 3, 17 );
+    if ( rows . size () != indices . size () * B * C ) fail ( "sample_many size" );
+    for ( uint64_t r = 0; r < indices . size () * B; ++ r ) {
+      std::map<std::string, double> values;
+      for ( uint64_t c = 0; c < C; ++ c ) values [ names [ c ] ] = rows [ r * C + c ];
+      check ( parameters [ r / B ], values );
+    }
+    if ( sampler . sample_many ( indices, B, 1, 17 ) != rows ) fail ( "sample_many depends on the number of threads" );
+    bool caught = false;
+    try { sampler . sample_many ( { 0, pg . size () }, 1 ); } catch ( std::out_of_range & ) { caught = true; }
+    if ( not caught ) fail ( "sample_many accepted an index out of bounds" );
+    // Logic codes longer than 64 bits are binned without packing them in
+    // a word (n = 4, m = 5: 80 bits)
+    std::string hex;
+    for ( int k = 0; k < 20; ++ k ) hex . push_back ( "0123456789ABCDEF"[rng () % 16] );
+    std::vector<uint8_t> bins = ParameterGraph_detail::logic_bins ( { hex }, 4, 5 );
+    LogicParameter lp ( 4, 5, hex );
+    for ( uint64_t j = 0; j < 16; ++ j ) {
+      if ( bins [ j ] != lp . bin ( j ) ) fail ( "bins of a long logic code" );
+    }
+  } catch ( std::exception & e ) {
+    std::cout << e . what () << "\n";
+    return 1;
+  }
+  return 0;
+}
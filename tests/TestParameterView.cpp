@@ -0,0 +1,97 @@
+/// TestParameterView.cpp
+/// Shaun Harker
+/// 2018-11-21
+/// MIT LICENSE
+
+#include "common.h"
+#include "DSGRN.h"
+
+int main ( int argc, char * argv [] ) {
+  try {
+    auto fail = [] ( std::string const& message ) {
+      throw std::runtime_error ( "ParameterView: " + message );
+    };
+    // Compare against the parameters returned by ParameterGraph::parameter
+    for ( std::string filename : { "networks/network2.txt", "networks/network9.txt" } ) {
+      Network network ( filename );
+      ParameterGraph pg ( network );
+      uint64_t D = network . size ();
+      std::vector<uint64_t> limits = network . domains ();
+      uint64_t step = std::max<uint64_t> ( 1, pg . size () / 500 );
+      for ( uint64_t pi = 0; pi < pg . size (); pi += step ) {
+        Parameter p = pg . parameter ( pi );
+        ParameterView view ( pg, pi );
+        std::string where = " at parameter " + std::to_string ( pi );
+        if ( view . index () != pi ) fail ( "index differs" + where );
+        if ( view . parameter () . stringify () != p . stringify () ) fail ( "parameter differs" + where );
+        if ( view . labelling () != p . labelling () ) fail ( "labelling differs" + where );
+        for ( uint64_t d = 0; d < D; ++ d ) {
+          for ( uint64_t t = 0; t < network . outputs ( d ) . size (); ++ t ) {
+            if ( view . regulator ( d, t ) != p . regulator ( d, t ) ) fail ( "regulator differs" + where );
+          }
+        }
+        Domain dom ( limits );
+        while ( dom . isValid () ) {
+          for ( uint64_t d = 0; d < D; ++ d ) {
+            for ( int direction : { -1, 1 } ) {
+              if ( view . absorbing ( dom, d, direction ) != p . absorbing ( dom, d, direction ) ) fail ( "absorbing differs" + where );
+            }
+          }
+          ++ dom;
+        }
+      }
+    }
+    // Relabelling a sweep of consecutive (and then scattered) indices gives
+    // the labelling of each view
+    {
+      Network network ( "networks/network9.txt" );
+      ParameterGraph pg ( network );
+      uint64_t sweep = std::min<uint64_t> ( pg . size (), 300 );
+      ParameterView previous ( pg, 0 );
+      std::vector<uint64_t> labelling = previous . labelling ();
+      for ( uint64_t pi = 1; pi < sweep; ++ pi ) {
+        ParameterView view ( pg, ( pi % 2 ) ? pi : pg . size () - pi );
+        view . relabel ( labelling, previous );
+        if ( labelling != view . labelling () ) fail ( "relabel differs at parameter " + std::to_string ( view . index () ) );
+        previous = view;
+      }
+    }
+    // The tables of the views are built once, by whichever thread
+    // creates the first view of a parameter graph
+    {
+      Network network ( "networks/network9.txt" );
+      ParameterGraph pg ( network );
+      std::vector<std::vector<uint64_t>> labellings ( 4 );
+      std::vector<std::thread> threads;
+      for ( uint64_t t = 0; t < labellings . size (); ++ t ) {
+        threads . push_back ( std::thread ( [&, t] () {
+          labellings [ t ] = ParameterView ( pg, pg . size () - 1 ) . labelling ();
+        }));
+      }
+      for ( auto & thread : threads ) thread . join ();
+      std::vector<uint64_t> expected = pg . parameter ( pg . size () - 1 ) . labelling ();
+      for ( auto const& labelling : labellings ) {
+        if ( labelling != expected ) fail ( "concurrent first views differ" );
+      }
+    }
+    // Default views view the parameter of the empty network
+    ParameterView empty;
+    if ( empty . network () . size () != 0 || empty . labelling () . size () != 1 ) fail ( "default view failed" );
+    Network network ( "networks/network2.txt" );
+    ParameterGraph pg ( network );
+    ParameterView view;
+    view . assign ( pg, 57 );
+    std::cout << view << "\n";
+    bool caught = false;
+    try {
+      ParameterView ( pg, pg . size () );
+    } catch ( std::exception & e ) {
+      caught = true;
+    }
+    if ( not caught ) fail ( "index out of bounds not detected" );
+  } catch ( std::exception & e ) {
+    std::cout << e . what () << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,59 @@
+/// TestPatternBuilder.cpp
+/// Shaun Harker
+/// 2018-11-05
+/// MIT LICENSE
+
+#include "common.h"
+#include "DSGRN.h"
+
+int main ( int argc, char * argv [] ) {
+  try {
+    auto fail = []( std::string const& s) { throw std::logic_error ( s ); };
+    PatternBuilder default_builder;
+    // X0 peaks at t=2 and bottoms out at t=6; X1 peaks at t=4.
+    // The small wiggle of X1 at t=1 is below the noise threshold.
+    double X[9][2] = { {0.0, 0.0}, {1.0, 0.05}, {2.0, 0.0}, {1.0, 1.0}, {0.0, 2.0},
+                       {-1.0, 1.0}, {-2.0, 0.0}, {-1.0, -1.0}, {0.0, -2.0} };
+    PatternBuilder builder ( 2, 0.1 );
+    for ( int t = 0; t < 9; ++ t ) builder . push ( t, X[t], 1 );
+    if ( builder . size () != 3 ) fail ( "PatternBuilder::size failed" );
+    Pattern pattern = builder . pattern ();
+    std::cout << pattern . stringify () << "\n";
+    if ( pattern . dimension () != 2 ) fail ( "PatternBuilder::pattern dimension failed" );
+    // X0 increasing after its minimum, X1 decreasing after its maximum
+    if ( pattern . label () != 6 ) fail ( "PatternBuilder::pattern label failed" );
+    if ( pattern . event ( 0 ) != 0 ) fail ( "PatternBuilder::pattern event 0 failed" );
+    if ( pattern . event ( 1 ) != 1 ) fail ( "PatternBuilder::pattern event 1 failed" );
+    if ( pattern . event ( 2 ) != 0 ) fail ( "PatternBuilder::pattern event 2 failed" );
+    Poset poset = pattern . poset ();
+    if ( not poset . compare ( 0, 1 ) ) fail ( "PatternBuilder::pattern order (0,1) failed" );
+    if ( not poset . compare ( 1, 2 ) ) fail ( "PatternBuilder::pattern order (1,2) failed" );
+    // With a coarse threshold the intervals of the X0 max and the X1 max overlap
+    PatternBuilder coarse ( 2, 1.5 );
+    for ( int t = 0; t < 9; ++ t ) coarse . push ( t, X[t], 1 );
+    Poset coarse_poset = coarse . pattern () . poset ();
+    if ( coarse_poset . size () != 3 ) fail ( "PatternBuilder coarse size failed" );
+    if ( coarse_poset . compare ( 0, 1 ) || coarse_poset . compare ( 1, 0 ) ) {
+      fail ( "PatternBuilder coarse order failed" );
+    }
+    if ( not coarse_poset . compare ( 0, 2 ) ) fail ( "PatternBuilder coarse chain failed" );
+    // X0 ramps up to a maximum at t=1000 and back down, so its maximum
+    // occupies [950,1050]; X1 spikes once. Only the spike at t=940 is
+    // ordered before the maximum of X0.
+    for ( int spike : { 940, 960 } ) {
+      PatternBuilder ramp ( 2, 0.5 );
+      for ( int t = 0; t <= 2000; ++ t ) {
+        double x[2] = { 0.01 * ( t <= 1000 ? t : 2000 - t ), t == spike ? 5.0 : 0.0 };
+        ramp . push ( t, x, 1 );
+      }
+      Pattern ramp_pattern = ramp . pattern ();
+      if ( ramp . size () != 2 ) fail ( "PatternBuilder ramp events failed" );
+      bool ordered = ramp_pattern . poset () . compare ( 0, 1 ) || ramp_pattern . poset () . compare ( 1, 0 );
+      if ( ordered != ( spike == 940 ) ) fail ( "PatternBuilder ramp order failed" );
+    }
+  } catch ( std::exception & e ) {
+    std::cout << e . what () << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,51 @@
+/// TestRegistry.cpp
+/// Shaun Harker
+/// 2018-11-19
+/// MIT LICENSE
+
+#include "common.h"
+#include "DSGRN.h"
+
+int main ( int argc, char * argv [] ) {
+  try {
+    auto fail = [] ( std::string const& message ) {
+      throw std::runtime_error ( "Registry: " + message );
+    };
+    Registry r;
+    // Specifications differing only in layout share an entry
+    if ( Registry::normalize ( "X : (X)(~Y)\r\n\n  Y :  X \n" ) != "X : (X)(~Y)\nY : X" ) fail ( "normalize" );
+    Network a = r . network ( "X : (X)(~Y)\nY : X\n" );
+    Network b = r . network ( "\"X :  (X)(~Y)\"\n\"Y : X\"" );
+    if ( r . size () != 1 || r . hits () != 1 || r . misses () != 1 ) fail ( "network lookup" );
+    if ( a . specification () != b . specification () ) fail ( "network not shared" );
+    // Parameter graphs agree with freshly built ones
+    ParameterGraph pg = r . parametergraph ( b );
+    ParameterGraph pg2 = r . parametergraph ( "X : (X)(~Y)\nY : X" );
+    if ( r . hits () != 3 || r . misses () != 2 ) fail ( "parametergraph lookup" );
+    ParameterGraph fresh ( a );
+    if ( pg . size () != fresh . size () || pg2 . size () != fresh . size () ) fail ( "parametergraph size" );
+    for ( uint64_t i = 0; i < fresh . size (); ++ i ) {
+      if ( pg2 . parameter ( i ) . stringify () != fresh . parameter ( i ) . stringify () ) fail ( "parametergraph" );
+    }
+    // Networks given by filename are keyed by contents
+    Network c = r . network ( "networks/network2.txt" );
+    Network d = r . network ( c . specification () );
+    if ( r . size () != 2 || r . hits () != 4 ) fail ( "filename lookup" );
+    // Least recently used entries are evicted
+    r . network ( "X : (X)(~Y)\nY : X" );
+    r . set_capacity ( 1 );
+    if ( r . size () != 1 || r . evictions () != 1 ) fail ( "eviction" );
+    r . network ( c . specification () );
+    if ( r . misses () != 4 ) fail ( "evicted entry was kept" );
+    r . network ( "X : (X)(~Y)\nY : X" );
+    if ( r . misses () != 5 || r . size () != 1 || r . evictions () != 3 ) fail ( "eviction order" );
+    std::cout << r << "\n";
+    r . clear ();
+    if ( r . size () != 0 || r . hits () != 0 ) fail ( "clear" );
+    std::cout << *registry () << "\n";
+  } catch ( std::exception & e ) {
+    std::cout << e . what () << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,156 @@
+/// TestSingleGeneQuery.cpp
+/// Shaun Harker
+/// 2018-11-08
+/// MIT LICENSE
+
+#include "common.h"
+#include "DSGRN.h"
+
+int main ( int argc, char * argv [] ) {
+  try {
+    auto fail = [] ( std::string const& message ) {
+      throw std::runtime_error ( "ComputeSingleGeneQuery: " + message );
+    };
+    Network network;
+    network . assign ( "X : X + Y \n"
+                       "Y : ~X    \n" );
+    ParameterGraph pg ( network );
+    ComputeSingleGeneQuery query ( network, "X" );
+    uint64_t const n = query . number_of_gene_parameters ();
+    uint64_t const R = query . number_of_reduced_parameters ();
+    auto edges = pg . factorgraph_edges ( network . index ( "X" ) );
+    std::vector<std::vector<uint64_t>> children ( n );
+    for ( auto const& e : edges ) children [ e . first ] . push_back ( e . second );
+    // The pattern graph of the hysteresis query as it was matched by the
+    // alignment graph search before the query was compiled to a regex
+    std::string const pattern_labels = "QqBpP";
+    std::vector<std::vector<uint64_t>> pattern_children = {
+      {0, 1, 2}, {1, 0, 2}, {2, 3, 4}, {3, 4}, {4, 3} };
+    std::mt19937_64 rng ( 5 );
+    // Signature of parameter index pi is pi itself, so the labels and flags
+    // are given per parameter index
+    std::vector<uint64_t> signatures ( pg . size () );
+    for ( uint64_t pi = 0; pi < pg . size (); ++ pi ) signatures [ pi ] = pi;
+    uint64_t num_hysteresis = 0;
+    for ( int trial = 0; trial < 200; ++ trial ) {
+      // Favor Q and q at low gene parameter indices and P and p at high ones
+      std::string labels ( pg . size (), 'O' );
+      for ( uint64_t rpi = 0; rpi < R; ++ rpi ) {
+        for ( uint64_t gpi = 0; gpi < n; ++ gpi ) {
+          std::string choices = ( 3 * gpi < n ) ? "QQqBO" : ( ( 3 * gpi < 2 * n ) ? "BBqpO" : "PPpBO" );
+          labels [ query . full_parameter_index ( rpi, gpi ) ] = choices [ rng () % choices . size () ];
+        }
+      }
+      auto result = query . matches ( "Q(Q|q)*B+(p|P)*P", labels, signatures, 4 );
+      std::set<uint64_t> matched;
+      for ( auto const& match : result ) matched . insert ( match . first );
+      for ( uint64_t rpi = 0; rpi < R; ++ rpi ) {
+        // Reachability of (n-1, P) from (0, Q) in the alignment graph
+        auto label = [&] ( uint64_t gpi ) { return labels [ query . full_parameter_index ( rpi, gpi ) ]; };
+        std::set<std::pair<uint64_t,uint64_t>> visited;
+        std::vector<std::pair<uint64_t,uint64_t>> stack;
+        if ( label ( 0 ) == 'Q' ) {
+          visited . insert ( {0, 0} );
+          stack . push_back ( {0, 0} );
+        }
+        while ( not stack . empty () ) {
+          auto node = stack . back ();
+          stack . pop_back ();
+          for ( uint64_t u : children [ node . first ] ) {
+            for ( uint64_t v : pattern_children [ node . second ] ) {
+              if ( label ( u ) != pattern_labels [ v ] ) continue;
+              if ( visited . insert ( {u, v} ) . second ) stack . push_back ( {u, v} );
+            }
+          }
+        }
+        bool expected = visited . count ( {n - 1, 4} ) > 0;
+        if ( expected != ( matched . count ( rpi ) > 0 ) ) {
+          fail ( "hysteresis differs from alignment graph search at reduced parameter " + std::to_string ( rpi ) );
+        }
+        if ( expected ) ++ num_hysteresis;
+      }
+      // Inducibility against its definition
+      std::vector<uint8_t> flags ( pg . size () );
+      for ( auto & f : flags ) f = rng () % 8;
+      auto bits = query . inducibility ( flags . data (), flags . size (), signatures . data (), signatures . size (), 3 );
+      if ( bits . size () != R ) fail ( "inducibility size failed" );
+      for ( uint64_t rpi = 0; rpi < R; ++ rpi ) {
+        auto flag = [&] ( uint64_t gpi ) { return flags [ query . full_parameter_index ( rpi, gpi ) ]; };
+        uint8_t expected = 0;
+        if ( flag ( 0 ) & 1 ) expected |= 1;
+        if ( flag ( n - 1 ) & 2 ) expected |= 2;
+        for ( uint64_t gpi = 1; gpi + 1 < n; ++ gpi ) if ( flag ( gpi ) & 4 ) expected |= 4;
+        if ( bits [ rpi ] != expected ) {
+          fail ( "inducibility differs from definition at reduced parameter " + std::to_string ( rpi ) );
+        }
+      }
+    }
+    if ( num_hysteresis == 0 ) fail ( "no hysteresis was generated" );
+    // Path counts of "matches" against enumerating the paths of the
+    // factor graph from gene parameter 0 to the leaf
+    DFA dfa = CompileRegexToDFA ( "(a|b)*a(a|b)" );
+    for ( int trial = 0; trial < 20; ++ trial ) {
+      std::string labels ( pg . size (), 'a' );
+      for ( auto & c : labels ) c = "ab"[rng () % 2];
+      auto result = query . matches ( dfa, labels . data (), labels . size (), signatures . data (), signatures . size (), 2 );
+      std::map<uint64_t, uint64_t> counts ( result . begin (), result . end () );
+      for ( uint64_t rpi = 0; rpi < R; ++ rpi ) {
+        uint64_t expected = 0;
+        std::function<void(uint64_t, std::string &)> search = [&] ( uint64_t u, std::string & word ) {
+          word . push_back ( labels [ query . full_parameter_index ( rpi, u ) ] );
+          if ( u == n - 1 && dfa . accepts ( word ) ) ++ expected;
+          for ( uint64_t v : children [ u ] ) search ( v, word );
+          word . pop_back ();
+        };
+        std::string word;
+        search ( 0, word );
+        uint64_t count = counts . count ( rpi ) ? counts [ rpi ] : 0;
+        if ( count != expected ) fail ( "matches path count differs at reduced parameter " + std::to_string ( rpi ) );
+      }
+    }
+    // Bad input is rejected, also when detected by a worker thread
+    bool caught = false;
+    try {
+      query . matches ( "a", "ab", std::vector<uint64_t> ( pg . size () - 1, 0 ) );
+    } catch ( std::invalid_argument & e ) {
+      caught = true;
+    }
+    if ( not caught ) fail ( "signature count mismatch not detected" );
+    // Against NFA::intersects on the graphs returned by operator (), with
+    // enough reduced parameters to run on several threads
+    Network network9 ( "networks/network9.txt" );
+    ParameterGraph pg9 ( network9 );
+    std::string labels9 ( pg9 . size (), 'O' );
+    for ( auto & c : labels9 ) c = "QqBpPO"[rng () % 6];
+    std::vector<uint64_t> signatures9 ( pg9 . size () );
+    for ( uint64_t pi = 0; pi < pg9 . size (); ++ pi ) signatures9 [ pi ] = pi;
+    ComputeSingleGeneQuery query9 ( network9, "X1", [&] ( uint64_t pi ) { return labels9 [ pi ]; } );
+    std::string const regex = "(Q|q|O)*B+(p|P|O)*";
+    auto serial = query9 . matches ( regex, labels9, signatures9, 1 );
+    auto parallel = query9 . matches ( regex, labels9, signatures9, 8 );
+    if ( serial != parallel ) fail ( "matches differs between 1 and 8 threads" );
+    NFA regex_nfa = CompileRegexToNFA ( regex );
+    std::set<uint64_t> matched9;
+    for ( auto const& match : parallel ) matched9 . insert ( match . first );
+    for ( uint64_t rpi = 0; rpi < query9 . number_of_reduced_parameters (); ++ rpi ) {
+      if ( NFA::intersects ( regex_nfa, query9 ( rpi ) ) != ( matched9 . count ( rpi ) > 0 ) ) {
+        fail ( "matches differs from NFA::intersects at reduced parameter " + std::to_string ( rpi ) );
+      }
+    }
+    if ( matched9 . empty () || matched9 . size () == query9 . number_of_reduced_parameters () ) {
+      fail ( "matches on network9 is trivial" );
+    }
+    labels9 . resize ( 3 );
+    caught = false;
+    try {
+      query9 . matches ( regex, labels9, signatures9, 8 );
+    } catch ( std::invalid_argument & e ) {
+      caught = true;
+    }
+    if ( not caught ) fail ( "missing label not detected by worker threads" );
+  } catch ( std::exception & e ) {
+    std::cout << e . what () << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,101 @@
+/// TestThreadSafety.cpp
+/// Shaun Harker
+/// 2018-11-18
+/// MIT LICENSE
+
+#include "common.h"
+#include "DSGRN.h"
+
+#include <thread>
+#include <atomic>
+
+int main ( int argc, char * argv [] ) {
+  try {
+    std::string filename;
+    if ( argc < 2 ) filename = "networks/network9.txt";
+    else filename = argv[1];
+    Network network ( filename );
+    ParameterGraph pg ( network );
+    uint64_t N = std::min ( pg . size (), (uint64_t) 256 );
+    uint64_t T = 8;
+
+    // Serial results
+    std::vector<std::string> parameters ( N );
+    std::vector<std::vector<uint64_t>> labellings ( N );
+    std::vector<std::string> morsegraphs ( N );
+    std::vector<uint64_t> wallgraphs ( N );
+    for ( uint64_t i = 0; i < N; ++ i ) {
+      Parameter p = pg . parameter ( i );
+      parameters [ i ] = p . stringify ();
+      labellings [ i ] = p . labelling ();
+      DomainGraph dg ( p );
+      morsegraphs [ i ] = MorseGraph ( dg, MorseDecomposition ( dg . digraph () ) ) . stringify ();
+      wallgraphs [ i ] = WallGraph ( p ) . digraph () . size ();
+    }
+    std::string path = configuration () -> get_path ();
+
+    // Finalized automata are read by all threads
+    std::string const regex = "Q(Q|q)*B+(p|P)*P";
+    NFA nfa = CompileRegexToNFA ( regex );
+    DFA dfa = CompileRegexToDFA ( regex );
+    std::mt19937_64 rng ( 7 );
+    std::vector<NFA> graphs ( N );
+    std::vector<bool> intersects ( N );
+    std::vector<uint64_t> paths ( N );
+    for ( uint64_t i = 0; i < N; ++ i ) {
+      NFA & graph = graphs [ i ];
+      uint64_t V = 2 + rng () % 6;
+      for ( uint64_t v = 0; v < V; ++ v ) graph . add_vertex ();
+      for ( uint64_t e = 0; e < 2 * V; ++ e ) graph . add_edge ( rng () % V, rng () % V, "QqBpP"[rng () % 5] );
+      graph . set_initial ( 0 );
+      graph . set_final ( V - 1 );
+      graph . finalize ();
+      intersects [ i ] = NFA::intersects ( nfa, graph );
+      paths [ i ] = graph . count_paths ();
+      if ( dfa . accepts ( graph ) != intersects [ i ] ) throw std::runtime_error ( "DFA and NFA disagree" );
+    }
+
+    // The same computations from several threads sharing the network,
+    // parameter graph, sampler, automata and global configuration
+    ParameterSampler sampler ( network );
+    std::atomic<uint64_t> errors ( 0 );
+    std::vector<std::thread> threads;
+    for ( uint64_t t = 0; t < T; ++ t ) {
+      threads . emplace_back ( [&, t] () {
+        try {
+          for ( uint64_t i = 0; i < N; ++ i ) {
+            uint64_t j = ( i + t * N / T ) % N;
+            Parameter p = pg . parameter ( j );
+            if ( p . stringify () != parameters [ j ] ) ++ errors;
+            if ( pg . index ( p ) != j ) ++ errors;
+            if ( p . labelling () != labellings [ j ] ) ++ errors;
+            if ( p . cached_labelling () != labellings [ j ] ) ++ errors;
+            DomainGraph dg ( p );
+            MorseDecomposition md ( dg . digraph () );
+            if ( MorseGraph ( dg, md ) . stringify () != morsegraphs [ j ] ) ++ errors;
+            if ( WallGraph ( p ) . digraph () . size () != wallgraphs [ j ] ) ++ errors;
+            if ( configuration () -> get_path () != path ) ++ errors;
+            if ( NFA::intersects ( nfa, graphs [ j ] ) != intersects [ j ] ) ++ errors;
+            if ( dfa . accepts ( graphs [ j ] ) != intersects [ j ] ) ++ errors;
+            if ( graphs [ j ] . count_paths () != paths [ j ] ) ++ errors;
+            if ( i % 32 == 0 ) {
+              if ( sampler . sample ( p, 4 ) . size () != 4 ) ++ errors;
+            }
+          }
+        } catch ( std::exception & e ) {
+          std::cout << e . what () << "\n";
+          ++ errors;
+        }
+      });
+    }
+    for ( auto & thread : threads ) thread . join ();
+    if ( errors != 0 ) {
+      throw std::runtime_error ( "Thread safety: " + std::to_string ( errors ) + " mismatches with serial results" );
+    }
+    std::cout << "Checked " << N << " parameters on " << T << " threads\n";
+  } catch ( std::exception & e ) {
+    std::cout << e . what () << "\n";
+    return 1;
+  }
+  return 0;
+}
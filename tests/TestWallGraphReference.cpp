@@ -0,0 +1,172 @@
+/// TestWallGraphReference.cpp
+/// Shaun Harker
+/// 2018-11-23
+/// MIT LICENSE
+
+#include "common.h"
+#include "DSGRN.h"
+
+// Compare WallGraph, which is built from the labelling in one pass, with
+// the wall graph built wall by wall from Domain, Wall and
+// Parameter::absorbing as it was originally defined
+
+struct ReferenceWallGraph {
+  Digraph digraph;
+  std::vector<uint64_t> vertex_to_dimension;
+};
+
+ReferenceWallGraph
+reference_wallgraph ( Parameter const& parameter ) {
+  ReferenceWallGraph result;
+  std::unordered_map<uint64_t, uint64_t> wall_index_to_vertex;
+  int D = parameter . network () . size ();
+  std::vector<uint64_t> limits = parameter . network () . domains ();
+  // Make wall indices
+  for ( Domain dom ( limits ); dom . isValid (); ++ dom ) {
+    for ( int d = 0; d < D; ++ d ) {
+      if ( not dom . isMin ( d ) ) {
+        Wall wall ( dom, d, -1 );
+        wall_index_to_vertex [ wall . index () ] = result . digraph . add_vertex ();
+        result . vertex_to_dimension . push_back ( d );
+      }
+    }
+  }
+  // Determine dynamics
+  for ( Domain dom ( limits ); dom . isValid (); ++ dom ) {
+    std::vector<Wall> entrance;
+    std::vector<Wall> absorbing;
+    for ( int d = 0; d < D; ++ d ) {
+      if ( not dom . isMin ( d ) ) {
+        Wall wall ( dom, d, -1 );
+        if ( parameter . absorbing ( dom, d, -1 ) ) absorbing . push_back ( wall ); else entrance . push_back ( wall );
+      }
+      if ( not dom . isMax ( d ) ) {
+        Wall wall ( dom, d, 1 );
+        if ( parameter . absorbing ( dom, d, 1 ) ) absorbing . push_back ( wall ); else entrance . push_back ( wall );
+      }
+    }
+    for ( Wall const& x : entrance ) {
+      for ( Wall const& y : absorbing ) {
+        result . digraph . add_edge ( wall_index_to_vertex [ x . index () ], wall_index_to_vertex [ y . index () ] );
+      }
+    }
+    if ( absorbing . empty () ) {
+      uint64_t attract = result . digraph . add_vertex ();
+      result . digraph . add_edge ( attract, attract );
+      result . vertex_to_dimension . push_back ( D );
+      for ( int d = 0; d < D; ++ d ) {
+        if ( dom [ d ] > 0 ) ++ result . vertex_to_dimension [ attract ];
+      }
+      for ( Wall const& x : entrance ) result . digraph . add_edge ( wall_index_to_vertex [ x . index () ], attract );
+    }
+  }
+  result . digraph . finalize ();
+  return result;
+}
+
+/// reference_annotate
+///   The annotation WallGraph::annotate gives the vertices of the
+///   reference wall graph
+std::string
+reference_annotate ( Network const& network, ReferenceWallGraph const& reference,
+                     std::vector<uint64_t> const& vertices ) {
+  uint64_t D = network . size ();
+  std::set<uint64_t> signature;
+  for ( uint64_t v : vertices ) {
+    uint64_t d = reference . vertex_to_dimension [ v ];
+    if ( d < D ) signature . insert ( d );
+  }
+  std::stringstream ss;
+  if ( signature . empty () ) {
+    std::vector<uint64_t> limits = network . domains ();
+    std::vector<uint64_t> indices = vertices;
+    ss << "FP { ";
+    for ( uint64_t d = 0; d < D; ++ d ) {
+      uint64_t min_pos = limits [ d ];
+      for ( uint64_t & v : indices ) {
+        min_pos = std::min ( min_pos, v % limits [ d ] );
+        v /= limits [ d ];
+      }
+      if ( d > 0 ) ss << ", ";
+      ss << min_pos;
+    }
+    ss << " }";
+  } else if ( signature . size () == D ) {
+    ss << "FC";
+  } else {
+    ss << "XC {";
+    bool first_term = true;
+    for ( uint64_t d : signature ) {
+      if ( first_term ) first_term = false; else ss << ", ";
+      ss << network . name ( d );
+    }
+    ss << "}";
+  }
+  Annotation a;
+  a . append ( ss . str () );
+  return a . stringify ();
+}
+
+int main ( int argc, char * argv [] ) {
+  try {
+    auto fail = [] ( std::string const& message ) {
+      throw std::runtime_error ( "WallGraph: " + message );
+    };
+    // Networks of one to four nodes; "Y : X" and "Z : X" have no outputs,
+    // so every domain lies on the boundary in their dimensions
+    std::vector<Network> networks;
+    networks . push_back ( Network ( "networks/network2.txt" ) );
+    networks . push_back ( Network ( "networks/network9.txt" ) );
+    networks . push_back ( Network ( "X : ~X \n" ) );
+    networks . push_back ( Network ( "X : X + ~Y \n Y : X \n" ) );
+    networks . push_back ( Network ( "X : (X)(~Y) \n Y : X + Z \n Z : X \n" ) );
+    networks . push_back ( Network ( "X : X + W \n Y : X + ~Y \n Z : Y \n W : Z + ~W \n" ) );
+    std::mt19937_64 rng ( 37 );
+    uint64_t num_checked = 0;
+    for ( Network const& network : networks ) {
+      ParameterGraph pg ( network );
+      std::vector<uint64_t> indices;
+      if ( pg . size () <= 200 ) {
+        for ( uint64_t i = 0; i < pg . size (); ++ i ) indices . push_back ( i );
+      } else {
+        for ( int k = 0; k < 40; ++ k ) indices . push_back ( rng () % pg . size () );
+      }
+      for ( uint64_t pi : indices ) {
+        std::string where = " for parameter " + std::to_string ( pi ) + " of " + network . specification ();
+        Parameter parameter = pg . parameter ( pi );
+        ReferenceWallGraph reference = reference_wallgraph ( parameter );
+        WallGraph wg ( parameter );
+        WallGraph view_wg ( ParameterView ( pg, pi ) );
+        for ( WallGraph const& graph : { wg, view_wg } ) {
+          Digraph digraph = graph . digraph ();
+          if ( digraph . size () != reference . digraph . size () ) fail ( "vertex count differs" + where );
+          for ( uint64_t v = 0; v < digraph . size (); ++ v ) {
+            if ( digraph . adjacencies ( v ) != reference . digraph . adjacencies ( v ) ) {
+              fail ( "edges of vertex " + std::to_string ( v ) + " differ" + where );
+            }
+            std::vector<uint64_t> single { v };
+            if ( graph . annotate ( Component ( single . begin (), single . end () ) ) . stringify () !=
+                 reference_annotate ( network, reference, single ) ) {
+              fail ( "annotation of vertex " + std::to_string ( v ) + " differs" + where );
+            }
+          }
+          // Annotations of the Morse sets
+          MorseDecomposition md ( reference . digraph );
+          for ( uint64_t s = 0; s < md . recurrent () . size (); ++ s ) {
+            std::vector<uint64_t> vertices = md . morseset ( s );
+            if ( graph . annotate ( Component ( vertices . begin (), vertices . end () ) ) . stringify () !=
+                 reference_annotate ( network, reference, vertices ) ) {
+              fail ( "annotation of Morse set " + std::to_string ( s ) + " differs" + where );
+            }
+          }
+        }
+        ++ num_checked;
+      }
+    }
+    std::cout << "Checked " << num_checked << " wall graphs\n";
+  } catch ( std::exception & e ) {
+    std::cout << e . what () << "\n";
+    return 1;
+  }
+  return 0;
+}
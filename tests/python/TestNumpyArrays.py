@@ -0,0 +1,41 @@
+# TestNumpyArrays.py
+# MIT LICENSE 2018
+# Shaun Harker
+
+# Arrays returned by the bindings must stay valid after the object they
+# came from is edited or garbage collected
+
+import gc
+import DSGRN
+
+def test_adjacencies_array():
+  g = DSGRN.Digraph()
+  for v in range(3):
+    g.add_vertex()
+  g.add_edge(0, 1)
+  g.add_edge(0, 2)
+  a = g.adjacencies_array(0)
+  # Growing the adjacency list of vertex 0 reallocates it
+  for k in range(1000):
+    g.add_edge(0, k % 3)
+  assert list(a) == [1, 2]
+  b = g.adjacencies_array(1)
+  del g
+  gc.collect()
+  assert list(b) == []
+  assert list(a) == [1, 2]
+
+def test_components_arrays():
+  g = DSGRN.Digraph([[1], [0], [2], []])
+  c = DSGRN.StrongComponents(g)
+  vertices = c.vertices_array()
+  offsets = c.offsets_array()
+  expected = (list(vertices), list(offsets))
+  del c, g
+  gc.collect()
+  assert (list(vertices), list(offsets)) == expected
+  assert sorted(vertices) == [0, 1, 2, 3]
+
+if __name__ == "__main__":
+  test_adjacencies_array()
+  test_components_arrays()